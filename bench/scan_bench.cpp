@@ -0,0 +1,105 @@
+#include <webserv/utils/Scan.hpp> // for Kernel, getKernels
+
+#include <chrono>      // for steady_clock, duration
+#include <cstddef>     // for size_t
+#include <iomanip>     // for setw, setprecision
+#include <iostream>    // for cout
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+/**
+ * Throughput of every scan kernel the CPU supports on the searches the parsers make: the end of a request head, a
+ * multipart boundary in an upload, and CR/LF in CGI output. Each input has its only match at the very end, so the
+ * whole buffer is scanned.
+ */
+
+struct Input
+{
+    std::string name;
+    std::string data;
+    std::string needle; // empty for findAny
+};
+
+static constexpr size_t ROUNDS_BYTES = size_t{1} << 30;
+
+static std::string filler(size_t size)
+{
+    std::string data;
+    data.reserve(size);
+    const std::string_view text = "Accept-Language: en-US,en;q=0.9 text/html; charset=utf-8 ";
+    while (data.size() < size)
+    {
+        data += text.substr(0, size - data.size());
+    }
+    return data;
+}
+
+static std::vector<Input> makeInputs()
+{
+    std::vector<Input> inputs;
+    for (size_t size : {size_t{512}, size_t{8192}, size_t{1} << 20})
+    {
+        // Header lines put a CR/LF every few dozen bytes, every one a candidate for the first byte
+        std::string head;
+        while (head.size() < size)
+        {
+            head += "X-Header: " + filler(20) + "\r\n";
+        }
+        head.resize(size - 4);
+        head += "\r\n\r\n";
+        inputs.push_back({.name = "head end " + std::to_string(size), .data = head, .needle = "\r\n\r\n"});
+
+        std::string body = filler(size);
+        const std::string boundary = "\r\n------WebKitFormBoundary7MA4YWxkTrZu0gW";
+        body.replace(size - boundary.size(), boundary.size(), boundary);
+        inputs.push_back({.name = "boundary " + std::to_string(size), .data = body, .needle = boundary});
+
+        std::string output = filler(size);
+        output.back() = '\n';
+        inputs.push_back({.name = "CR/LF " + std::to_string(size), .data = output, .needle = ""});
+    }
+    return inputs;
+}
+
+static double measure(const scan::Kernel &kernel, const Input &input)
+{
+    size_t rounds = ROUNDS_BYTES / input.data.size();
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        if (input.needle.empty())
+        {
+            checksum += kernel.findAny(input.data.data(), input.data.size(), '\r', '\n');
+        }
+        else
+        {
+            checksum += kernel.find(input.data.data(), input.data.size(), input.needle.data(), input.needle.size());
+        }
+        // Keep the compiler from hoisting the search out of the loop
+        asm volatile("" : "+r"(checksum));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(rounds * input.data.size()) / elapsed.count() / 1e9;
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(20) << "input";
+    for (const scan::Kernel &kernel : scan::getKernels())
+    {
+        std::cout << std::right << std::setw(12) << kernel.name;
+    }
+    std::cout << "   (GB/s)\n";
+    for (const Input &input : makeInputs())
+    {
+        std::cout << std::left << std::setw(20) << input.name << std::right << std::fixed << std::setprecision(2);
+        for (const scan::Kernel &kernel : scan::getKernels())
+        {
+            std::cout << std::setw(12) << measure(kernel, input);
+        }
+        std::cout << '\n';
+    }
+    return 0;
+}
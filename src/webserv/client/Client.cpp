@@ -1,6 +1,6 @@
 #include <webserv/client/Client.hpp>
 
-#include <webserv/handler/CgiHandler.hpp>    // for CgiHandler
+#include <webserv/config/AConfig.hpp>        // for AConfig
 #include <webserv/handler/ErrorHandler.hpp>  // for ErrorHandler
 #include <webserv/handler/URI.hpp>           // for URI
 #include <webserv/http/HttpConstants.hpp>    // for getStatusCodeReason, BAD_REQUEST, REQUEST_TIMEOUT
@@ -9,14 +9,16 @@
 #include <webserv/http/HttpResponse.hpp>     // for HttpResponse
 #include <webserv/http/RequestValidator.hpp> // for RequestValidator
 #include <webserv/log/Log.hpp>               // for Log, LOCATION
-#include <webserv/main.hpp>                  // for BUFFER_SIZE, CLIENT_TIMEOUT
+#include <webserv/main.hpp>                  // for BUFFER_SIZE, CLIENT_TIMEOUT, KEEPALIVE_TIMEOUT, KEEPALIVE_REQUESTS
 #include <webserv/router/Router.hpp>         // for Router
 #include <webserv/server/Server.hpp>         // for Server
 #include <webserv/socket/ASocket.hpp>        // for ASocket
 #include <webserv/socket/ClientSocket.hpp>   // for ClientSocket
 #include <webserv/socket/TimerSocket.hpp>    // for TimerSocket
 
+#include <algorithm>  // for find_if
 #include <array>      // for array
+#include <cerrno>     // for errno, EAGAIN, EWOULDBLOCK
 #include <chrono>     // for operator*, milliseconds
 #include <exception>  // for exception
 #include <functional> // for function, ref, reference_wrapper
@@ -25,78 +27,183 @@
 #include <stdexcept>  // for runtime_error
 #include <string>     // for operator+, basic_string, char_traits, to_string, string
 #include <utility>    // for move, pair
-#include <vector>     // for vector
+#include <vector>     // for vector, erase, erase_if
 
-#include <arpa/inet.h>  // for inet_ntoa
-#include <netinet/in.h> // for in_addr, sockaddr_in
-#include <stddef.h>     // for size_t
-#include <sys/socket.h> // for send, AF_INET, sockaddr
-#include <sys/types.h>  // for ssize_t
+#include <arpa/inet.h>    // for inet_ntop
+#include <netinet/in.h>   // for in_addr, sockaddr_in
+#include <stddef.h>       // for size_t
+#include <sys/sendfile.h> // for sendfile
+#include <sys/socket.h>   // for send, AF_INET, sockaddr, MSG_MORE
+#include <sys/types.h>    // for ssize_t, off_t
+#include <sys/uio.h>      // for writev, iovec
+
+/**
+ * Errors that leave the request stream in an unknown state; the connection is closed after sending them.
+ */
+static inline bool closesConnection(uint16_t statusCode)
+{
+    switch (statusCode)
+    {
+    case Http::StatusCode::BAD_REQUEST:
+    case Http::StatusCode::REQUEST_TIMEOUT:
+    case Http::StatusCode::PAYLOAD_TOO_LARGE:
+    case Http::StatusCode::URI_TOO_LONG: return true;
+    default: return false;
+    }
+}
 
 Client::Client(std::unique_ptr<ClientSocket> socket, Server &server)
     : httpRequest_(std::make_unique<HttpRequest>(this)), httpResponse_(std::make_unique<HttpResponse>()),
-      router_(std::make_unique<Router>(this)), clientSocket_(std::move(socket)), server_(std::ref(server))
+      router_(std::make_unique<Router>(this)), clientSocket_(std::move(socket)),
+      timerSocket_(
+          std::make_unique<TimerSocket>(server.getTimerWheel(), std::chrono::milliseconds(CLIENT_TIMEOUT) * 1000)),
+      server_(std::ref(server))
 {
     Log::trace(LOCATION);
-    Log::info(clientSocket_->toString() + ": connected");
-    clientSocket_->setCallback([this]() { request(); });
-    sockets_[clientSocket_->getFd()] = clientSocket_.get();
-
-    startTimer();
+    httpResponse_->onComplete([this]() { server_.ready(*this); });
+    timerSocket_->setCallback([this]() { handleTimeout(); });
+    start();
 }
 
 Client::~Client()
 {
     Log::trace(LOCATION);
-    Log::info(clientSocket_->toString() + ": disconnected");
-    for (auto it : sockets_)
+    if (isOpen())
     {
-        server_.remove(*(it.second));
+        close();
     }
 };
 
+/**
+ * Serves a new connection with a client the server kept after close(). The request, response, router and timer
+ * objects and their buffers are reused as they are.
+ */
+void Client::open(int fd, struct sockaddr address)
+{
+    Log::trace(LOCATION);
+    clientSocket_->assign(fd, address);
+    start();
+}
+
+/**
+ * Ends the connection: unregisters and closes its sockets, stops the handler and the timer and clears the request
+ * and response, leaving the client ready for open().
+ */
+void Client::close()
+{
+    Log::trace(LOCATION);
+    Log::info(clientSocket_->toString() + ": disconnected");
+    for (ASocket *socket : sockets_)
+    {
+        server_.remove(*socket);
+    }
+    sockets_.clear();
+    handler_.reset();
+    timerSocket_->cancel();
+    timerSocket_->setTimeout(std::chrono::milliseconds(CLIENT_TIMEOUT) * 1000);
+    httpRequest_->clear();
+    httpResponse_->clear();
+    writeOffset_ = 0;
+    requestCount_ = 0;
+    idle_ = false;
+    clientSocket_->release();
+}
+
+bool Client::isOpen() const noexcept
+{
+    return clientSocket_->getFd() != -1;
+}
+
 ASocket &Client::getSocket(int fd) const
 {
     if (fd == -1)
     {
         return *clientSocket_;
     }
-    if (sockets_.contains(fd))
+    auto it = std::ranges::find_if(sockets_, [fd](const ASocket *socket) { return socket->getFd() == fd; });
+    if (it != sockets_.end())
     {
-        return *sockets_.at(fd);
+        return **it;
     }
     Log::error("Socket not found for fd: " + std::to_string(fd));
     throw std::runtime_error("Socket not found for fd: " + std::to_string(fd));
 }
 
+/**
+ * Reads from the client straight into the receive buffer of the request. Level-triggered, one read per wakeup is
+ * enough. Edge-triggered, the socket is read until it is drained or Constants::IO_BUDGET bytes were taken, in which
+ * case the server calls back on its next iteration.
+ */
 void Client::request()
 {
     Log::trace(LOCATION);
-    char buffer[Constants::BUFFER_SIZE] = {}; // NOLINT(cppcoreguidelines-avoid-c-arrays)
-    ssize_t bytesRead = clientSocket_->read(
-        buffer, sizeof(buffer) - 1); // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
-    if (bytesRead < 0)
+    const bool drain = server_.isEdgeTriggered();
+    size_t received = 0;
+    while (true)
     {
-        Log::error(clientSocket_->toString() + ": read error");
-        server_.disconnect(*this);
-        return;
+        char *buffer = httpRequest_->prepareData(Constants::BUFFER_SIZE);
+        ssize_t bytesRead = clientSocket_->read(buffer, Constants::BUFFER_SIZE);
+        if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+        if (bytesRead < 0)
+        {
+            Log::error(clientSocket_->toString() + ": read error");
+            server_.disconnect(*this); // ! CRITICAL: RETURN IMMEDIATELY
+            return;
+        }
+        if (bytesRead == 0)
+        {
+            Log::info(clientSocket_->toString() + ": closed connection");
+            server_.disconnect(*this); // ! CRITICAL: RETURN IMMEDIATELY
+            return;
+        }
+        receive(static_cast<size_t>(bytesRead));
+        received += static_cast<size_t>(bytesRead);
+
+        // A short read drained the socket; data arriving later raises a new edge
+        if (!drain || static_cast<size_t>(bytesRead) < Constants::BUFFER_SIZE
+            || clientSocket_->getEvent() != ASocket::IoState::READ)
+        {
+            return;
+        }
+        if (received >= Constants::IO_BUDGET)
+        {
+            server_.defer(*clientSocket_);
+            return;
+        }
     }
-    if (bytesRead == 0)
+}
+
+/**
+ * Hands bytesRead bytes that request() placed in the receive buffer to the parser.
+ */
+void Client::receive(size_t bytesRead)
+{
+    if (idle_)
     {
-        Log::info(clientSocket_->toString() + ": closed connection");
-        server_.disconnect(*this);
-        return;
+        idle_ = false;
+        timerSocket_->setTimeout(std::chrono::milliseconds(CLIENT_TIMEOUT) * 1000);
     }
-
     resetTimer();
-    buffer[bytesRead] = '\0'; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
     if (httpRequest_->getState() == HttpRequest::State::Complete)
     {
-        Log::warning(clientSocket_->toString() + ": received data after request was already complete; ignoring");
+        // Pipelined request: queue the bytes until the current response has been sent
+        httpRequest_->receiveData(bytesRead);
+        if (httpRequest_->getBufferedSize() >= Constants::PIPELINE_BUFFER_SIZE)
+        {
+            Log::debug(clientSocket_->toString() + ": pipeline buffer full; pausing reads");
+            clientSocket_->setIOState(ASocket::IoState::NONE);
+        }
         return;
     }
-    httpRequest_->receiveData(static_cast<const char *>(buffer), static_cast<size_t>(bytesRead));
+    httpRequest_->receiveData(bytesRead);
+    processRequest();
+}
 
+void Client::processRequest()
+{
     // If parsing failed, proactively send an error response (avoid timeouts on malformed requests)
     if (httpRequest_->getState() == HttpRequest::State::ParseError)
     {
@@ -105,6 +212,7 @@ void Client::request()
         {
             ErrorHandler::createErrorResponse(400, *httpResponse_);
         }
+        httpResponse_->setKeepAlive(false);
         clientSocket_->setCallback([this]() { respond(); });
         clientSocket_->setIOState(ASocket::IoState::WRITE);
         return;
@@ -146,27 +254,30 @@ void Client::request()
 void Client::addSocket(ASocket *socket)
 {
     server_.add(*socket, this);
-    sockets_[socket->getFd()] = socket;
+    sockets_.push_back(socket);
 }
 
 void Client::removeSocket(ASocket *socket)
 {
     server_.remove(*socket);
-    sockets_.erase(socket->getFd());
+    std::erase(sockets_, socket);
 }
 
-void Client::poll()
+/**
+ * Starts sending the response once it is complete. The server calls this for clients it queued via ready().
+ */
+void Client::ready()
 {
-    auto *cgiHandler = dynamic_cast<CgiHandler *>(handler_.get());
-    if (cgiHandler != nullptr)
-    {
-        cgiHandler->wait();
-    }
     if (httpResponse_->isComplete() && clientSocket_->getEvent() != ASocket::IoState::WRITE)
     {
-        auto statusCode = httpResponse_->getStatusCode();
-        Log::info(clientSocket_->toString() + ": " + std::to_string(statusCode) + " "
-                  + Http::getStatusCodeReason(statusCode));
+        // A streamed response wakes the client up again whenever more of its body is queued
+        if (writeOffset_ == 0)
+        {
+            auto statusCode = httpResponse_->getStatusCode();
+            Log::info(clientSocket_->toString() + ": " + std::to_string(statusCode) + " "
+                      + Http::getStatusCodeReason(statusCode));
+            httpResponse_->setKeepAlive(shouldKeepAlive());
+        }
         clientSocket_->setCallback([this]() { respond(); });
         clientSocket_->setIOState(ASocket::IoState::WRITE);
     }
@@ -174,35 +285,242 @@ void Client::poll()
 
 void Client::respond()
 {
-    auto payload = httpResponse_->toBytes(writeOffset_);
-    ssize_t bytesSent = send(clientSocket_->getFd(), payload.data(), payload.size(), 0);
-    if (bytesSent < 0)
+    WriteStatus status = httpResponse_->hasBodyFile() ? writeFile() : writeBuffered();
+    if (status == WriteStatus::Failed)
     {
         Log::error(clientSocket_->toString() + ": send failed");
         server_.disconnect(*this); // ! CRITICAL: RETURN IMMEDIATELY
         return;
     }
+    if (status == WriteStatus::Pending)
+    {
+        return;
+    }
+    if (status == WriteStatus::Yielded)
+    {
+        server_.defer(*clientSocket_);
+        return;
+    }
+    if (httpResponse_->getStream() == HttpResponse::Stream::Open)
+    {
+        waitForStream();
+        return;
+    }
+    completeResponse();
+}
+
+/**
+ * Everything of a streamed body produced so far has been sent. Writing pauses until ready() is called for the next
+ * piece; meanwhile only a hang up can be reported, which ends the connection.
+ */
+void Client::waitForStream()
+{
+    writeOffset_ = httpResponse_->getHead().size();
+    clientSocket_->setCallback([this]() {
+        Log::info(clientSocket_->toString() + ": hung up during streamed response");
+        server_.disconnect(*this); // ! CRITICAL: RETURN IMMEDIATELY
+    });
+    clientSocket_->setIOState(ASocket::IoState::NONE);
+    httpResponse_->drained();
+}
+
+/**
+ * Writes the serialized head and the in-memory body with writev until everything is out, the socket would block or
+ * Constants::IO_BUDGET bytes were sent. Neither buffer is copied; writeOffset_ tracks the position across both.
+ */
+Client::WriteStatus Client::writeBuffered()
+{
+    const std::string &head = httpResponse_->getHead();
+    const std::vector<uint8_t> &body = httpResponse_->getBody();
+    const size_t total = head.size() + body.size();
+    size_t written = 0;
+    bool blocked = false;
+
+    while (writeOffset_ < total && written < Constants::IO_BUDGET)
+    {
+        std::array<struct iovec, 2> iov{};
+        int count = 0;
+        if (writeOffset_ < head.size())
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            iov[count++] = {.iov_base = const_cast<char *>(head.data() + writeOffset_),
+                            .iov_len = head.size() - writeOffset_};
+        }
+        size_t bodyOffset = writeOffset_ > head.size() ? writeOffset_ - head.size() : 0;
+        if (bodyOffset < body.size())
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            iov[count++] = {.iov_base = const_cast<uint8_t *>(body.data() + bodyOffset),
+                            .iov_len = body.size() - bodyOffset};
+        }
+        ssize_t bytesSent = writev(clientSocket_->getFd(), iov.data(), count);
+        if (bytesSent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                return WriteStatus::Failed;
+            }
+            blocked = true;
+            break;
+        }
+        writeOffset_ += static_cast<size_t>(bytesSent);
+        written += static_cast<size_t>(bytesSent);
+    }
+
+    Log::debug(clientSocket_->toString() + ": sent " + std::to_string(written) + " bytes, "
+               + std::to_string(writeOffset_) + " of " + std::to_string(total) + " total");
+    if (written > 0)
+    {
+        resetTimer();
+    }
+    if (writeOffset_ >= total)
+    {
+        return WriteStatus::Complete;
+    }
+    return blocked ? WriteStatus::Pending : WriteStatus::Yielded;
+}
+
+/**
+ * Sends the head from memory, then lets the kernel copy the body file straight to the socket. Both loops run until
+ * the socket would block or the budget is spent; the rest goes out on the next EPOLLOUT or deferred call.
+ */
+Client::WriteStatus Client::writeFile()
+{
+    const std::string &head = httpResponse_->getHead();
+    const size_t total = head.size() + httpResponse_->getBodySize();
+    size_t written = 0;
+    bool blocked = false;
+
+    while (writeOffset_ < total && written < Constants::IO_BUDGET)
+    {
+        ssize_t bytesSent = 0;
+        if (writeOffset_ < head.size())
+        {
+            bytesSent = send(clientSocket_->getFd(), head.data() + writeOffset_, head.size() - writeOffset_, MSG_MORE);
+        }
+        else
+        {
+            size_t bodySent = writeOffset_ - head.size();
+            off_t fileOffset = httpResponse_->getBodyFileOffset() + static_cast<off_t>(bodySent);
+            bytesSent
+                = sendfile(clientSocket_->getFd(), httpResponse_->getBodyFileFd(), &fileOffset, total - writeOffset_);
+            if (bytesSent == 0)
+            {
+                // The file shrank underneath us; the promised Content-Length can no longer be met
+                return WriteStatus::Failed;
+            }
+        }
+        if (bytesSent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                return WriteStatus::Failed;
+            }
+            blocked = true;
+            break;
+        }
+        writeOffset_ += static_cast<size_t>(bytesSent);
+        written += static_cast<size_t>(bytesSent);
+    }
+
+    Log::debug(clientSocket_->toString() + ": sent " + std::to_string(written) + " bytes, "
+               + std::to_string(writeOffset_) + " of " + std::to_string(total) + " total");
+    if (written > 0)
+    {
+        resetTimer();
+    }
+    if (writeOffset_ >= total)
+    {
+        return WriteStatus::Complete;
+    }
+    return blocked ? WriteStatus::Pending : WriteStatus::Yielded;
+}
+
+void Client::completeResponse()
+{
+    if (httpResponse_->isKeepAlive())
+    {
+        recycle();
+        return;
+    }
+    Log::debug(clientSocket_->toString() + ": closing connection to client");
+    server_.disconnect(*this); // ! CRITICAL: RETURN IMMEDIATELY
+}
+
+bool Client::shouldKeepAlive() const
+{
+    if (httpRequest_->getState() != HttpRequest::State::Complete || !httpRequest_->isKeepAlive()
+        || closesConnection(httpResponse_->getStatusCode())
+        || httpResponse_->getStream() == HttpResponse::Stream::Aborted)
+    {
+        return false;
+    }
+    if (HttpHeaders::NameEqual()(httpResponse_->getHeaders().get(HttpHeaders::Field::Connection), "close"))
+    {
+        return false;
+    }
+    const AConfig *config = httpRequest_->getUri().getConfig();
+    int timeout = config->get<int>("keepalive_timeout").value_or(KEEPALIVE_TIMEOUT);
+    int maxRequests = config->get<int>("keepalive_requests").value_or(KEEPALIVE_REQUESTS);
+    return timeout > 0 && maxRequests > 0 && requestCount_ + 1 < static_cast<size_t>(maxRequests);
+}
+
+/**
+ * Prepares the connection for the next request once a keep-alive response has been sent. Sockets owned by the
+ * previous handler are unregistered before the handler itself is destroyed.
+ */
+void Client::recycle()
+{
+    Log::trace(LOCATION);
+    const AConfig *config = httpRequest_->getUri().getConfig();
+    int timeout = config->get<int>("keepalive_timeout").value_or(KEEPALIVE_TIMEOUT);
 
-    Log::debug(clientSocket_->toString() + ": sent " + std::to_string(bytesSent) + " bytes out of "
-               + std::to_string(writeOffset_ + payload.size()) + "(offset: " + std::to_string(writeOffset_) + ")");
-    writeOffset_ += bytesSent;
+    std::erase_if(sockets_, [this](ASocket *socket) {
+        if (socket == clientSocket_.get())
+        {
+            return false;
+        }
+        server_.remove(*socket);
+        return true;
+    });
+    handler_.reset();
+    httpRequest_->reset();
+    httpResponse_->reset();
+    writeOffset_ = 0;
+    ++requestCount_;
 
+    idle_ = true;
+    timerSocket_->setTimeout(std::chrono::milliseconds(timeout) * 1000);
     resetTimer();
+    clientSocket_->setCallback([this]() { request(); });
+    clientSocket_->setIOState(ASocket::IoState::READ);
+    Log::debug(clientSocket_->toString() + ": keep-alive, " + std::to_string(requestCount_) + " request(s) served");
 
-    if (payload.empty())
+    if (httpRequest_->getBufferedSize() > 0)
     {
-        Log::debug(clientSocket_->toString() + ": closing connection to client");
-        server_.disconnect(*this); // ! CRITICAL: RETURN IMMEDIATELY
+        Log::debug(clientSocket_->toString() + ": parsing pipelined request");
+        idle_ = false;
+        timerSocket_->setTimeout(std::chrono::milliseconds(CLIENT_TIMEOUT) * 1000);
+        resetTimer();
+        httpRequest_->resume();
+        processRequest();
     }
 }
 
-void Client::startTimer()
+void Client::start()
 {
-    timerSocket_ = std::make_unique<TimerSocket>(std::chrono::milliseconds(CLIENT_TIMEOUT) * 1000);
-    timerSocket_->setCallback([this]() { handleTimeout(); });
+    Log::info(clientSocket_->toString() + ": connected");
+    clientSocket_->setCallback([this]() { request(); });
+    sockets_.push_back(clientSocket_.get());
     timerSocket_->activate();
-
-    addSocket(timerSocket_.get());
     Log::debug(clientSocket_->toString() + ": Timer started");
 }
 
@@ -217,15 +535,15 @@ void Client::resetTimer()
 
 void Client::handleTimeout()
 {
-    Log::info(clientSocket_->toString() + ": client timeout reached; disconnecting");
-    std::array<char, 9> buffer = {};
-    ssize_t bytesRead = timerSocket_->read(buffer.data(), buffer.size() - 1);
-    if (bytesRead <= 0)
+    if (idle_)
     {
+        Log::info(clientSocket_->toString() + ": keep-alive timeout reached; closing connection");
+        server_.disconnect(*this); // ! CRITICAL: RETURN IMMEDIATELY
         return;
     }
+    Log::info(clientSocket_->toString() + ": client timeout reached; disconnecting");
     Log::warning(clientSocket_->toString() + ": request parsing timed out;");
-    int status = httpRequest_->getBody().size() == httpRequest_->getHeaders().getContentLength()
+    int status = httpRequest_->getBodyLength() == httpRequest_->getHeaders().getContentLength()
                      ? Http::StatusCode::REQUEST_TIMEOUT
                      : Http::StatusCode::BAD_REQUEST; // Request Timeout
 
@@ -233,6 +551,7 @@ void Client::handleTimeout()
     {
         ErrorHandler::createErrorResponse(status, *httpResponse_);
     }
+    httpResponse_->setKeepAlive(false);
     clientSocket_->setCallback([this]() { respond(); });
     clientSocket_->setIOState(ASocket::IoState::WRITE);
 }
@@ -254,13 +573,22 @@ std::string Client::getClientAddress() const noexcept
     {
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
         const auto *ipv4 = reinterpret_cast<const struct sockaddr_in *>(addr);
-        const char *addr = inet_ntoa(ipv4->sin_addr);
-        return std::string(addr);
+        std::array<char, INET_ADDRSTRLEN> buffer{};
+        if (inet_ntop(AF_INET, &ipv4->sin_addr, buffer.data(), buffer.size()) == nullptr)
+        {
+            return "";
+        }
+        return std::string(buffer.data());
     }
 
     return "";
 }
 
+Server &Client::getServer() const noexcept
+{
+    return server_;
+}
+
 ClientSocket *Client::getClientSocket() const noexcept
 {
     return clientSocket_.get();
@@ -12,11 +12,13 @@
 #include <webserv/socket/ASocket.hpp>
 #include <webserv/socket/CgiSocket.hpp>
 #include <webserv/socket/ClientSocket.hpp> // for ClientSocket
+#include <webserv/utils/ArenaPtr.hpp>      // for ArenaPtr
 
 #include <cstddef>       // for size_t
+#include <cstdint>       // for uint8_t
 #include <memory>        // for unique_ptr
 #include <string>        // for string
-#include <unordered_map> // for unordered_map
+#include <vector>        // for vector
 
 class Server;
 class ClientSocket;
@@ -39,35 +41,59 @@ class Client
 
     ~Client();
 
+    void open(int fd, struct sockaddr address);
+    void close();
     void request();
     void respond();
-    void poll();
+    void ready();
+
+    [[nodiscard]] bool isOpen() const noexcept;
 
     [[nodiscard]] ASocket &getSocket(int fd = -1) const;
 
     void addSocket(ASocket *socket);
     void removeSocket(ASocket *socket);
 
+    [[nodiscard]] Server &getServer() const noexcept;
     [[nodiscard]] ClientSocket *getClientSocket() const noexcept;
     [[nodiscard]] HttpRequest &getHttpRequest() const noexcept;
     [[nodiscard]] HttpResponse &getHttpResponse() const noexcept;
     [[nodiscard]] std::string getClientAddress() const noexcept;
 
   private:
+    enum class WriteStatus : uint8_t
+    {
+        Complete,
+        Pending, // The socket would block
+        Yielded, // The budget ran out while the socket could take more
+        Failed
+    };
+
     // int statusCode_ = Http::StatusCode::OK;
     std::unique_ptr<HttpRequest> httpRequest_;
     std::unique_ptr<HttpResponse> httpResponse_;
     std::unique_ptr<Router> router_;
     std::unique_ptr<ClientSocket> clientSocket_;
     std::unique_ptr<TimerSocket> timerSocket_;
-    std::unique_ptr<AHandler> handler_ = nullptr;
-    std::unordered_map<int, ASocket *> sockets_;
+    // Placed in the arena of httpRequest_, so it is destroyed before the request is reset
+    ArenaPtr<AHandler> handler_ = nullptr;
+    std::vector<ASocket *> sockets_;
 
     Server &server_;
-    long writeOffset_ = 0;
-    void startTimer();
+    size_t writeOffset_ = 0;
+    size_t requestCount_ = 0;
+    bool idle_ = false;
+    void start();
     void resetTimer();
     void handleTimeout();
+    void recycle();
+    [[nodiscard]] WriteStatus writeBuffered();
+    [[nodiscard]] WriteStatus writeFile();
+    void waitForStream();
+    void completeResponse();
+    void receive(size_t bytesRead);
+    void processRequest();
+    [[nodiscard]] bool shouldKeepAlive() const;
     // void writeToCgi();
     // void readFromCgi();
 };
\ No newline at end of file
@@ -57,7 +57,7 @@ void AConfig::addDirective(const std::string &line)
     }
 }
 
-const ADirective *AConfig::getDirective(const std::string &name) const
+const ADirective *AConfig::getDirective(std::string_view name) const
 {
     for (const auto &directive : directives_)
     {
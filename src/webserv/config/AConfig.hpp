@@ -3,10 +3,11 @@
 #include <webserv/config/directive/ADirective.hpp> // for ADirective
 #include <webserv/config/directive/DirectiveValue.hpp>
 
-#include <memory>   // for unique_ptr
-#include <optional> // for nullopt, optional
-#include <string>   // for string, basic_string
-#include <vector>   // for vector
+#include <memory>      // for unique_ptr
+#include <optional>    // for nullopt, optional
+#include <string>      // for string, basic_string
+#include <string_view> // for string_view
+#include <vector>      // for vector
 
 class AConfig
 {
@@ -29,10 +30,10 @@ class AConfig
     [[nodiscard]] bool has(const std::string &name) const;
     [[nodiscard]] bool owns(const std::string &name) const;
 
-    [[nodiscard]] const ADirective *getDirective(const std::string &name) const;
+    [[nodiscard]] const ADirective *getDirective(std::string_view name) const;
     [[nodiscard]] std::vector<const ADirective *> getDirectives() const;
 
-    template <typename T> std::optional<T> get(const std::string &name) const
+    template <typename T> std::optional<T> get(std::string_view name) const
     {
         const auto *directive = getDirective(name);
         if (!directive)
@@ -11,7 +11,7 @@ DirectiveValue ADirective::getValue() const
     return {getValueType()};
 }
 
-std::string ADirective::getName() const
+const std::string &ADirective::getName() const noexcept
 {
     return name_;
 }
@@ -24,7 +24,7 @@ class ADirective
 
     [[nodiscard]] virtual DirectiveValueType getValueType() const = 0;
     [[nodiscard]] DirectiveValue getValue() const;
-    [[nodiscard]] std::string getName() const;
+    [[nodiscard]] const std::string &getName() const noexcept;
 
   protected:
     std::string name_; // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
@@ -20,7 +20,7 @@ class DirectiveFactory
         std::string_view context;
     };
 
-    constexpr static std::array<DirectiveInfo, 18> supportedDirectives
+    constexpr static std::array<DirectiveInfo, 37> supportedDirectives
         = {{{.name = "listen", .type = "IntDirective", .context = "S"},
             {.name = "host", .type = "StringDirective", .context = "S"},
             {.name = "server_name", .type = "VectorDirective", .context = "S"},
@@ -28,15 +28,34 @@ class DirectiveFactory
             {.name = "index", .type = "StringDirective", .context = "sl"},
             {.name = "error_page", .type = "IntStringDirective", .context = "gsl"},
             {.name = "client_max_body_size", .type = "SizeDirective", .context = "gsl"},
+            {.name = "client_body_buffer_size", .type = "SizeDirective", .context = "gsl"},
+            {.name = "client_body_temp_path", .type = "StringDirective", .context = "gsl"},
             {.name = "autoindex", .type = "BoolDirective", .context = "gsl"},
             {.name = "allowed_methods", .type = "VectorDirective", .context = "gsl"},
             {.name = "cgi_enabled", .type = "BoolDirective", .context = "gsl"},
             {.name = "cgi_handler", .type = "VectorDirective", .context = "gsl"},
             {.name = "cgi_timeout", .type = "IntDirective", .context = "gsl"},
             {.name = "cgi_tmp_dir", .type = "StringDirective", .context = "gsl"},
+            {.name = "cgi_pool", .type = "StringDirective", .context = "gsl"},
+            {.name = "cgi_pool_min", .type = "IntDirective", .context = "gsl"},
+            {.name = "cgi_pool_max", .type = "IntDirective", .context = "gsl"},
+            {.name = "cgi_pool_requests", .type = "IntDirective", .context = "gsl"},
+            {.name = "cgi_pool_idle_timeout", .type = "IntDirective", .context = "gsl"},
+            {.name = "fastcgi_pass", .type = "StringDirective", .context = "l"},
             {.name = "upload_store", .type = "StringDirective", .context = "l"},
             {.name = "redirect", .type = "IntStringDirective", .context = "l"},
             {.name = "timeout", .type = "IntDirective", .context = "gsl"},
+            {.name = "keepalive_timeout", .type = "IntDirective", .context = "gsl"},
+            {.name = "keepalive_requests", .type = "IntDirective", .context = "gsl"},
+            {.name = "worker_threads", .type = "IntDirective", .context = "g"},
+            {.name = "worker_processes", .type = "IntDirective", .context = "g"},
+            {.name = "open_file_cache", .type = "IntDirective", .context = "g"},
+            {.name = "open_file_cache_valid", .type = "IntDirective", .context = "g"},
+            {.name = "hot_file_cache", .type = "SizeDirective", .context = "g"},
+            {.name = "hot_file_cache_max_file", .type = "SizeDirective", .context = "g"},
+            {.name = "accept_batch", .type = "IntDirective", .context = "g"},
+            {.name = "edge_triggered", .type = "BoolDirective", .context = "g"},
+            {.name = "event_backend", .type = "StringDirective", .context = "g"},
             {.name = "default", .type = "BoolDirective", .context = "s"},
             {.name = "42_tester", .type = "BoolDirective", .context = "s"}}};
 
@@ -4,9 +4,12 @@
 #include <webserv/config/validation/directive_rules/AValidationRule.hpp>      // for AValidationRule
 #include <webserv/config/validation/directive_rules/AllowedValuesRule.hpp>    // for AllowedValuesRule
 #include <webserv/config/validation/directive_rules/CgiExtValidationRule.hpp> // for CgiExtValidationRule
+#include <webserv/config/validation/directive_rules/CgiPoolRule.hpp>          // for CgiPoolRule
 #include <webserv/config/validation/directive_rules/HostValidationRule.hpp>   // for HostValidationRule
+#include <webserv/config/validation/directive_rules/IntRangeRule.hpp>         // for IntRangeRule
 #include <webserv/config/validation/directive_rules/PortValidationRule.hpp>   // for PortValidationRule
 #include <webserv/config/validation/directive_rules/StatusCodeRule.hpp>
+#include <webserv/config/validation/directive_rules/UpstreamAddressRule.hpp> // for UpstreamAddressRule
 #include <webserv/config/validation/structural_rules/AStructuralValidationRule.hpp>  // for AStructuralValidationRule
 #include <webserv/config/validation/structural_rules/MinimumServerBlocksRule.hpp>    // for MinimumServerBlocksRule
 #include <webserv/config/validation/structural_rules/RequiredDirectivesRule.hpp>     // for RequiredDirectivesRule
@@ -15,6 +18,7 @@
 #include <webserv/config/validation/structural_rules/UniqueDirectiveRule.hpp>
 #include <webserv/config/validation/structural_rules/UniqueServerNamesRule.hpp> // for UniqueServerNamesRule
 #include <webserv/log/Log.hpp>                                                  // for LOCATION, Log
+#include <webserv/main.hpp>                                                     // for MAX_WORKER_THREADS, MAX_OPEN_FILE_CACHE
 
 #include <memory> // for unique_ptr, make_unique
 #include <string> // for basic_string, string
@@ -35,16 +39,32 @@ ConfigValidator::ConfigValidator(const GlobalConfig *config) : engine_(std::make
     engine_->addStructuralRule(std::make_unique<SingleDefaultServerPerPortRule>());
     engine_->addStructuralRule(std::make_unique<UniqueDirectiveRule>(std::vector<std::string>{
         "index", "listen", "host", "server_name", "root", "allowed_methods", "autoindex", "cgi_enabled", "upload_store",
-        "client_max_body_size", "cgi_timeout", "redirect", "timeout", "42_tester"}));
+        "client_max_body_size", "client_body_buffer_size", "client_body_temp_path", "cgi_timeout", "cgi_pool",
+        "cgi_pool_min", "cgi_pool_max", "cgi_pool_requests", "cgi_pool_idle_timeout", "redirect", "fastcgi_pass",
+        "timeout", "keepalive_timeout", "keepalive_requests", "worker_threads", "worker_processes", "open_file_cache",
+        "open_file_cache_valid", "hot_file_cache", "hot_file_cache_max_file", "accept_batch", "edge_triggered",
+        "event_backend", "42_tester"}));
 
     /*Global Directive Rules*/
     engine_->addServerRule("error_page", std::make_unique<StatusCodeRule>(false, [](int statusCode) {
                                return statusCode >= 100 && statusCode <= 599;
                            }));
+    engine_->addGlobalRule("worker_threads", std::make_unique<IntRangeRule>(1, MAX_WORKER_THREADS, false));
+    engine_->addGlobalRule("worker_processes", std::make_unique<IntRangeRule>(1, MAX_WORKER_PROCESSES, false));
+    engine_->addGlobalRule("open_file_cache", std::make_unique<IntRangeRule>(0, MAX_OPEN_FILE_CACHE, false));
+    engine_->addGlobalRule("open_file_cache_valid",
+                           std::make_unique<IntRangeRule>(0, MAX_OPEN_FILE_CACHE_VALID, false));
+    engine_->addGlobalRule("keepalive_timeout", std::make_unique<IntRangeRule>(0, MAX_KEEPALIVE_TIMEOUT, false));
+    engine_->addGlobalRule("keepalive_requests", std::make_unique<IntRangeRule>(0, MAX_KEEPALIVE_REQUESTS, false));
+    engine_->addGlobalRule("accept_batch", std::make_unique<IntRangeRule>(1, MAX_ACCEPT_BATCH, false));
+    engine_->addGlobalRule("event_backend",
+                           std::make_unique<AllowedValuesRule>(std::vector<std::string>{"epoll", "io_uring"}, false));
 
     /*Server Directive Rules*/
     engine_->addServerRule("listen", std::make_unique<PortValidationRule>());
     engine_->addServerRule("host", std::make_unique<HostValidationRule>());
+    engine_->addServerRule("keepalive_timeout", std::make_unique<IntRangeRule>(0, MAX_KEEPALIVE_TIMEOUT, false));
+    engine_->addServerRule("keepalive_requests", std::make_unique<IntRangeRule>(0, MAX_KEEPALIVE_REQUESTS, false));
     // Folder existence validation disabled - paths are relative to server runtime directory
 
     /*Location Directive Rules*/
@@ -60,7 +80,17 @@ ConfigValidator::ConfigValidator(const GlobalConfig *config) : engine_(std::make
                                         || statusCode == 308;
                              }));
     // Folder existence validation disabled - paths are relative to server runtime directory
+    engine_->addLocationRule("keepalive_timeout", std::make_unique<IntRangeRule>(0, MAX_KEEPALIVE_TIMEOUT, false));
+    engine_->addLocationRule("keepalive_requests",
+                             std::make_unique<IntRangeRule>(0, MAX_KEEPALIVE_REQUESTS, false));
     engine_->addLocationRule("cgi_handler", std::make_unique<CgiExtValidationRule>(false));
+    engine_->addLocationRule("fastcgi_pass", std::make_unique<UpstreamAddressRule>(false));
+    engine_->addLocationRule("cgi_pool", std::make_unique<CgiPoolRule>(false));
+    engine_->addLocationRule("cgi_pool_min", std::make_unique<IntRangeRule>(0, MAX_CGI_POOL, false));
+    engine_->addLocationRule("cgi_pool_max", std::make_unique<IntRangeRule>(1, MAX_CGI_POOL, false));
+    engine_->addLocationRule("cgi_pool_requests", std::make_unique<IntRangeRule>(1, MAX_CGI_POOL_REQUESTS, false));
+    engine_->addLocationRule("cgi_pool_idle_timeout",
+                             std::make_unique<IntRangeRule>(1, MAX_CGI_POOL_IDLE_TIMEOUT, false));
 
     // TODO: Add a validation rule for redirect
 
@@ -0,0 +1,68 @@
+#include <webserv/config/validation/directive_rules/CgiPoolRule.hpp>
+
+#include <webserv/config/AConfig.hpp>                                    // for AConfig
+#include <webserv/config/directive/ADirective.hpp>                       // for ADirective
+#include <webserv/config/directive/DirectiveValue.hpp>                   // for DirectiveValue
+#include <webserv/config/validation/ValidationResult.hpp>                // for ValidationResult
+#include <webserv/config/validation/directive_rules/AValidationRule.hpp> // for AValidationRule
+
+#include <string> // for basic_string, operator+, string
+#include <vector> // for vector
+
+CgiPoolRule::CgiPoolRule(bool requiresValue)
+    : AValidationRule("CgiPoolRule", "Validates that cgi_pool names a protocol its interpreters speak", requiresValue)
+{
+}
+
+/**
+ * Pooled workers are FastCGI servers, so cgi_pool takes "fastcgi", which states that the cgi_handler interpreters of
+ * the location serve FastCGI on the socket they get as stdin, as php-cgi does, or "off". Interpreters that only speak
+ * CGI, such as python3, cannot be pooled. A location with cgi_pool fastcgi needs at least one cgi_handler
+ * interpreter: its own handlers count, or the inherited ones when it has none.
+ */
+ValidationResult CgiPoolRule::validateValue(const AConfig *config, const std::string &directiveName) const
+{
+    const ADirective *directive = config->getDirective(directiveName);
+
+    if (!directive->getValue().holds<std::string>())
+    {
+        return ValidationResult::error("Directive '" + directive->getName() + "' does not hold a string value");
+    }
+    const std::string &mode = directive->getValue().get<std::string>();
+    if (mode == "off")
+    {
+        return ValidationResult::success();
+    }
+    if (mode != "fastcgi")
+    {
+        return ValidationResult::error("Directive '" + directive->getName() + "' must be 'fastcgi' or 'off', not '"
+                                       + mode + "': pooled workers serve FastCGI, interpreters that only speak CGI "
+                                       + "cannot be pooled");
+    }
+
+    std::vector<const ADirective *> handlers;
+    for (const ADirective *handler : config->getDirectives())
+    {
+        if (handler->getName() == "cgi_handler")
+        {
+            handlers.push_back(handler);
+        }
+    }
+    if (handlers.empty() && config->getDirective("cgi_handler") != nullptr)
+    {
+        handlers.push_back(config->getDirective("cgi_handler"));
+    }
+    for (const ADirective *handler : handlers)
+    {
+        if (!handler->getValue().holds<std::vector<std::string>>())
+        {
+            continue;
+        }
+        if (handler->getValue().get<std::vector<std::string>>().size() > 1)
+        {
+            return ValidationResult::success();
+        }
+    }
+    return ValidationResult::error("Directive '" + directive->getName()
+                                   + "' needs a cgi_handler interpreter that serves FastCGI, such as php-cgi");
+}
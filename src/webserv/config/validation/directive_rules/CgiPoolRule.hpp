@@ -0,0 +1,17 @@
+#pragma once
+
+#include <webserv/config/validation/directive_rules/AValidationRule.hpp> // for AValidationRule
+
+#include <string> // for string
+
+class AConfig;
+
+class CgiPoolRule : public AValidationRule
+{
+  public:
+    CgiPoolRule(bool requiresValue = true);
+
+  private:
+    [[nodiscard]] ValidationResult validateValue(const AConfig *config,
+                                                 const std::string &directiveName) const override;
+};
@@ -0,0 +1,39 @@
+#include <webserv/config/validation/directive_rules/IntRangeRule.hpp>
+
+#include <webserv/config/AConfig.hpp>                                    // for AConfig
+#include <webserv/config/directive/ADirective.hpp>                       // for ADirective
+#include <webserv/config/directive/DirectiveValue.hpp>                   // for DirectiveValue
+#include <webserv/config/validation/ValidationResult.hpp>                // for ValidationResult
+#include <webserv/config/validation/directive_rules/AValidationRule.hpp> // for AValidationRule
+#include <webserv/log/Log.hpp>                                           // for LOCATION, Log
+
+#include <string> // for operator+, basic_string, to_string, string
+
+IntRangeRule::IntRangeRule(int min, int max, bool requiresValue)
+    : AValidationRule("IntRangeRule",
+                      "Validates that an integer directive is within " + std::to_string(min) + "-"
+                          + std::to_string(max),
+                      requiresValue),
+      min_(min), max_(max)
+{
+}
+
+ValidationResult IntRangeRule::validateValue(const AConfig *config, const std::string &directiveName) const
+{
+    Log::trace(LOCATION);
+    const ADirective *directive = config->getDirective(directiveName);
+    if (!directive->getValue().holds<int>())
+    {
+        return ValidationResult::error("Directive '" + directive->getName() + "' does not hold an integer value");
+    }
+
+    int value = directive->getValue().get<int>();
+    if (value < min_ || value > max_)
+    {
+        return ValidationResult::error("Directive '" + directive->getName() + "' value " + std::to_string(value)
+                                       + " is out of valid range (" + std::to_string(min_) + "-"
+                                       + std::to_string(max_) + ")");
+    }
+
+    return ValidationResult::success();
+}
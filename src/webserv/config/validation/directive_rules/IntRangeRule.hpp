@@ -0,0 +1,20 @@
+#pragma once
+
+#include <webserv/config/validation/directive_rules/AValidationRule.hpp> // for AValidationRule
+
+#include <string> // for string
+
+class AConfig;
+
+class IntRangeRule : public AValidationRule
+{
+  public:
+    IntRangeRule(int min, int max, bool requiresValue = true);
+
+  private:
+    int min_;
+    int max_;
+
+    [[nodiscard]] ValidationResult validateValue(const AConfig *config,
+                                                 const std::string &directiveName) const override;
+};
@@ -0,0 +1,34 @@
+#include <webserv/config/validation/directive_rules/UpstreamAddressRule.hpp>
+
+#include <webserv/config/AConfig.hpp>                                    // for AConfig
+#include <webserv/config/directive/ADirective.hpp>                       // for ADirective
+#include <webserv/config/directive/DirectiveValue.hpp>                   // for DirectiveValue
+#include <webserv/config/validation/ValidationResult.hpp>                // for ValidationResult
+#include <webserv/config/validation/directive_rules/AValidationRule.hpp> // for AValidationRule
+#include <webserv/socket/UpstreamSocket.hpp>                             // for UpstreamSocket
+
+#include <string> // for basic_string, operator+, string
+
+UpstreamAddressRule::UpstreamAddressRule(bool requiresValue)
+    : AValidationRule("UpstreamAddressRule", "Validates that the address is unix:/path or ipv4:port", requiresValue)
+{
+}
+
+ValidationResult UpstreamAddressRule::validateValue(const AConfig *config, const std::string &directiveName) const
+{
+    const ADirective *directive = config->getDirective(directiveName);
+
+    if (!directive->getValue().holds<std::string>())
+    {
+        return ValidationResult::error("Directive '" + directive->getName() + "' does not hold a string value");
+    }
+
+    auto address = directive->getValue().get<std::string>();
+
+    if (!UpstreamSocket::isValidAddress(address))
+    {
+        return ValidationResult::error("Upstream address '" + address + "' is neither unix:/path nor ipv4:port");
+    }
+
+    return ValidationResult::success();
+}
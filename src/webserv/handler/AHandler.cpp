@@ -6,6 +6,7 @@
 #include <webserv/http/HttpRequest.hpp> // for HttpRequest
 #include <webserv/log/Log.hpp>          // for Log
 #include <webserv/main.hpp>
+#include <webserv/server/Server.hpp>      // for Server
 #include <webserv/socket/TimerSocket.hpp> // for TimerSocket
 
 #include <chrono>     // for operator*, milliseconds
@@ -21,13 +22,12 @@ AHandler::~AHandler() = default;
 void AHandler::startTimer()
 {
     timerSocket_ = std::make_unique<TimerSocket>(
+        request_.getClient().getServer().getTimerWheel(),
         std::chrono::milliseconds(request_.getUri().getConfig()->get<int>("timeout").value_or(DEFAULT_TIMEOUT)) * 1000);
 
     timerSocket_->setCallback([this]() { handleTimeout(); });
     timerSocket_->activate();
-
-    request_.getClient().addSocket(timerSocket_.get());
-    Log::debug("Timer started for handler: " + std::to_string(timerSocket_->getFd()));
+    Log::debug("Timer started for handler: " + timerSocket_->toString());
 }
 
 TimerSocket *AHandler::getTimerSocket() const noexcept
@@ -1,9 +1,10 @@
 #include <webserv/handler/CgiEnvironment.hpp>
 
-#include <webserv/client/Client.hpp>  // for Client
-#include <webserv/config/AConfig.hpp> // for AConfig
+#include <webserv/client/Client.hpp>    // for Client
+#include <webserv/config/AConfig.hpp>   // for AConfig
 #include <webserv/handler/URI.hpp>      // for URI
 #include <webserv/http/HttpHeaders.hpp> // for HttpHeaders
+#include <webserv/http/RequestBody.hpp> // for RequestBody
 #include <webserv/log/Log.hpp>          // for Log, LOCATION
 #include <webserv/utils/utils.hpp>      // for ensureTrailingSlash
 
@@ -45,7 +46,8 @@ CgiEnvironment::CgiEnvironment(const URI &uri, const HttpRequest &request)
     env_["UPLOAD_TMP_DIR"] = uri.getConfig()->get<std::string>("cgi_tmp_dir").value_or(root);
     env_["TMP_DIR"] = env_["UPLOAD_TMP_DIR"];
     env_["CONTENT_TYPE"] = request.getHeaders().getContentType().value_or("");
-    env_["CONTENT_LENGTH"] = std::to_string(request.getHeaders().getContentLength().value_or(0));
+    // The body is complete by now, a chunked one has no Content-Length header
+    env_["CONTENT_LENGTH"] = std::to_string(request.getBody().size());
 
     if (uri.getConfig()->get<bool>("42_tester").value_or(false))
     {
@@ -79,6 +81,11 @@ char **CgiEnvironment::toEnvp() const
     return envp;
 }
 
+const std::map<std::string, std::string> &CgiEnvironment::getAll() const noexcept
+{
+    return env_;
+}
+
 std::string CgiEnvironment::get(const std::string &key) const
 {
     auto it = env_.find(key);
@@ -92,10 +99,8 @@ std::string CgiEnvironment::get(const std::string &key) const
 void CgiEnvironment::addHttpHeaderToEnv(const std::string &headerName, const HttpHeaders &headers,
                                         const char *separator)
 {
-    std::string lower = headerName;
-    std::ranges::transform(lower, lower.begin(), ::tolower);
-    auto it = headers.getAll().find(lower);
-    if (it == headers.getAll().end() || it->second.empty())
+    const HttpHeaders::Values *vals = headers.getValues(headerName);
+    if (vals == nullptr || vals->empty())
     {
         return;
     }
@@ -106,15 +111,14 @@ void CgiEnvironment::addHttpHeaderToEnv(const std::string &headerName, const Htt
     std::replace(envKey.begin(), envKey.end(), '-', '_');
 
     // Join multiple header values
-    const std::vector<std::string> &vals = it->second;
     std::string joined;
-    for (size_t i = 0; i < vals.size(); ++i)
+    for (size_t i = 0; i < vals->size(); ++i)
     {
         if (i != 0)
         {
             joined += separator;
         }
-        joined += vals[i];
+        joined += (*vals)[i];
     }
 
     env_[envKey] = joined;
@@ -125,24 +129,26 @@ void CgiEnvironment::setXHeaders(const HttpHeaders &headers)
     Log::trace(LOCATION);
     for (const auto &header : headers.getAll())
     {
-        // header.first is stored lower-cased by HttpHeaders
-        if (!header.first.starts_with("x-"))
+        // header.name keeps the case the client sent it in
+        if (header.name.size() < 2 || std::tolower(static_cast<unsigned char>(header.name[0])) != 'x'
+            || header.name[1] != '-')
         {
             continue;
         }
-        std::string key = "HTTP_" + header.first;
+        std::string key = "HTTP_";
+        key += header.name;
         std::ranges::transform(key.begin(), key.end(), key.begin(), ::toupper);
         std::ranges::replace(key.begin(), key.end(), '-', '_');
 
         // Join multiple header values with a comma (RFC: combine field-values where appropriate)
         std::string joined;
-        for (size_t i = 0; i < header.second.size(); ++i)
+        for (size_t i = 0; i < header.values.size(); ++i)
         {
             if (i != 0)
             {
                 joined += ", ";
             }
-            joined += header.second[i];
+            joined += header.values[i];
         }
         env_[key] = joined;
         std::string msg = "Added custom header with key: ";
@@ -18,6 +18,7 @@ class CgiEnvironment
 
     std::string get(const std::string &key) const;
     [[nodiscard]] char **toEnvp() const;
+    [[nodiscard]] const std::map<std::string, std::string> &getAll() const noexcept;
 
   private:
     void setXHeaders(const HttpHeaders &headers);
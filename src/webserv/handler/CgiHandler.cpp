@@ -2,34 +2,33 @@
 
 #include <webserv/client/Client.hpp>  // for Client
 #include <webserv/config/AConfig.hpp> // for AConfig
+#include <webserv/handler/CgiOutput.hpp>    // for CgiOutput
 #include <webserv/handler/CgiProcess.hpp>   // for CgiProcess
 #include <webserv/handler/ErrorHandler.hpp> // for ErrorHandler
 #include <webserv/handler/URI.hpp>          // for URI
 #include <webserv/http/HttpConstants.hpp>   // for GATEWAY_TIMEOUT
-#include <webserv/http/HttpHeaders.hpp>     // for HttpHeaders
 #include <webserv/http/HttpRequest.hpp>     // for HttpRequest
 #include <webserv/http/HttpResponse.hpp>    // for HttpResponse
+#include <webserv/http/RequestBody.hpp>     // for RequestBody
 #include <webserv/log/Log.hpp>              // for Log, LOCATION
 #include <webserv/main.hpp>                 // for BUFFER_SIZE, CHUNK_SIZE, CGI_TIMEOUT
 #include <webserv/socket/CgiSocket.hpp>     // for CgiSocket
 #include <webserv/socket/ClientSocket.hpp>  // for ClientSocket
 #include <webserv/socket/TimerSocket.hpp>   // for TimerSocket
-#include <webserv/utils/utils.hpp>          // for trim
 
-#include <algorithm>  // for min
-#include <array>      // for array
-#include <chrono>     // for operator*, milliseconds
-#include <cstdlib>    // for atoi
-#include <functional> // for function
-#include <optional>   // for optional
-#include <string>     // for basic_string, operator+, char_traits, to_string, string
-#include <utility>    // for move
+#include <array>       // for array
+#include <chrono>      // for operator*, milliseconds
+#include <functional>  // for function
+#include <string>      // for basic_string, operator+, char_traits, to_string, string
+#include <string_view> // for string_view
+#include <utility>     // for move
 
 #include <sys/types.h> // for ssize_t
 #include <unistd.h>    // for access, X_OK
 
 CgiHandler::CgiHandler(const HttpRequest &request, HttpResponse &response)
-    : AHandler(request, response), cgiProcess_(nullptr), cgiStdIn_(nullptr), cgiStdOut_(nullptr)
+    : AHandler(request, response), output_(request, response, [this]() { resumeStdOut(); }), cgiProcess_(nullptr),
+      cgiStdIn_(nullptr), cgiStdOut_(nullptr)
 {
     Log::debug("CgiHandler constructed");
 }
@@ -52,23 +51,6 @@ void CgiHandler::handle()
     Log::info(request_.getClient().getClientSocket()->toString() + ": CGI started");
 }
 
-static inline bool findHeaderEnd(const std::string &s, size_t &pos, long &sepSize)
-{
-    Log::trace(LOCATION);
-    size_t a = s.find("\r\n\r\n");
-    size_t b = s.find("\n\n");
-    size_t c = s.find("\r\r");
-    size_t end = std::min({a, b, c});
-
-    if (end == std::string::npos)
-    {
-        return false;
-    }
-    sepSize = (end == a) ? 4 : 2;
-    pos = end;
-    return true;
-}
-
 void CgiHandler::write()
 {
     Log::trace(LOCATION);
@@ -77,14 +59,14 @@ void CgiHandler::write()
         Log::error("CGI stdin socket is null");
         return;
     }
-    const std::string &body = request_.getBody();
+    const RequestBody &body = request_.getBody();
 
     if (writeOffset_ < body.size())
     {
-        const char *data = body.data() + writeOffset_; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-        size_t remaining = body.size() - writeOffset_;
-        size_t chunk = remaining > Constants::CHUNK_SIZE ? Constants::CHUNK_SIZE : remaining;
-        ssize_t bytesWritten = cgiStdIn_->write(data, chunk);
+        // A spooled body is read back one chunk at a time, so piping it never needs more memory than that
+        std::array<char, Constants::CHUNK_SIZE> scratch; // NOLINT(cppcoreguidelines-pro-type-member-init)
+        std::string_view chunk = body.read(writeOffset_, scratch);
+        ssize_t bytesWritten = cgiStdIn_->write(chunk.data(), chunk.size());
         if (bytesWritten > 0)
         {
             writeOffset_ += static_cast<size_t>(bytesWritten);
@@ -101,6 +83,10 @@ void CgiHandler::write()
     }
 }
 
+/**
+ * Output is handed to output_ as it is read. Reading pauses while the client has not sent what came before, so a slow
+ * client holds the script back rather than the output piling up in memory.
+ */
 void CgiHandler::read()
 {
     Log::trace(LOCATION);
@@ -113,43 +99,21 @@ void CgiHandler::read()
     ssize_t bytesRead = cgiStdOut_->read(buffer.data(), buffer.size());
     if (bytesRead > 0)
     {
-        appendToBuffer(buffer.data(), static_cast<size_t>(bytesRead));
-        Log::debug("Read " + std::to_string(bytesRead)
-                   + " bytes from CGI stdout (buffer size: " + std::to_string(buffer_.size()) + ")");
-
-        // Parse headers once, as soon as we have them
-        if (!headersParsed_)
-        {
-            size_t headerEnd = 0;
-            long sepSize = 0;
-            std::string snapshot(buffer_.begin(), buffer_.end());
-            if (findHeaderEnd(snapshot, headerEnd, sepSize))
-            {
-                std::string headers(snapshot.begin(), snapshot.begin() + static_cast<long>(headerEnd));
-                parseCgiHeaders(headers);
-                // After headers parsed, remove them from buffer_ so it contains only body
-                buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<long>(headerEnd) + sepSize);
-                headersParsed_ = true;
-                contentLength_ = response_.getHeaders().getContentLength();
-                Log::debug("CGI headers parsed, Content-Length: "
-                           + (contentLength_.has_value() ? std::to_string(contentLength_.value()) : "not set"));
-            }
-        }
-
-        // Only finalize if we've finished writing the request body AND we have complete response
-        bool responseComplete = false;
-        if (headersParsed_ && contentLength_.has_value())
+        Log::debug("Read " + std::to_string(bytesRead) + " bytes from CGI stdout");
+        resetTimer();
+        output_.write(std::string_view(buffer.data(), static_cast<size_t>(bytesRead)));
+        if (output_.isComplete())
         {
-            responseComplete = (buffer_.size() >= contentLength_.value());
+            Log::debug("Response complete: headers parsed and content received");
+            closeStdOut();
+            finish();
+            return;
         }
-
-        if (responseComplete)
+        if (output_.isBackedUp() && !stdOutPaused_)
         {
-            Log::debug("Response complete: headers parsed and content received");
+            Log::debug("CGI output waits for the client; pausing reads");
             request_.getClient().removeSocket(cgiStdOut_.get());
-            cgiStdOut_.reset();
-            finalizeCgiResponse();
-            return;
+            stdOutPaused_ = true;
         }
         return;
     }
@@ -158,26 +122,8 @@ void CgiHandler::read()
     {
         // EOF from CGI process
         Log::debug("CGI process closed stdout, fd: " + std::to_string(cgiStdOut_->getFd()));
-        request_.getClient().removeSocket(cgiStdOut_.get());
-        cgiStdOut_.reset();
-
-        // If headers not parsed yet, try once more
-        if (!headersParsed_)
-        {
-            size_t headerEnd = 0;
-            long sep = 0;
-            std::string snap(buffer_.begin(), buffer_.end());
-            if (findHeaderEnd(snap, headerEnd, sep))
-            {
-                std::string headers(snap.begin(), snap.begin() + static_cast<long>(headerEnd));
-                parseCgiHeaders(headers);
-                buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<long>(headerEnd) + sep);
-                headersParsed_ = true;
-            }
-        }
-
-        // Only finalize if we've finished writing the request body
-        finalizeCgiResponse();
+        closeStdOut();
+        finish();
         return;
     }
 
@@ -185,7 +131,13 @@ void CgiHandler::read()
     {
 
         Log::error("Error reading from CGI stdout");
-        finalizeCgiResponse();
+        if (output_.isStreaming())
+        {
+            closeStdOut();
+            output_.abort();
+            return;
+        }
+        finish();
     }
 }
 
@@ -202,7 +154,6 @@ void CgiHandler::error()
         ssize_t bytesRead = cgiStdErr_->read(buffer.data(), buffer.size());
         if (bytesRead > 0)
         {
-            appendToBuffer(buffer.data(), static_cast<size_t>(bytesRead));
             Log::error("CGI stderr output (fd: " + std::to_string(cgiStdErr_->getFd())
                        + "): " + std::string(buffer.data(), static_cast<size_t>(bytesRead)));
             continue;
@@ -251,104 +202,30 @@ void CgiHandler::wait() noexcept
 void CgiHandler::startTimer()
 {
     timerSocket_ = std::make_unique<TimerSocket>(
+        request_.getClient().getServer().getTimerWheel(),
         std::chrono::milliseconds(request_.getUri().getConfig()->get<int>("cgi_timeout").value_or(CGI_TIMEOUT)) * 1000);
 
     timerSocket_->setCallback([this]() { handleTimeout(); });
     timerSocket_->activate();
-
-    request_.getClient().addSocket(timerSocket_.get());
-    Log::debug("Timer started for handler: " + std::to_string(timerSocket_->getFd()));
+    Log::debug("Timer started for handler: " + timerSocket_->toString());
 }
 
-void CgiHandler::setPid(int pid)
+void CgiHandler::resetTimer()
 {
-    pid_ = pid;
-}
-
-void CgiHandler::parseCgiOutput()
-{
-    Log::trace(LOCATION);
-    if (headersParsed_)
+    if (timerSocket_ != nullptr)
     {
-        return;
-    }
-    size_t headerEnd = 0;
-    long sepSize = 0;
-    std::string header(buffer_.begin(), buffer_.end());
-    if (!findHeaderEnd(header, headerEnd, sepSize))
-    {
-        Log::debug("CGI output headers not complete yet");
-        return;
+        timerSocket_->activate();
     }
-    std::string headers(header.begin(), header.begin() + static_cast<long>(headerEnd));
-    Log::debug("CGI output headers: " + headers);
-    parseCgiHeaders(headers);
-    buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<long>(headerEnd) + sepSize);
-    headersParsed_ = true;
-    contentLength_ = response_.getHeaders().getContentLength();
 }
 
-void CgiHandler::parseCgiHeaders(std::string &headers)
+void CgiHandler::setPid(int pid)
 {
-    Log::trace(LOCATION);
-
-    // Debug: log the raw headers to see what we're getting
-    Log::debug("Raw CGI headers (length=" + std::to_string(headers.length()) + "): [" + headers + "]");
-
-    size_t start = 0;
-    size_t end = headers.find("\r\n");
-    while (end != std::string::npos)
-    {
-        std::string header = headers.substr(start, end - start);
-        if (!header.empty())
-        {
-            Log::debug("CGI header: [" + header + "]");
-            size_t colonPos = header.find(':');
-            if (colonPos != std::string::npos)
-            {
-                std::string name = header.substr(0, colonPos);
-                std::string value = header.substr(colonPos + 1);
-                name = utils::trim(name);
-                value = utils::trim(value);
-                response_.addHeader(name, value);
-            }
-            else
-            {
-                Log::warning("CGI header has no colon: [" + header + "]");
-            }
-        }
-        start = end + 2;
-        end = headers.find("\r\n", start);
-    }
-
-    // Handle the last header (might not have trailing \r\n)
-    std::string lastHeader = headers.substr(start);
-    if (!lastHeader.empty())
-    {
-        Log::debug("Last CGI header: [" + lastHeader + "]");
-        size_t colonPos = lastHeader.find(':');
-        if (colonPos != std::string::npos)
-        {
-            std::string name = lastHeader.substr(0, colonPos);
-            std::string value = lastHeader.substr(colonPos + 1);
-            name = utils::trim(name);
-            value = utils::trim(value);
-            response_.addHeader(name, value);
-        }
-    }
-
-    contentLength_ = response_.getHeaders().getContentLength();
+    pid_ = pid;
 }
 
 void CgiHandler::handleTimeout()
 {
     Log::warning("CGI handler timeout occurred for PID: " + std::to_string(pid_));
-    std::array<char, 9> buffer = {};
-    ssize_t bytesRead = timerSocket_->read(buffer.data(), buffer.size() - 1);
-    if (bytesRead <= 0)
-    {
-        return;
-    }
 
     // Terminate the CGI process if it's still running
     if (cgiProcess_)
@@ -356,32 +233,51 @@ void CgiHandler::handleTimeout()
         cgiProcess_->kill();
         Log::info("Terminated CGI process with PID: " + std::to_string(pid_));
     }
+    if (output_.isStreaming())
+    {
+        closeStdOut();
+        output_.abort();
+        return;
+    }
 
     ErrorHandler::createErrorResponse(Http::StatusCode::GATEWAY_TIMEOUT, response_);
 }
 
-void CgiHandler::finalizeCgiResponse()
+/**
+ * The script has no more output; a non-zero exit status fails a response that was not sent yet.
+ */
+void CgiHandler::finish()
 {
-    Log::trace(LOCATION);
-    auto status = response_.getHeaders().get("Status");
     wait();
-    if (cgiProcess_ && cgiProcess_->getExitCode() > 0 && status.empty())
-    {
-        response_.setStatus(500);
-    }
-    else if (!status.empty())
+    output_.finish(cgiProcess_ != nullptr && cgiProcess_->getExitCode() > 0);
+}
+
+/**
+ * The client sent what was queued. Like output from the script it restarts cgi_timeout: a streamed response only
+ * times out when neither side makes progress, however long a slow client takes overall.
+ */
+void CgiHandler::resumeStdOut()
+{
+    resetTimer();
+    if (stdOutPaused_ && cgiStdOut_ != nullptr)
     {
-        response_.setStatus(std::atoi(status.c_str()));
+        request_.getClient().addSocket(cgiStdOut_.get());
     }
-    response_.appendBody(buffer_);
-    response_.setComplete();
-    buffer_.clear();
+    stdOutPaused_ = false;
 }
 
-void CgiHandler::appendToBuffer(const char *data, size_t length)
+void CgiHandler::closeStdOut()
 {
-    Log::trace(LOCATION);
-    buffer_.insert(buffer_.end(), data, data + length); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if (cgiStdOut_ == nullptr)
+    {
+        return;
+    }
+    if (!stdOutPaused_)
+    {
+        request_.getClient().removeSocket(cgiStdOut_.get());
+    }
+    stdOutPaused_ = false;
+    cgiStdOut_.reset();
 }
 
 CgiProcess *CgiHandler::getCgiProcess() const noexcept
@@ -1,17 +1,14 @@
 #pragma once
 
-#include <webserv/handler/AHandler.hpp> // for AHandler
-#include <webserv/http/HttpRequest.hpp> // for HttpRequest
-#include <webserv/socket/CgiSocket.hpp> // for CgiSocket
+#include <webserv/handler/AHandler.hpp>  // for AHandler
+#include <webserv/handler/CgiOutput.hpp> // for CgiOutput
+#include <webserv/http/HttpRequest.hpp>  // for HttpRequest
+#include <webserv/socket/CgiSocket.hpp>  // for CgiSocket
 
 #include <cstddef>
-#include <memory>   // for unique_ptr
-#include <optional> // for optional
-#include <string>   // for string
-#include <vector>   // for vector
+#include <memory> // for unique_ptr
 
 #include <stddef.h> // for size_t
-#include <stdint.h> // for uint8_t
 
 class CgiProcess;
 class HttpResponse;
@@ -47,21 +44,21 @@ class CgiHandler : public AHandler
     void handleTimeout() override;
 
   private:
-    std::vector<uint8_t> buffer_;
+    CgiOutput output_;
     std::unique_ptr<CgiProcess> cgiProcess_;
     std::unique_ptr<CgiSocket> cgiStdIn_;
     std::unique_ptr<CgiSocket> cgiStdOut_;
     std::unique_ptr<CgiSocket> cgiStdErr_;
 
-    void parseCgiOutput();
-    void parseCgiHeaders(std::string &headers);
-    void finalizeCgiResponse();
-    void appendToBuffer(const char *data, size_t length);
+    void finish();
+    void resumeStdOut();
+    void resetTimer();
+    void closeStdOut();
 
     int pid_ = -1;
     size_t writeOffset_ = 0;
-    bool headersParsed_ = false;
-    std::optional<size_t> contentLength_;
+    // Set while stdout is unregistered because the client has not sent what was read yet
+    bool stdOutPaused_ = false;
 
     void write();
     void read();
@@ -0,0 +1,272 @@
+#include <webserv/handler/CgiOutput.hpp>
+
+#include <webserv/http/HttpConstants.hpp> // for Version
+#include <webserv/http/HttpHeaders.hpp>   // for HttpHeaders
+#include <webserv/http/HttpRequest.hpp>   // for HttpRequest
+#include <webserv/http/HttpResponse.hpp>  // for HttpResponse
+#include <webserv/log/Log.hpp>            // for Log, LOCATION
+#include <webserv/main.hpp>               // for STREAM_BUFFER_SIZE
+#include <webserv/utils/Scan.hpp>         // for findAny
+#include <webserv/utils/utils.hpp>        // for trim
+
+#include <cstdlib>     // for atoi
+#include <string>      // for basic_string, operator+, char_traits, to_string, string
+#include <string_view> // for string_view
+#include <utility>     // for move
+#include <vector>      // for vector
+
+CgiOutput::CgiOutput(const HttpRequest &request, HttpResponse &response, std::function<void()> onDrain)
+    : request_(request), response_(response), onDrain_(std::move(onDrain))
+{
+}
+
+/**
+ * Finds the blank line ending the CGI header block: CRLF CRLF, LF LF or CR CR, whichever comes first. One pass over
+ * the line breaks in output, without copying it.
+ */
+static inline bool findHeaderEnd(const std::vector<uint8_t> &output, size_t &pos, long &sepSize)
+{
+    Log::trace(LOCATION);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    std::string_view view(reinterpret_cast<const char *>(output.data()), output.size());
+    for (size_t i = scan::findAny(view, '\r', '\n'); i != std::string_view::npos;
+         i = scan::findAny(view, '\r', '\n', i + 1))
+    {
+        std::string_view rest = view.substr(i);
+        if (rest.starts_with("\r\n\r\n"))
+        {
+            sepSize = 4;
+        }
+        else if (rest.starts_with("\n\n") || rest.starts_with("\r\r"))
+        {
+            sepSize = 2;
+        }
+        else
+        {
+            continue;
+        }
+        pos = i;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Takes the next piece of output. Once the headers are in, body bytes are forwarded to the client as they come; the
+ * caller checks isBackedUp() to hold the script back while the client is slower.
+ */
+void CgiOutput::write(std::string_view data)
+{
+    Log::trace(LOCATION);
+    if (finished_)
+    {
+        return;
+    }
+    if (headersParsed_)
+    {
+        forward(data);
+        return;
+    }
+    buffer_.insert(buffer_.end(), data.begin(), data.end());
+    parseCgiOutput();
+    if (headersParsed_)
+    {
+        startResponse();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        forward(std::string_view(reinterpret_cast<const char *>(buffer_.data()), buffer_.size()));
+        std::vector<uint8_t>().swap(buffer_);
+    }
+}
+
+/**
+ * The script has no more output. failed tells whether it exited with an error, which turns a response without a
+ * Status header into a 500 as long as nothing was sent yet.
+ */
+void CgiOutput::finish(bool failed)
+{
+    if (finished_)
+    {
+        return;
+    }
+    if (isStreaming())
+    {
+        endResponse();
+        return;
+    }
+    parseCgiOutput();
+    finalizeCgiResponse(failed);
+}
+
+/**
+ * Ends a stream whose source failed. The head has gone out already, the client can only learn about it from the
+ * connection closing.
+ */
+void CgiOutput::abort()
+{
+    finished_ = true;
+    response_.abortStream();
+}
+
+bool CgiOutput::isStreaming() const noexcept
+{
+    return response_.getStream() == HttpResponse::Stream::Open;
+}
+
+/**
+ * True once the body announced by Content-Length has been passed on in full.
+ */
+bool CgiOutput::isComplete() const noexcept
+{
+    return headersParsed_ && contentLength_.has_value() && streamed_ >= *contentLength_;
+}
+
+/**
+ * True while Constants::STREAM_BUFFER_SIZE bytes wait to be sent, so a slow client holds the script back rather than
+ * the output piling up in memory.
+ */
+bool CgiOutput::isBackedUp() const noexcept
+{
+    return !finished_ && response_.getBodySize() >= Constants::STREAM_BUFFER_SIZE;
+}
+
+void CgiOutput::parseCgiOutput()
+{
+    Log::trace(LOCATION);
+    if (headersParsed_)
+    {
+        return;
+    }
+    size_t headerEnd = 0;
+    long sepSize = 0;
+    if (!findHeaderEnd(buffer_, headerEnd, sepSize))
+    {
+        Log::debug("CGI output headers not complete yet");
+        return;
+    }
+    std::string headers(buffer_.begin(), buffer_.begin() + static_cast<long>(headerEnd));
+    Log::debug("CGI output headers: " + headers);
+    parseCgiHeaders(headers);
+    buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<long>(headerEnd) + sepSize);
+    headersParsed_ = true;
+    contentLength_ = response_.getHeaders().getContentLength();
+}
+
+void CgiOutput::parseCgiHeaders(const std::string &headers)
+{
+    Log::trace(LOCATION);
+
+    // Debug: log the raw headers to see what we're getting
+    Log::debug("Raw CGI headers (length=" + std::to_string(headers.length()) + "): [" + headers + "]");
+
+    size_t start = 0;
+    size_t end = headers.find("\r\n");
+    while (end != std::string::npos)
+    {
+        std::string header = headers.substr(start, end - start);
+        if (!header.empty())
+        {
+            Log::debug("CGI header: [" + header + "]");
+            size_t colonPos = header.find(':');
+            if (colonPos != std::string::npos)
+            {
+                std::string name = header.substr(0, colonPos);
+                std::string value = header.substr(colonPos + 1);
+                name = utils::trim(name);
+                value = utils::trim(value);
+                response_.addHeader(name, value);
+            }
+            else
+            {
+                Log::warning("CGI header has no colon: [" + header + "]");
+            }
+        }
+        start = end + 2;
+        end = headers.find("\r\n", start);
+    }
+
+    // Handle the last header (might not have trailing \r\n)
+    std::string lastHeader = headers.substr(start);
+    if (!lastHeader.empty())
+    {
+        Log::debug("Last CGI header: [" + lastHeader + "]");
+        size_t colonPos = lastHeader.find(':');
+        if (colonPos != std::string::npos)
+        {
+            std::string name = lastHeader.substr(0, colonPos);
+            std::string value = lastHeader.substr(colonPos + 1);
+            name = utils::trim(name);
+            value = utils::trim(value);
+            response_.addHeader(name, value);
+        }
+    }
+
+    contentLength_ = response_.getHeaders().getContentLength();
+}
+
+void CgiOutput::finalizeCgiResponse(bool failed)
+{
+    Log::trace(LOCATION);
+    finished_ = true;
+    auto status = response_.getHeaders().get(HttpHeaders::Field::Status);
+    if (failed && status.empty())
+    {
+        response_.setStatus(500);
+    }
+    else if (!status.empty())
+    {
+        response_.setStatus(std::atoi(std::string(status).c_str()));
+    }
+    response_.appendBody(buffer_);
+    response_.setComplete();
+    buffer_.clear();
+}
+
+/**
+ * Sends the head as soon as the CGI headers are parsed. A body without Content-Length is sent chunked, or delimited by
+ * closing the connection for an HTTP/1.0 client.
+ */
+void CgiOutput::startResponse()
+{
+    Log::trace(LOCATION);
+    auto status = response_.getHeaders().get(HttpHeaders::Field::Status);
+    if (!status.empty())
+    {
+        response_.setStatus(std::atoi(std::string(status).c_str()));
+    }
+    bool chunked = !contentLength_.has_value() && request_.getHttpVersion() == Http::Version::HTTP_1_1;
+    if (!contentLength_.has_value() && !chunked)
+    {
+        response_.addHeader(HttpHeaders::Field::Connection, "close");
+    }
+    response_.onDrain(onDrain_);
+    response_.startStream(chunked);
+}
+
+/**
+ * Passes body bytes on to the response, up to the Content-Length the script announced.
+ */
+void CgiOutput::forward(std::string_view data)
+{
+    if (contentLength_.has_value())
+    {
+        data = data.substr(0, *contentLength_ - streamed_);
+    }
+    streamed_ += data.size();
+    response_.appendStream(data);
+}
+
+/**
+ * Ends a streamed body. One that falls short of its Content-Length can only be reported by closing the connection.
+ */
+void CgiOutput::endResponse()
+{
+    finished_ = true;
+    if (contentLength_.has_value() && streamed_ < *contentLength_)
+    {
+        Log::warning("CGI output ended after " + std::to_string(streamed_) + " of "
+                     + std::to_string(*contentLength_) + " bytes");
+        response_.abortStream();
+        return;
+    }
+    response_.endStream();
+}
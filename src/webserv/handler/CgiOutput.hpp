@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint8_t
+#include <functional>  // for function
+#include <optional>    // for optional
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+class HttpRequest;
+class HttpResponse;
+
+/**
+ * Turns the output of a CGI script into the response, wherever it is read from: the header block is parsed, then the
+ * body is streamed to the client as it arrives.
+ */
+class CgiOutput
+{
+  public:
+    CgiOutput(const HttpRequest &request, HttpResponse &response, std::function<void()> onDrain);
+
+    CgiOutput(const CgiOutput &other) = delete;
+    CgiOutput &operator=(const CgiOutput &other) = delete;
+    CgiOutput(CgiOutput &&other) noexcept = delete;
+    CgiOutput &operator=(CgiOutput &&other) noexcept = delete;
+
+    ~CgiOutput() = default;
+
+    void write(std::string_view data);
+    void finish(bool failed);
+    void abort();
+
+    [[nodiscard]] bool isStreaming() const noexcept;
+    [[nodiscard]] bool isComplete() const noexcept;
+    [[nodiscard]] bool isBackedUp() const noexcept;
+
+  private:
+    const HttpRequest &request_;
+    HttpResponse &response_;
+    std::function<void()> onDrain_;
+    // Output read before the end of the header block
+    std::vector<uint8_t> buffer_;
+    bool headersParsed_ = false;
+    bool finished_ = false;
+    std::optional<size_t> contentLength_;
+    // Body bytes passed on to the response so far
+    size_t streamed_ = 0;
+
+    void parseCgiOutput();
+    void parseCgiHeaders(const std::string &headers);
+    void startResponse();
+    void forward(std::string_view data);
+    void endResponse();
+    void finalizeCgiResponse(bool failed);
+};
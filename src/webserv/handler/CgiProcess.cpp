@@ -20,7 +20,7 @@
 #include <webserv/socket/CgiSocket.hpp> // for CgiSocket
 
 #include <csignal>   // for kill, SIGKILL
-#include <cstdlib>   // for WEXITSTATUS, exit
+#include <cstdlib>   // for WEXITSTATUS
 #include <memory>    // for allocator, make_unique, unique_ptr
 #include <stdexcept> // for runtime_error
 #include <string>    // for char_traits, basic_string, operator+, to_string, string
@@ -28,7 +28,16 @@
 
 #include <fcntl.h>    // for fcntl, O_NONBLOCK, F_GETFL, F_SETFL, O_CLOEXEC
 #include <sys/wait.h> // for waitpid, WNOHANG
-#include <unistd.h>   // for close, dup2, pipe2, execve, fork, STDERR_FILENO, STDIN_FILENO, STDOUT_FILENO
+#include <unistd.h>   // for close, close_range, dup2, pipe2, execve, fork, _exit, STDERR_FILENO, STDIN_FILENO, STDOUT_FILENO
+
+static inline void freeEnvp(char **envp) noexcept
+{
+    for (char **entry = envp; *entry != nullptr; ++entry) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    {
+        delete[] *entry;
+    }
+    delete[] envp;
+}
 
 CgiProcess::CgiProcess(const HttpRequest &request, CgiHandler &handler)
     : request_(request), handler_(handler), pid_(-1), status_(-1)
@@ -43,7 +52,12 @@ CgiProcess::CgiProcess(const HttpRequest &request, CgiHandler &handler)
 
 CgiProcess::~CgiProcess()
 {
-    this->kill();
+    if (pid_ > 0)
+    {
+        // SIGKILL cannot be ignored, so reaping right away waits only for the kernel to tear the process down
+        this->kill();
+        ::waitpid(pid_, nullptr, 0);
+    }
 }
 
 void CgiProcess::spawn()
@@ -63,9 +77,26 @@ void CgiProcess::spawn()
     }
     // NOLINTEND
     CgiEnvironment cgiEnv(uri, request_);
+
+    // Everything the child needs is prepared before fork(): with several reactor threads another thread may hold
+    // the allocator or log locks at the moment of the fork, so the child must not allocate or log.
+    std::string fullPath = uri.getFullPath();
+    char *args[3] = {nullptr, nullptr, nullptr}; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    if (!cgiPath.empty())
+    {
+        args[0] = const_cast<char *>(cgiPath.c_str());  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        args[1] = const_cast<char *>(fullPath.c_str()); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+    else
+    {
+        args[0] = const_cast<char *>(fullPath.c_str()); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+    char **envp = cgiEnv.toEnvp();
+
     pid_ = fork();
     if (pid_ < 0)
     {
+        freeEnvp(envp);
         close(pipeStdin[0]);
         close(pipeStdin[1]);
         close(pipeStdout[0]);
@@ -89,26 +120,16 @@ void CgiProcess::spawn()
         dup2(pipeStdout[1], STDOUT_FILENO);
         dup2(pipeStderr[1], STDERR_FILENO);
 
-        Log::clearChannels();
+        // Drop every inherited descriptor (log file, other clients) without touching the logger
+        close_range(STDERR_FILENO + 1, ~0U, 0);
 
-        // Prepare arguments
-        std::string fullPath = uri.getFullPath();
-        char *args[3] = {nullptr, nullptr, nullptr}; // NOLINT(cppcoreguidelines-avoid-c-arrays)
-        if (!cgiPath.empty())
-        {
-            args[0] = const_cast<char *>(cgiPath.c_str());  // NOLINT(cppcoreguidelines-pro-type-const-cast)
-            args[1] = const_cast<char *>(fullPath.c_str()); // NOLINT(cppcoreguidelines-pro-type-const-cast)
-        }
-        else
-        {
-            args[0] = const_cast<char *>(fullPath.c_str()); // NOLINT(cppcoreguidelines-pro-type-const-cast)
-        }
-        execve(args[0], args, cgiEnv.toEnvp()); // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
-        exit(1);
+        execve(args[0], args, envp); // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+        _exit(1);
     }
     else
     {
         // Parent process
+        freeEnvp(envp);
         auto cgiStdIn = std::make_unique<CgiSocket>(pipeStdin[1], ASocket::IoState::WRITE, "stdin");
         auto cgiStdOut = std::make_unique<CgiSocket>(pipeStdout[0], ASocket::IoState::READ, "stdout");
         auto cgiStdErr = std::make_unique<CgiSocket>(pipeStderr[0], ASocket::IoState::READ, "stderr");
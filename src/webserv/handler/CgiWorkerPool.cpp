@@ -0,0 +1,374 @@
+#include <webserv/handler/CgiWorkerPool.hpp>
+
+#include <webserv/config/AConfig.hpp>        // for AConfig
+#include <webserv/log/Log.hpp>               // for Log, LOCATION
+#include <webserv/main.hpp>                  // for CGI_POOL_MIN, CGI_POOL_MAX, CGI_POOL_REQUESTS, CGI_POOL_FAILURES
+#include <webserv/socket/ASocket.hpp>        // for ASocket
+#include <webserv/socket/TimerSocket.hpp>    // for TimerSocket
+#include <webserv/socket/UpstreamSocket.hpp> // for UpstreamSocket
+
+#include <algorithm>  // for any_of, find_if, max_element, min
+#include <atomic>     // for atomic
+#include <cerrno>     // for errno
+#include <csignal>    // for kill, SIGKILL
+#include <cstddef>    // for offsetof
+#include <cstring>    // for memcpy, strerror
+#include <exception>  // for exception
+#include <functional> // for function
+#include <stdexcept>  // for runtime_error
+#include <string>     // for basic_string, operator+, string, to_string
+#include <utility>    // for move
+#include <vector>     // for vector, erase_if
+
+#include <fcntl.h>      // for open, O_WRONLY
+#include <sys/socket.h> // for socket, bind, listen, AF_UNIX, SOCK_STREAM, SOCK_CLOEXEC
+#include <sys/un.h>     // for sockaddr_un
+#include <sys/wait.h>   // for waitpid, WIFSIGNALED, WTERMSIG
+#include <unistd.h>     // for close, close_range, dup2, execve, fork, getpid, _exit, STDIN_FILENO, STDOUT_FILENO
+
+// Names of the worker sockets are unique across the reactors of a process
+static std::atomic<size_t> workerSequence{0};
+
+/**
+ * Creates a listening socket bound to name in the abstract namespace, which needs no file and disappears with its
+ * last descriptor.
+ */
+static inline int listenAbstract(const std::string &name)
+{
+    struct sockaddr_un address{};
+    if (name.size() + 1 > sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(static_cast<char *>(address.sun_path) + 1, name.data(), name.size());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+    {
+        return -1;
+    }
+    auto length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + 1 + name.size());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&address), length) == -1 || listen(fd, SOMAXCONN) == -1)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+CgiWorkerPool::CgiWorkerPool(TimerWheel &timers)
+    : reaper_(std::make_unique<TimerSocket>(timers, std::chrono::milliseconds(Constants::CGI_POOL_REAP_MS)))
+{
+    Log::trace(LOCATION);
+    reaper_->setCallback([this]() { reap(); });
+}
+
+CgiWorkerPool::~CgiWorkerPool()
+{
+    Log::trace(LOCATION);
+    for (auto &[key, group] : groups_)
+    {
+        for (Worker &worker : group.workers)
+        {
+            stop(worker);
+        }
+    }
+}
+
+/**
+ * Returns the connection to an idle worker for interpreter in the location of config, starting a new worker when all
+ * are busy and the group is below cgi_pool_max. Returns nullptr when the request has to wait(). Throws when a worker
+ * cannot be started.
+ */
+std::unique_ptr<UpstreamSocket> CgiWorkerPool::acquire(const AConfig &config, const std::string &interpreter)
+{
+    Log::trace(LOCATION);
+    Group &group = getGroup(config, interpreter);
+    std::erase_if(group.workers, [this, &group](Worker &worker) {
+        if (worker.connection == nullptr || worker.connection->isAlive())
+        {
+            return false;
+        }
+        Log::warning("CGI worker with PID " + std::to_string(worker.pid) + " exited while idle");
+        retire(group, worker);
+        return true;
+    });
+    // The most recently used worker goes first, so the others can reach the idle timeout when the load drops
+    auto idle = std::max_element(group.workers.begin(), group.workers.end(), [](const Worker &lhs, const Worker &rhs) {
+        return (lhs.connection == nullptr ? 0 : 1) < (rhs.connection == nullptr ? 0 : 1)
+               || ((lhs.connection == nullptr) == (rhs.connection == nullptr) && lhs.idleSince < rhs.idleSince);
+    });
+    if (idle != group.workers.end() && idle->connection != nullptr)
+    {
+        Log::debug("Reusing CGI worker with PID " + std::to_string(idle->pid));
+        return std::move(idle->connection);
+    }
+    if (group.workers.size() >= group.max)
+    {
+        return nullptr;
+    }
+    spawn(group);
+    return std::move(group.workers.back().connection);
+}
+
+/**
+ * Takes back the connection of a worker once its request is over. The worker serves the next request when reusable
+ * is set and it has not reached cgi_pool_requests, otherwise it is stopped and replaced as far as cgi_pool_min asks.
+ * The connection must have been unregistered already.
+ */
+void CgiWorkerPool::release(std::unique_ptr<UpstreamSocket> connection, bool reusable)
+{
+    Log::trace(LOCATION);
+    for (auto &[key, group] : groups_)
+    {
+        auto worker = std::find_if(group.workers.begin(), group.workers.end(), [&connection](const Worker &worker) {
+            return worker.address == connection->getAddress();
+        });
+        if (worker == group.workers.end())
+        {
+            continue;
+        }
+        if (reusable && connection->getRequestCount() > 0)
+        {
+            group.failures = 0;
+        }
+        if (reusable && connection->getRequestCount() < group.requests)
+        {
+            connection->setIOState(ASocket::IoState::WRITE);
+            worker->connection = std::move(connection);
+            worker->idleSince = std::chrono::steady_clock::now();
+        }
+        else
+        {
+            Log::debug("Recycling CGI worker with PID " + std::to_string(worker->pid) + " after "
+                       + std::to_string(connection->getRequestCount()) + " requests");
+            worker->connection = std::move(connection);
+            retire(group, *worker);
+            group.workers.erase(worker);
+            fill(group);
+        }
+        wake(group);
+        return;
+    }
+}
+
+/**
+ * Queues callback until a worker for interpreter in the location of config is free, or a new one may be started. The
+ * callback runs once; the returned ticket cancels it.
+ */
+size_t CgiWorkerPool::wait(const AConfig &config, const std::string &interpreter, std::function<void()> callback)
+{
+    Log::trace(LOCATION);
+    Group &group = getGroup(config, interpreter);
+    group.waiters.push_back({.ticket = ++nextTicket_, .callback = std::move(callback)});
+    Log::debug("All CGI workers for " + interpreter + " are busy, " + std::to_string(group.waiters.size())
+               + " requests waiting");
+    return nextTicket_;
+}
+
+void CgiWorkerPool::cancel(size_t ticket) noexcept
+{
+    for (auto &[key, group] : groups_)
+    {
+        std::erase_if(group.waiters, [ticket](const Waiter &waiter) { return waiter.ticket == ticket; });
+    }
+}
+
+/**
+ * Returns the group of config and interpreter, reading its limits from config and starting its cgi_pool_min workers
+ * when it is used for the first time.
+ */
+CgiWorkerPool::Group &CgiWorkerPool::getGroup(const AConfig &config, const std::string &interpreter)
+{
+    auto [it, created] = groups_.try_emplace(GroupKey{&config, interpreter});
+    Group &group = it->second;
+    if (!created)
+    {
+        return group;
+    }
+    group.interpreter = interpreter;
+    group.max = static_cast<size_t>(config.get<int>("cgi_pool_max").value_or(CGI_POOL_MAX));
+    group.min = std::min(static_cast<size_t>(config.get<int>("cgi_pool_min").value_or(CGI_POOL_MIN)), group.max);
+    group.requests = static_cast<size_t>(config.get<int>("cgi_pool_requests").value_or(CGI_POOL_REQUESTS));
+    group.idleTimeout = std::chrono::seconds(config.get<int>("cgi_pool_idle_timeout").value_or(CGI_POOL_IDLE_TIMEOUT));
+    Log::info("Starting CGI worker pool for " + interpreter + " with " + std::to_string(group.min) + " to "
+              + std::to_string(group.max) + " workers");
+    fill(group);
+    if (!reaper_->isActive())
+    {
+        reaper_->activate();
+    }
+    return group;
+}
+
+/**
+ * Starts a worker for the group and connects to it. Throws when the socket, the process or the connection fails, or
+ * while the group backs off after its workers kept exiting at startup.
+ */
+void CgiWorkerPool::spawn(Group &group)
+{
+    Log::trace(LOCATION);
+    if (std::chrono::steady_clock::now() < group.retryAfter)
+    {
+        throw std::runtime_error("CGI workers for " + group.interpreter + " keep exiting at startup");
+    }
+    std::string name = "webserv-cgi-" + std::to_string(getpid()) + "-" + std::to_string(++workerSequence);
+    int listener = listenAbstract(name);
+    if (listener == -1)
+    {
+        Log::error("CGI worker socket creation failed: " + std::string(strerror(errno)));
+        throw std::runtime_error("CGI worker socket creation failed");
+    }
+
+    // As for CgiProcess, everything the child needs is prepared before fork()
+    std::string maxRequests = "PHP_FCGI_MAX_REQUESTS=" + std::to_string(group.requests);
+    char *args[2] = {const_cast<char *>(group.interpreter.c_str()), nullptr}; // NOLINT
+    char *envp[2] = {maxRequests.data(), nullptr};                           // NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+    int pid = fork();
+    if (pid < 0)
+    {
+        close(listener);
+        Log::error("CGI worker fork failed: " + std::string(strerror(errno)));
+        throw std::runtime_error("CGI worker fork failed");
+    }
+    if (pid == 0)
+    {
+        dup2(listener, STDIN_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        close_range(STDERR_FILENO + 1, ~0U, 0);
+        execve(args[0], args, envp); // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+        _exit(1);
+    }
+    close(listener);
+    Worker worker{.pid = pid, .address = "unix:@" + name, .connection = nullptr, .idleSince = {}};
+    try
+    {
+        worker.connection = UpstreamSocket::connect(worker.address);
+    }
+    catch (const std::exception &)
+    {
+        retire(group, worker);
+        throw;
+    }
+    worker.idleSince = std::chrono::steady_clock::now();
+    Log::debug("CGI worker for " + group.interpreter + " started with PID " + std::to_string(pid));
+    group.workers.push_back(std::move(worker));
+}
+
+/**
+ * Starts workers until the group has cgi_pool_min of them.
+ */
+void CgiWorkerPool::fill(Group &group)
+{
+    while (group.workers.size() < group.min)
+    {
+        try
+        {
+            spawn(group);
+        }
+        catch (const std::exception &e)
+        {
+            // spawn() logged the cause already, a group that backs off is not worth a line every reap
+            Log::debug("Cannot start CGI worker for " + group.interpreter + ": " + e.what());
+            return;
+        }
+    }
+}
+
+/**
+ * Hands free workers to the requests that waited longest.
+ */
+void CgiWorkerPool::wake(Group &group)
+{
+    while (!group.waiters.empty() && hasCapacity(group))
+    {
+        std::function<void()> callback = std::move(group.waiters.front().callback);
+        group.waiters.pop_front();
+        callback();
+    }
+}
+
+/**
+ * Stops workers idle for longer than cgi_pool_idle_timeout, and idle workers that exited, then brings the groups back
+ * to cgi_pool_min.
+ */
+void CgiWorkerPool::reap()
+{
+    Log::trace(LOCATION);
+    auto now = std::chrono::steady_clock::now();
+    for (auto &[key, group] : groups_)
+    {
+        size_t count = group.workers.size();
+        std::erase_if(group.workers, [&](Worker &worker) {
+            if (worker.connection == nullptr)
+            {
+                return false;
+            }
+            bool alive = worker.connection->isAlive();
+            if (alive && (count <= group.min || now - worker.idleSince < group.idleTimeout))
+            {
+                return false;
+            }
+            Log::debug("Stopping " + std::string(alive ? "idle" : "exited") + " CGI worker with PID "
+                       + std::to_string(worker.pid));
+            retire(group, worker);
+            --count;
+            return true;
+        });
+        fill(group);
+        wake(group);
+    }
+    reaper_->activate();
+}
+
+/**
+ * Stops a worker that is leaving the group. One that exited by itself before serving a request counts as a startup
+ * failure; after Constants::CGI_POOL_FAILURES of them in a row the group starts no workers for a while, twice as long
+ * each time up to Constants::CGI_POOL_BACKOFF_MAX_S seconds, so a broken interpreter is not forked for every request.
+ */
+void CgiWorkerPool::retire(Group &group, Worker &worker)
+{
+    bool served = worker.connection != nullptr && worker.connection->getRequestCount() > 0;
+    int status = stop(worker);
+    if (served || (WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL))
+    {
+        return;
+    }
+    ++group.failures;
+    if (group.failures < Constants::CGI_POOL_FAILURES)
+    {
+        return;
+    }
+    size_t shift = std::min<size_t>(group.failures - Constants::CGI_POOL_FAILURES, 6);
+    std::chrono::seconds delay(std::min<size_t>(size_t{1} << shift, Constants::CGI_POOL_BACKOFF_MAX_S));
+    group.retryAfter = std::chrono::steady_clock::now() + delay;
+    Log::error("CGI workers for " + group.interpreter + " exited at startup " + std::to_string(group.failures)
+               + " times in a row; starting none for " + std::to_string(delay.count()) + "s");
+}
+
+bool CgiWorkerPool::hasCapacity(const Group &group) noexcept
+{
+    return group.workers.size() < group.max
+           || std::any_of(group.workers.begin(), group.workers.end(),
+                          [](const Worker &worker) { return worker.connection != nullptr; });
+}
+
+/**
+ * Ends the worker the way CgiProcess ends a script: it is killed and waited for, so it does not linger as a zombie.
+ * Returns its wait status, which tells a worker that had exited already from one ended here.
+ */
+int CgiWorkerPool::stop(Worker &worker) noexcept
+{
+    worker.connection.reset();
+    int status = 0;
+    if (worker.pid > 0)
+    {
+        ::kill(worker.pid, SIGKILL);
+        ::waitpid(worker.pid, &status, 0);
+        worker.pid = -1;
+    }
+    return status;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <webserv/socket/TimerSocket.hpp>    // for TimerSocket
+#include <webserv/socket/UpstreamSocket.hpp> // for UpstreamSocket
+
+#include <chrono>     // for seconds, steady_clock
+#include <cstddef>    // for size_t
+#include <deque>      // for deque
+#include <functional> // for function
+#include <map>        // for map
+#include <memory>     // for unique_ptr
+#include <string>     // for string
+#include <utility>    // for pair
+#include <vector>     // for vector
+
+class AConfig;
+class TimerWheel;
+
+/**
+ * Interpreter processes kept running between requests for locations with cgi_pool fastcgi, one pool per reactor. A
+ * worker is started the way spawn-fcgi starts one: with a listening Unix socket as stdin, which makes interpreters like
+ * php-cgi serve FastCGI on it. The directive states that the interpreters of the location do so; ones that only speak
+ * CGI, such as python3, cannot be pooled, and their scripts run in a process of their own. Each location and interpreter has its own group of cgi_pool_min to
+ * cgi_pool_max workers; a worker is replaced after cgi_pool_requests requests, and one idle for cgi_pool_idle_timeout
+ * seconds is stopped as long as the group stays at its minimum. Requests that find every worker busy wait in line for
+ * the next one. A group whose workers keep exiting at startup stops starting them for a while.
+ */
+class CgiWorkerPool
+{
+  public:
+    explicit CgiWorkerPool(TimerWheel &timers);
+
+    CgiWorkerPool(const CgiWorkerPool &other) = delete;
+    CgiWorkerPool &operator=(const CgiWorkerPool &other) = delete;
+    CgiWorkerPool(CgiWorkerPool &&other) noexcept = delete;
+    CgiWorkerPool &operator=(CgiWorkerPool &&other) noexcept = delete;
+
+    ~CgiWorkerPool();
+
+    [[nodiscard]] std::unique_ptr<UpstreamSocket> acquire(const AConfig &config, const std::string &interpreter);
+    void release(std::unique_ptr<UpstreamSocket> connection, bool reusable);
+    [[nodiscard]] size_t wait(const AConfig &config, const std::string &interpreter, std::function<void()> callback);
+    void cancel(size_t ticket) noexcept;
+
+  private:
+    struct Worker
+    {
+        int pid = -1;
+        std::string address;
+        // Held while the worker is idle; the handler serving a request on it has it otherwise
+        std::unique_ptr<UpstreamSocket> connection;
+        std::chrono::steady_clock::time_point idleSince;
+    };
+
+    struct Waiter
+    {
+        size_t ticket;
+        std::function<void()> callback;
+    };
+
+    struct Group
+    {
+        std::string interpreter;
+        size_t min = 0;
+        size_t max = 0;
+        size_t requests = 0;
+        std::chrono::seconds idleTimeout{0};
+        std::vector<Worker> workers;
+        std::deque<Waiter> waiters;
+        // Workers in a row that exited before serving a request, and when the next may be started after that
+        size_t failures = 0;
+        std::chrono::steady_clock::time_point retryAfter;
+    };
+
+    using GroupKey = std::pair<const AConfig *, std::string>;
+
+    std::map<GroupKey, Group> groups_;
+    std::unique_ptr<TimerSocket> reaper_;
+    size_t nextTicket_ = 0;
+
+    Group &getGroup(const AConfig &config, const std::string &interpreter);
+    void spawn(Group &group);
+    void fill(Group &group);
+    void wake(Group &group);
+    void reap();
+    void retire(Group &group, Worker &worker);
+
+    [[nodiscard]] static bool hasCapacity(const Group &group) noexcept;
+    static int stop(Worker &worker) noexcept;
+};
@@ -6,6 +6,7 @@
 #include <webserv/http/HttpResponse.hpp>    // for HttpResponse
 #include <webserv/log/Log.hpp>              // for Log, LOCATION
 #include <webserv/utils/FileUtils.hpp>      // for isDirectory, isFile, isValidPath
+#include <webserv/utils/OpenFileCache.hpp>  // for OpenFileCache
 
 #include <stdio.h>  // for remove
 #include <unistd.h> // for rmdir
@@ -54,6 +55,7 @@ void DeleteHandler::deleteFile(const std::string &path)
     else
     {
         Log::info("DeleteHandler: Successfully deleted file: " + path);
+        OpenFileCache::get().invalidate(path);
         response_.setStatus(Http::StatusCode::NO_CONTENT);
         response_.setComplete();
     }
@@ -72,6 +74,7 @@ void DeleteHandler::deleteDirectory(const std::string &path)
     else
     {
         Log::info("DeleteHandler: Successfully deleted empty directory: " + path);
+        OpenFileCache::get().invalidate(path);
         response_.setStatus(Http::StatusCode::NO_CONTENT);
         response_.setComplete();
     }
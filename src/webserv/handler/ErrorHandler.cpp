@@ -6,11 +6,10 @@
 #include <webserv/http/HttpConstants.hpp>   // for getStatusCodeReason, INTERNAL_SERVER_ERROR, METHOD_NOT_ALLOWED
 #include <webserv/http/HttpResponse.hpp>    // for HttpResponse
 #include <webserv/log/Log.hpp>              // for Log, LOCATION
+#include <webserv/utils/HotFileCache.hpp>   // for HotFileCache
 #include <webserv/utils/utils.hpp>          // for implode
 
-#include <fstream>  // for basic_ifstream, basic_filebuf, basic_ostream::operator<<, ifstream, stringstream
 #include <optional> // for optional
-#include <sstream>  // for basic_stringstream
 #include <string>   // for basic_string, allocator, char_traits, operator+, string, to_string
 #include <vector>   // for vector
 
@@ -20,14 +19,13 @@ void ErrorHandler::createErrorResponse(uint16_t statusCode, HttpResponse &respon
     Log::debug("Generating error response: " + std::to_string(statusCode) + " " + statusMessage);
 
     response.setStatus(statusCode);
-    response.addHeader("Content-Type", "text/html");
-    response.addHeader("Connection", "close");
+    response.addHeader(HttpHeaders::Field::ContentType, "text/html");
     if (statusCode == Http::StatusCode::METHOD_NOT_ALLOWED && config != nullptr)
     {
         auto allowedMethods = config->get<std::vector<std::string>>("allowed_methods");
         if (allowedMethods.has_value())
         {
-            response.addHeader("Allow", utils::implode(allowedMethods.value(), ", "));
+            response.addHeader(HttpHeaders::Field::Allow, utils::implode(allowedMethods.value(), ", "));
         }
     }
     response.appendBody(generateErrorPage(statusCode, config));
@@ -68,13 +66,11 @@ std::string ErrorHandler::generateDefaultErrorPage(uint16_t statusCode)
 std::string ErrorHandler::getErrorPageFile(const std::string &path)
 {
     Log::debug("Loading custom error page from: " + path);
-    std::ifstream file(path.c_str());
-    if (!file.is_open())
+    auto page = HotFileCache::get().loadFile(path);
+    if (page == nullptr)
     {
         Log::error("Could not open custom error page: " + path);
         return generateDefaultErrorPage(Http::StatusCode::INTERNAL_SERVER_ERROR);
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    return {page->begin(), page->end()};
 }
\ No newline at end of file
@@ -0,0 +1,492 @@
+#include <webserv/handler/FastCgiHandler.hpp>
+
+#include <webserv/client/Client.hpp>         // for Client
+#include <webserv/config/AConfig.hpp>        // for AConfig
+#include <webserv/handler/CgiEnvironment.hpp> // for CgiEnvironment
+#include <webserv/handler/CgiOutput.hpp>      // for CgiOutput
+#include <webserv/handler/CgiWorkerPool.hpp>  // for CgiWorkerPool
+#include <webserv/handler/ErrorHandler.hpp>   // for ErrorHandler
+#include <webserv/handler/FastCgiRecord.hpp>  // for FastCgiRecord
+#include <webserv/handler/URI.hpp>            // for URI
+#include <webserv/http/HttpConstants.hpp>     // for BAD_GATEWAY, GATEWAY_TIMEOUT
+#include <webserv/http/HttpRequest.hpp>       // for HttpRequest
+#include <webserv/http/HttpResponse.hpp>      // for HttpResponse
+#include <webserv/http/RequestBody.hpp>       // for RequestBody
+#include <webserv/log/Log.hpp>                // for Log, LOCATION
+#include <webserv/main.hpp>                   // for CHUNK_SIZE, CGI_TIMEOUT
+#include <webserv/server/Server.hpp>          // for Server
+#include <webserv/socket/ASocket.hpp>         // for ASocket
+#include <webserv/socket/ClientSocket.hpp>    // for ClientSocket
+#include <webserv/socket/TimerSocket.hpp>     // for TimerSocket
+#include <webserv/socket/UpstreamPool.hpp>    // for UpstreamPool
+#include <webserv/socket/UpstreamSocket.hpp>  // for UpstreamSocket
+
+#include <array>       // for array
+#include <cerrno>      // for errno, EAGAIN, EWOULDBLOCK
+#include <chrono>      // for operator*, milliseconds
+#include <cstring>     // for strerror
+#include <exception>   // for exception
+#include <functional>  // for function
+#include <string>      // for basic_string, operator+, string, to_string
+#include <string_view> // for string_view
+#include <utility>     // for move
+
+#include <sys/types.h> // for ssize_t
+
+static constexpr uint16_t FCGI_RESPONDER = 1;
+static constexpr uint8_t FCGI_KEEP_CONN = 1;
+static constexpr uint8_t FCGI_REQUEST_COMPLETE = 0;
+// Size of the BEGIN_REQUEST and END_REQUEST record bodies
+static constexpr size_t FCGI_REQUEST_BODY_SIZE = 8;
+
+FastCgiHandler::FastCgiHandler(const HttpRequest &request, HttpResponse &response)
+    : AHandler(request, response), output_(request, response, [this]() { resume(); })
+{
+    if (!request.getUri().getConfig()->get<std::string>("fastcgi_pass").has_value())
+    {
+        interpreter_ = request.getUri().getCgiPath();
+    }
+    Log::debug("FastCgiHandler constructed");
+}
+
+/**
+ * A worker whose request was cut short is in an unknown state, so it goes back to the pool to be replaced. The
+ * client has unregistered the connection already.
+ */
+FastCgiHandler::~FastCgiHandler()
+{
+    if (interpreter_.empty())
+    {
+        return;
+    }
+    CgiWorkerPool &workers = request_.getClient().getServer().getCgiWorkerPool();
+    if (ticket_ != 0)
+    {
+        workers.cancel(ticket_);
+    }
+    if (upstream_ != nullptr)
+    {
+        workers.release(std::move(upstream_), false);
+    }
+}
+
+void FastCgiHandler::handle()
+{
+    Log::debug("FastCgiHandler handling request");
+    if (!connect(true))
+    {
+        ErrorHandler::createErrorResponse(Http::StatusCode::BAD_GATEWAY, response_);
+    }
+}
+
+void FastCgiHandler::startTimer()
+{
+    timerSocket_ = std::make_unique<TimerSocket>(
+        request_.getClient().getServer().getTimerWheel(),
+        std::chrono::milliseconds(request_.getUri().getConfig()->get<int>("cgi_timeout").value_or(CGI_TIMEOUT)) * 1000);
+
+    timerSocket_->setCallback([this]() { handleTimeout(); });
+    timerSocket_->activate();
+    Log::debug("Timer started for handler: " + timerSocket_->toString());
+}
+
+/**
+ * Like cgi_timeout for a CGI script, the timeout only expires when neither the backend nor the client made progress.
+ */
+void FastCgiHandler::handleTimeout()
+{
+    Log::warning(request_.getClient().getClientSocket()->toString() + ": FastCGI request timed out");
+    fail(Http::StatusCode::GATEWAY_TIMEOUT);
+}
+
+void FastCgiHandler::resetTimer()
+{
+    if (timerSocket_ != nullptr)
+    {
+        timerSocket_->activate();
+    }
+}
+
+/**
+ * Takes a connection to the backend, from the pool when reuse is set, and queues the request on it. A CGI worker
+ * always comes from the worker pool; when all are busy the request waits there and connects once one is free.
+ * Returns false when no connection could be attempted.
+ */
+bool FastCgiHandler::connect(bool reuse)
+{
+    Log::trace(LOCATION);
+    Server &server = request_.getClient().getServer();
+    const AConfig &config = *request_.getUri().getConfig();
+    try
+    {
+        if (!interpreter_.empty())
+        {
+            upstream_ = server.getCgiWorkerPool().acquire(config, interpreter_);
+            if (upstream_ == nullptr)
+            {
+                ticket_ = server.getCgiWorkerPool().wait(config, interpreter_, [this]() {
+                    ticket_ = 0;
+                    if (!connect(true))
+                    {
+                        fail(Http::StatusCode::BAD_GATEWAY);
+                    }
+                });
+                return true;
+            }
+        }
+        else
+        {
+            std::string address = config.get<std::string>("fastcgi_pass").value_or("");
+            upstream_ = reuse ? server.getUpstreamPool().acquire(address) : UpstreamSocket::connect(address);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        // The cause was logged where it happened, or once for a CGI worker group that backs off
+        Log::debug("FastCGI connection failed: " + std::string(e.what()));
+        return false;
+    }
+    reused_ = upstream_->getRequestCount() > 0;
+    written_ = false;
+    sendBuffer_.clear();
+    sendOffset_ = 0;
+    bodyOffset_ = 0;
+    stdInSent_ = false;
+    record_.reset();
+    endRecord_.clear();
+    beginRequest();
+    upstream_->setCallback([this]() { handleEvent(); });
+    request_.getClient().addSocket(upstream_.get());
+    Log::info(request_.getClient().getClientSocket()->toString() + ": FastCGI request to " + upstream_->toString());
+    return true;
+}
+
+/**
+ * Queues BEGIN_REQUEST and the CGI environment as PARAMS. The body follows as STDIN records from fillSendBuffer().
+ */
+void FastCgiHandler::beginRequest()
+{
+    Log::trace(LOCATION);
+    std::string begin(FCGI_REQUEST_BODY_SIZE, '\0');
+    begin[0] = static_cast<char>(FCGI_RESPONDER >> 8U);
+    begin[1] = static_cast<char>(FCGI_RESPONDER & 0xFFU);
+    begin[2] = static_cast<char>(FCGI_KEEP_CONN);
+    FastCgiRecord::append(sendBuffer_, FastCgiRecord::Type::BeginRequest, begin);
+
+    CgiEnvironment environment(request_.getUri(), request_);
+    std::string params;
+    for (const auto &[name, value] : environment.getAll())
+    {
+        FastCgiRecord::appendParam(params, name, value);
+    }
+    // A pair may be split over records
+    for (size_t offset = 0; offset < params.size(); offset += FastCgiRecord::MAX_CONTENT)
+    {
+        FastCgiRecord::append(sendBuffer_, FastCgiRecord::Type::Params,
+                              std::string_view(params).substr(offset, FastCgiRecord::MAX_CONTENT));
+    }
+    FastCgiRecord::append(sendBuffer_, FastCgiRecord::Type::Params, {});
+}
+
+/**
+ * Queues the next piece of the body once everything before it was sent, ending with the empty STDIN record. A
+ * spooled body is read back one chunk at a time, so sending it never needs more memory than that.
+ */
+void FastCgiHandler::fillSendBuffer()
+{
+    sendBuffer_.clear();
+    sendOffset_ = 0;
+    if (stdInSent_)
+    {
+        return;
+    }
+    const RequestBody &body = request_.getBody();
+    if (bodyOffset_ < body.size())
+    {
+        std::array<char, Constants::CHUNK_SIZE> scratch; // NOLINT(cppcoreguidelines-pro-type-member-init)
+        std::string_view chunk = body.read(bodyOffset_, scratch).substr(0, FastCgiRecord::MAX_CONTENT);
+        FastCgiRecord::append(sendBuffer_, FastCgiRecord::Type::Stdin, chunk);
+        bodyOffset_ += chunk.size();
+        return;
+    }
+    FastCgiRecord::append(sendBuffer_, FastCgiRecord::Type::Stdin, {});
+    stdInSent_ = true;
+}
+
+void FastCgiHandler::handleEvent()
+{
+    Log::trace(LOCATION);
+    if (upstream_ == nullptr)
+    {
+        return;
+    }
+    if (!upstream_->isConnected())
+    {
+        int error = upstream_->finishConnect();
+        if (error != 0)
+        {
+            Log::error(upstream_->toString() + ": connect failed: " + std::string(strerror(error)));
+            fail(Http::StatusCode::BAD_GATEWAY);
+            return;
+        }
+        Log::debug(upstream_->toString() + ": connected");
+    }
+    // The event does not say which way the socket is ready, but both calls return at once when it is not
+    ASocket::IoState interest = upstream_->getEvent();
+    if (interest != ASocket::IoState::READ)
+    {
+        write();
+    }
+    if (upstream_ != nullptr && interest != ASocket::IoState::WRITE)
+    {
+        read();
+    }
+}
+
+/**
+ * Sends the request. After the first write the response is read while the body is still being sent: a backend may
+ * answer before it has read all of the body, or stop reading it until its output was taken. Once the empty STDIN record
+ * is out the socket only waits to read. A write that fails may be to a backend that ended the request early and
+ * closed the connection, so the socket then only waits to read what it sent.
+ */
+void FastCgiHandler::write()
+{
+    Log::trace(LOCATION);
+    if (sendOffset_ == sendBuffer_.size())
+    {
+        fillSendBuffer();
+    }
+    if (!sendBuffer_.empty())
+    {
+        ssize_t bytesWritten = upstream_->write(sendBuffer_.data() + sendOffset_, sendBuffer_.size() - sendOffset_);
+        if (bytesWritten < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return;
+            }
+            Log::warning(upstream_->toString() + ": write failed: " + std::string(strerror(errno)));
+            upstream_->setIOState(ASocket::IoState::READ);
+            return;
+        }
+        sendOffset_ += static_cast<size_t>(bytesWritten);
+        written_ = true;
+        resetTimer();
+        upstream_->setIOState(ASocket::IoState::READ_WRITE);
+        if (sendOffset_ < sendBuffer_.size())
+        {
+            return;
+        }
+        fillSendBuffer();
+    }
+    if (sendBuffer_.empty())
+    {
+        Log::debug(upstream_->toString() + ": request sent, waiting for the response");
+        upstream_->setIOState(ASocket::IoState::READ);
+    }
+}
+
+/**
+ * Reads the response records. Reading pauses while the client has not sent what came before, so a slow client holds
+ * the backend back rather than the output piling up in memory.
+ */
+void FastCgiHandler::read()
+{
+    Log::trace(LOCATION);
+    std::array<char, Constants::CHUNK_SIZE> buffer; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    ssize_t bytesRead = upstream_->read(buffer.data(), buffer.size());
+    if (bytesRead > 0)
+    {
+        received_ = true;
+        resetTimer();
+        receive(std::string_view(buffer.data(), static_cast<size_t>(bytesRead)));
+        if (upstream_ != nullptr && output_.isBackedUp() && !paused_)
+        {
+            Log::debug("FastCGI output waits for the client; pausing reads");
+            request_.getClient().removeSocket(upstream_.get());
+            paused_ = true;
+        }
+        return;
+    }
+    if (bytesRead == 0)
+    {
+        Log::warning(upstream_->toString() + ": backend closed the connection before ending the request");
+        retryOrFail();
+        return;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+        return;
+    }
+    Log::error(upstream_->toString() + ": read failed: " + std::string(strerror(errno)));
+    retryOrFail();
+}
+
+/**
+ * Handles the records in data as they come, without waiting for the rest of a record.
+ */
+void FastCgiHandler::receive(std::string_view data)
+{
+    while (upstream_ != nullptr)
+    {
+        size_t consumed = 0;
+        std::string_view content;
+        FastCgiRecord::Result result = record_.decode(data, consumed, content);
+        data.remove_prefix(consumed);
+        switch (result)
+        {
+        case FastCgiRecord::Result::Content: handleContent(content); break;
+        case FastCgiRecord::Result::End:
+            if (record_.getType() == FastCgiRecord::Type::EndRequest)
+            {
+                endRequest(!data.empty());
+                return;
+            }
+            break;
+        case FastCgiRecord::Result::NeedMore: return;
+        case FastCgiRecord::Result::Error:
+            Log::error(upstream_->toString() + ": unsupported FastCGI version");
+            fail(Http::StatusCode::BAD_GATEWAY);
+            return;
+        }
+    }
+}
+
+void FastCgiHandler::handleContent(std::string_view content)
+{
+    switch (record_.getType())
+    {
+    // The response ends with END_REQUEST, which may follow a complete body; ending it earlier would let the client
+    // connection move on and take the backend connection down before it could go back to the pool
+    case FastCgiRecord::Type::Stdout: output_.write(content); break;
+    case FastCgiRecord::Type::Stderr: Log::error("FastCGI stderr output: " + std::string(content)); break;
+    case FastCgiRecord::Type::EndRequest: endRecord_ += content; break;
+    default: Log::debug("Ignoring FastCGI record of type " + std::to_string(static_cast<int>(record_.getType()))); break;
+    }
+}
+
+/**
+ * The backend is done with the request, which ends it even when not all of the body was sent; nothing more is sent
+ * then. The connection goes back to the pool unless the backend sent more than it should have, or the rest of the body
+ * would be taken for the next request.
+ */
+void FastCgiHandler::endRequest(bool trailing)
+{
+    Log::trace(LOCATION);
+    if (endRecord_.size() < FCGI_REQUEST_BODY_SIZE)
+    {
+        Log::error(upstream_->toString() + ": truncated END_REQUEST record");
+        fail(Http::StatusCode::BAD_GATEWAY);
+        return;
+    }
+    auto protocolStatus = static_cast<uint8_t>(endRecord_[4]);
+    if (protocolStatus != FCGI_REQUEST_COMPLETE)
+    {
+        Log::error(upstream_->toString() + ": backend rejected the request, protocol status "
+                   + std::to_string(protocolStatus));
+        fail(Http::StatusCode::BAD_GATEWAY);
+        return;
+    }
+    bool failed = endRecord_[0] != 0 || endRecord_[1] != 0 || endRecord_[2] != 0 || endRecord_[3] != 0;
+    output_.finish(failed);
+    upstream_->countRequest();
+    if (trailing)
+    {
+        Log::warning(upstream_->toString() + ": data after the end of the request");
+        releaseUpstream(false);
+        return;
+    }
+    if (!stdInSent_ || sendOffset_ < sendBuffer_.size())
+    {
+        Log::debug(upstream_->toString() + ": backend ended the request before the body was sent");
+        releaseUpstream(false);
+        return;
+    }
+    releaseUpstream(true);
+}
+
+/**
+ * A pooled connection the backend closed while idle fails on first use. As long as nothing was received the request
+ * is sent again on a new connection. Once part of it went out the backend may have acted on it already, so only a GET,
+ * HEAD or OPTIONS request is sent again then.
+ */
+void FastCgiHandler::retryOrFail()
+{
+    const std::string &method = request_.getMethod();
+    bool safe = method == "GET" || method == "HEAD" || method == "OPTIONS";
+    if (reused_ && !received_ && (!written_ || safe))
+    {
+        Log::debug(upstream_->toString() + ": idle connection was closed, retrying on a new one");
+        releaseUpstream(false);
+        if (connect(false))
+        {
+            return;
+        }
+    }
+    fail(Http::StatusCode::BAD_GATEWAY);
+}
+
+/**
+ * Gives up on the backend. A response whose head was sent already can only be cut short.
+ */
+void FastCgiHandler::fail(uint16_t statusCode)
+{
+    if (ticket_ != 0)
+    {
+        request_.getClient().getServer().getCgiWorkerPool().cancel(ticket_);
+        ticket_ = 0;
+    }
+    releaseUpstream(false);
+    if (output_.isStreaming())
+    {
+        output_.abort();
+        return;
+    }
+    if (!response_.isComplete())
+    {
+        ErrorHandler::createErrorResponse(statusCode, response_);
+    }
+}
+
+/**
+ * Gives up the connection, keeping it for the next request when reusable is set. A CGI worker goes back to the worker
+ * pool either way, which replaces it when its connection cannot be reused.
+ */
+void FastCgiHandler::releaseUpstream(bool reusable)
+{
+    if (upstream_ == nullptr)
+    {
+        return;
+    }
+    if (!paused_)
+    {
+        request_.getClient().removeSocket(upstream_.get());
+    }
+    paused_ = false;
+    Server &server = request_.getClient().getServer();
+    if (!interpreter_.empty())
+    {
+        server.getCgiWorkerPool().release(std::move(upstream_), reusable);
+    }
+    else if (reusable)
+    {
+        server.getUpstreamPool().release(std::move(upstream_));
+    }
+    else
+    {
+        upstream_.reset();
+    }
+}
+
+/**
+ * The client sent what was queued; like output from the backend it restarts the timeout.
+ */
+void FastCgiHandler::resume()
+{
+    resetTimer();
+    if (paused_ && upstream_ != nullptr)
+    {
+        request_.getClient().addSocket(upstream_.get());
+    }
+    paused_ = false;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <webserv/handler/AHandler.hpp>      // for AHandler
+#include <webserv/handler/CgiOutput.hpp>     // for CgiOutput
+#include <webserv/handler/FastCgiRecord.hpp> // for FastCgiRecord
+#include <webserv/socket/UpstreamSocket.hpp> // for UpstreamSocket
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint8_t, uint16_t
+#include <memory>      // for unique_ptr
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+class HttpRequest;
+class HttpResponse;
+
+/**
+ * Passes the request to a FastCGI application server, such as php-fpm, at the address in fastcgi_pass. The connection
+ * is taken from the upstream pool of the reactor and returned to it once the backend has ended the request, so it is
+ * reused by the next requests. In a cgi_pool location the backend is one of the interpreter processes of the CGI
+ * worker pool instead. The output is turned into the response by CgiOutput, as for a CGI script.
+ */
+class FastCgiHandler : public AHandler
+{
+  public:
+    FastCgiHandler(const HttpRequest &request, HttpResponse &response);
+
+    FastCgiHandler(const FastCgiHandler &other) = delete;
+    FastCgiHandler &operator=(const FastCgiHandler &other) = delete;
+    FastCgiHandler(FastCgiHandler &&other) noexcept = delete;
+    FastCgiHandler &operator=(FastCgiHandler &&other) noexcept = delete;
+
+    ~FastCgiHandler() override;
+
+    void handle() override;
+
+    void startTimer() override;
+
+  protected:
+    void handleTimeout() override;
+
+  private:
+    CgiOutput output_;
+    std::unique_ptr<UpstreamSocket> upstream_;
+    // Interpreter of the CGI workers serving the request, empty when it goes to fastcgi_pass
+    std::string interpreter_;
+    // Place in the queue of the worker pool while every worker is busy, 0 otherwise
+    size_t ticket_ = 0;
+    // Set when upstream_ came from the pool, the backend may have closed it in the meantime
+    bool reused_ = false;
+    // Set while upstream_ is unregistered because the client has not sent what was read yet
+    bool paused_ = false;
+    // Set once anything was read from the backend, after which the request cannot be retried
+    bool received_ = false;
+    // Set once anything was written to the connection, after which only a safe method may be retried
+    bool written_ = false;
+
+    std::vector<uint8_t> sendBuffer_;
+    size_t sendOffset_ = 0;
+    size_t bodyOffset_ = 0;
+    bool stdInSent_ = false;
+
+    // The record being received, and the content of END_REQUEST
+    FastCgiRecord record_;
+    std::string endRecord_;
+
+    [[nodiscard]] bool connect(bool reuse);
+    void beginRequest();
+    void fillSendBuffer();
+    void handleEvent();
+    void write();
+    void read();
+    void receive(std::string_view data);
+    void handleContent(std::string_view content);
+    void endRequest(bool trailing);
+    void retryOrFail();
+    void fail(uint16_t statusCode);
+    void releaseUpstream(bool reusable);
+    void resume();
+    void resetTimer();
+};
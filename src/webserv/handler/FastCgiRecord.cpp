@@ -0,0 +1,118 @@
+#include <webserv/handler/FastCgiRecord.hpp>
+
+#include <algorithm> // for min
+#include <cstdint>   // for uint8_t, uint16_t
+#include <cstring>   // for memcpy
+
+static constexpr uint8_t FCGI_VERSION = 1;
+// Every connection carries one request at a time, so they all use the same id
+static constexpr uint16_t FCGI_REQUEST_ID = 1;
+
+/**
+ * Decodes input up to the next piece of content or the end of a record, or as far as it goes. consumed is set to the
+ * number of bytes of input used, including those of content, which points into input. Bytes of a header cut short are
+ * kept, so the caller need not hold on to any input.
+ */
+FastCgiRecord::Result FastCgiRecord::decode(std::string_view input, size_t &consumed, std::string_view &content)
+{
+    consumed = 0;
+    if (headerSize_ < HEADER_SIZE)
+    {
+        consumed = std::min(HEADER_SIZE - headerSize_, input.size());
+        std::memcpy(header_.data() + headerSize_, input.data(), consumed);
+        headerSize_ += consumed;
+        if (headerSize_ < HEADER_SIZE)
+        {
+            return Result::NeedMore;
+        }
+        if (header_[0] != FCGI_VERSION)
+        {
+            return Result::Error;
+        }
+        type_ = static_cast<Type>(header_[1]);
+        contentRemaining_ = (static_cast<size_t>(header_[4]) << 8U) | header_[5];
+        paddingRemaining_ = header_[6];
+    }
+    std::string_view rest = input.substr(consumed);
+    if (contentRemaining_ > 0)
+    {
+        if (rest.empty())
+        {
+            return Result::NeedMore;
+        }
+        content = rest.substr(0, contentRemaining_);
+        consumed += content.size();
+        contentRemaining_ -= content.size();
+        return Result::Content;
+    }
+    size_t padding = std::min(paddingRemaining_, rest.size());
+    consumed += padding;
+    paddingRemaining_ -= padding;
+    if (paddingRemaining_ > 0)
+    {
+        return Result::NeedMore;
+    }
+    headerSize_ = 0;
+    return Result::End;
+}
+
+void FastCgiRecord::reset() noexcept
+{
+    headerSize_ = 0;
+    type_ = Type::Stdout;
+    contentRemaining_ = 0;
+    paddingRemaining_ = 0;
+}
+
+FastCgiRecord::Type FastCgiRecord::getType() const noexcept
+{
+    return type_;
+}
+
+/**
+ * Appends a record with content, which must not be longer than MAX_CONTENT, padded to a multiple of eight bytes as
+ * the specification recommends.
+ */
+void FastCgiRecord::append(std::vector<uint8_t> &out, Type type, std::string_view content)
+{
+    size_t padding = (8 - (content.size() % 8)) % 8;
+    std::array<uint8_t, HEADER_SIZE> header = {FCGI_VERSION,
+                                               static_cast<uint8_t>(type),
+                                               static_cast<uint8_t>(FCGI_REQUEST_ID >> 8U),
+                                               static_cast<uint8_t>(FCGI_REQUEST_ID & 0xFFU),
+                                               static_cast<uint8_t>(content.size() >> 8U),
+                                               static_cast<uint8_t>(content.size() & 0xFFU),
+                                               static_cast<uint8_t>(padding),
+                                               0};
+    out.insert(out.end(), header.begin(), header.end());
+    out.insert(out.end(), content.begin(), content.end());
+    out.insert(out.end(), padding, 0);
+}
+
+/**
+ * Appends the length of a name or value in a name-value pair: one byte below 128, otherwise four bytes with the high
+ * bit set.
+ */
+static inline void appendLength(std::string &out, size_t length)
+{
+    if (length < 128)
+    {
+        out.push_back(static_cast<char>(length));
+        return;
+    }
+    out.push_back(static_cast<char>(((length >> 24U) & 0x7FU) | 0x80U));
+    out.push_back(static_cast<char>((length >> 16U) & 0xFFU));
+    out.push_back(static_cast<char>((length >> 8U) & 0xFFU));
+    out.push_back(static_cast<char>(length & 0xFFU));
+}
+
+/**
+ * Appends a name-value pair for a PARAMS record.
+ */
+void FastCgiRecord::appendParam(std::string &out, std::string_view name, std::string_view value)
+{
+    appendLength(out, name.size());
+    appendLength(out, value.size());
+    out += name;
+    out += value;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>       // for array
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint8_t
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+/**
+ * Record framing of the FastCGI protocol (FastCGI 1.0, section 3.3). The static functions encode records; an instance
+ * splits the byte stream read from a backend back into records, which may arrive in any number of pieces. Content is
+ * handed out as it arrives, without waiting for the rest of its record, and padding is skipped.
+ */
+class FastCgiRecord
+{
+  public:
+    static constexpr size_t HEADER_SIZE = 8;
+    static constexpr size_t MAX_CONTENT = 65535;
+
+    enum class Type : uint8_t
+    {
+        BeginRequest = 1,
+        AbortRequest = 2,
+        EndRequest = 3,
+        Params = 4,
+        Stdin = 5,
+        Stdout = 6,
+        Stderr = 7
+    };
+
+    enum class Result : uint8_t
+    {
+        Content,  // content holds the next piece of the current record
+        End,      // The current record is through; getType() says which it was
+        NeedMore, // Everything consumed that could be
+        Error     // Not a FastCGI 1.0 record; the stream cannot be read any further
+    };
+
+    [[nodiscard]] Result decode(std::string_view input, size_t &consumed, std::string_view &content);
+    void reset() noexcept;
+
+    [[nodiscard]] Type getType() const noexcept;
+
+    static void append(std::vector<uint8_t> &out, Type type, std::string_view content);
+    static void appendParam(std::string &out, std::string_view name, std::string_view value);
+
+  private:
+    // The header of the record being received, complete once headerSize_ reaches HEADER_SIZE
+    std::array<uint8_t, HEADER_SIZE> header_{};
+    size_t headerSize_ = 0;
+    Type type_ = Type::Stdout;
+    size_t contentRemaining_ = 0;
+    size_t paddingRemaining_ = 0;
+};
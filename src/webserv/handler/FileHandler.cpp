@@ -2,16 +2,20 @@
 
 #include <webserv/config/AConfig.hpp>       // for AConfig
 #include <webserv/handler/ErrorHandler.hpp> // for ErrorHandler
-#include <webserv/handler/MIMETypes.hpp>  // for MIMETypes
-#include <webserv/handler/URI.hpp>        // for URI
-#include <webserv/http/HttpConstants.hpp> // for NOT_FOUND, OK, GATEWAY_TIMEOUT
-#include <webserv/http/HttpResponse.hpp>  // for HttpResponse
-#include <webserv/log/Log.hpp>            // for Log, LOCATION
-#include <webserv/utils/AutoIndex.hpp>    // for AutoIndex
-#include <webserv/utils/FileUtils.hpp>    // for joinPath, getExtension, isFile, readBinaryFile
+#include <webserv/handler/MIMETypes.hpp>    // for MIMETypes
+#include <webserv/handler/URI.hpp>          // for URI
+#include <webserv/http/HttpConstants.hpp>   // for NOT_FOUND, OK, GATEWAY_TIMEOUT, FORBIDDEN
+#include <webserv/http/HttpResponse.hpp>    // for HttpResponse
+#include <webserv/log/Log.hpp>              // for Log, LOCATION
+#include <webserv/utils/AutoIndex.hpp>      // for AutoIndex
+#include <webserv/utils/FileUtils.hpp>      // for joinPath, getExtension
+#include <webserv/utils/HotFileCache.hpp>   // for HotFileCache
+#include <webserv/utils/OpenFileCache.hpp>  // for OpenFileCache
 
+#include <cstddef>  // for size_t
 #include <optional> // for optional
 #include <string>   // for basic_string, allocator, operator+, char_traits, string
+#include <utility>  // for move
 #include <vector>   // for vector
 
 FileHandler::FileHandler(const HttpRequest &request, HttpResponse &response)
@@ -32,14 +36,32 @@ void FileHandler::handleFile(const std::string &filepath) const
     Log::debug("Requested path is a file: " + filepath);
     // auto response = std::make_unique<HttpResponse>();
 
+    size_t fileSize = 0;
+    auto file = OpenFileCache::get().open(filepath, fileSize);
+    if (file == nullptr)
+    {
+        // The path was resolved as an existing file, so failing to open it is a permission problem
+        ErrorHandler::createErrorResponse(Http::StatusCode::FORBIDDEN, response_, config_);
+        return;
+    }
+
     std::string extension = FileUtils::getExtension(filepath);
     std::string mimeType = MIMETypes().getType(extension);
-    response_.addHeader("Content-Type", mimeType);
-
-    std::vector<char> fileData = FileUtils::readBinaryFile(filepath);
+    response_.addHeader(HttpHeaders::Field::ContentType, mimeType);
     Log::debug("Serving file: " + filepath + " with MIME type: " + mimeType);
-    response_.setBody(std::vector<uint8_t>{fileData.begin(), fileData.end()});
     response_.setStatus(Http::StatusCode::OK);
+    if (request_.getMethod() == "GET")
+    {
+        response_.addHeader(HttpHeaders::Field::ContentLength, std::to_string(fileSize));
+        auto serialized = HotFileCache::get().storeResponse(config_, uri_.getDecodedTarget(), filepath,
+                                                            response_.getHeaders().toString(), file->get(), fileSize);
+        if (serialized != nullptr)
+        {
+            response_.setSerialized(std::move(serialized));
+            return;
+        }
+    }
+    response_.setBodyFile(std::move(file), 0, fileSize);
 }
 
 void FileHandler::handleDirectory(const std::string &dirpath, ResourceType type) const
@@ -49,8 +71,9 @@ void FileHandler::handleDirectory(const std::string &dirpath, ResourceType type)
     if (type == DIRECTORY_INDEX)
     {
         auto possibleIndex = config_->get<std::string>("index");
-        auto match = possibleIndex.has_value() ? FileUtils::isFile(FileUtils::joinPath(dirpath, possibleIndex.value()))
-                                               : false;
+        auto match = possibleIndex.has_value()
+                         ? OpenFileCache::get().stat(FileUtils::joinPath(dirpath, possibleIndex.value())).isFile
+                         : false;
         if (!match)
         {
             ErrorHandler::createErrorResponse(Http::StatusCode::NOT_FOUND, response_, config_);
@@ -63,8 +86,7 @@ void FileHandler::handleDirectory(const std::string &dirpath, ResourceType type)
     if (type == DIRECTORY_AUTOINDEX)
     {
         Log::debug("Requested path is a directory: " + dirpath);
-        response_.addHeader("Content-Type", "text/html");
-        response_.addHeader("Connection", "close");
+        response_.addHeader(HttpHeaders::Field::ContentType, "text/html");
         response_.setBody(AutoIndex::generate(dirpath, uri_));
         response_.setStatus(Http::StatusCode::OK);
         return;
@@ -75,6 +97,13 @@ void FileHandler::handleDirectory(const std::string &dirpath, ResourceType type)
 void FileHandler::handle()
 {
     Log::trace(LOCATION);
+    if (uri_.getCachedResponse() != nullptr)
+    {
+        Log::debug("Serving file from hot file cache: " + uri_.getFullPath());
+        response_.setStatus(Http::StatusCode::OK);
+        response_.setSerialized(uri_.getCachedResponse());
+        return;
+    }
     if (!uri_.isValid())
     {
         ErrorHandler::createErrorResponse(Http::StatusCode::NOT_FOUND, response_, config_);
@@ -0,0 +1,507 @@
+#include <webserv/handler/MultipartParser.hpp>
+
+#include <webserv/http/HttpConstants.hpp>  // for DOUBLE_CRLF, MAX_HEADER_SIZE
+#include <webserv/log/Log.hpp>             // for Log, LOCATION
+#include <webserv/utils/FileUtils.hpp>     // for joinPath
+#include <webserv/utils/OpenFileCache.hpp> // for OpenFileCache
+#include <webserv/utils/Scan.hpp>          // for find
+#include <webserv/utils/utils.hpp>         // for trim, extractQuotedValue
+
+#include <algorithm> // for min, transform
+#include <cctype>    // for isalnum
+#include <cerrno>    // for errno, EINTR
+#include <cstring>   // for strerror, strlen
+#include <ctime>     // for time, time_t
+#include <random>    // for random_device, mt19937, uniform_int_distribution
+#include <ranges>    // for transform
+#include <sstream>   // for istringstream, ostringstream
+#include <utility>   // for move
+
+#include <fcntl.h>        // for O_CLOEXEC
+#include <linux/limits.h> // for NAME_MAX
+#include <stdlib.h>       // for mkostemp
+#include <sys/stat.h>     // for fchmod
+#include <unistd.h>       // for close, write, link, unlink
+
+// Names tried for a file before commit() gives up, the first being the one the client sent
+static constexpr int LINK_ATTEMPTS = 16;
+
+MultipartParser::MultipartParser(const std::string &boundary, std::string uploadStore)
+    : firstDelimiter_("--" + boundary), delimiter_("\n--" + boundary), uploadStore_(std::move(uploadStore))
+{
+    Log::trace(LOCATION);
+}
+
+/**
+ * Removes the temporary files that were not linked into the store, including a part still being written.
+ */
+MultipartParser::~MultipartParser()
+{
+    if (fd_ != -1)
+    {
+        close(fd_);
+    }
+    for (const UploadedFile &file : files_)
+    {
+        if (!file.tempPath.empty())
+        {
+            unlink(file.tempPath.c_str());
+        }
+    }
+}
+
+/**
+ * Appends data to what is left of the previous call and runs the state machine as far as it gets. Afterwards only a
+ * possible partial boundary or an incomplete part header block is kept.
+ */
+void MultipartParser::write(std::string_view data)
+{
+    if (state_ == State::Done || state_ == State::Failed)
+    {
+        return;
+    }
+    pending_.append(data);
+    bool progress = true;
+    while (progress)
+    {
+        switch (state_)
+        {
+        case State::Preamble: progress = parsePreamble(); break;
+        case State::Boundary: progress = parseBoundary(); break;
+        case State::Headers: progress = parseHeaders(); break;
+        case State::Data: progress = parseData(); break;
+        case State::Done:
+        case State::Failed: progress = false; break;
+        }
+    }
+    if (state_ == State::Done || state_ == State::Failed)
+    {
+        std::string().swap(pending_);
+    }
+    else
+    {
+        pending_.erase(0, offset_);
+    }
+    offset_ = 0;
+}
+
+/**
+ * The body ended. A part that was not closed by a boundary is dropped, as is everything of a body without any.
+ */
+void MultipartParser::finish()
+{
+    if (state_ == State::Preamble)
+    {
+        fail("No boundary found in body");
+        return;
+    }
+    if (state_ == State::Failed)
+    {
+        return;
+    }
+    if (fd_ != -1)
+    {
+        close(fd_);
+        fd_ = -1;
+        unlink(files_.back().tempPath.c_str());
+        files_.pop_back();
+    }
+    state_ = State::Done;
+    Log::debug("Parsed " + std::to_string(files_.size()) + " file(s) from multipart form data");
+}
+
+/**
+ * Gives the files their names in the upload store; called once the request has been accepted. Returns false if a
+ * file could not be linked, the files linked before it are kept.
+ */
+bool MultipartParser::commit()
+{
+    if (committed_)
+    {
+        return true;
+    }
+    committed_ = true;
+    for (UploadedFile &file : files_)
+    {
+        if (!link(file))
+        {
+            return false;
+        }
+        unlink(file.tempPath.c_str());
+        file.tempPath.clear();
+        // This thread may still cache a file that was deleted under this name
+        OpenFileCache::get().invalidate(file.savedPath);
+        Log::info("Successfully uploaded file: " + file.filename + " (" + std::to_string(file.size) + " bytes)");
+    }
+    return true;
+}
+
+/**
+ * Links the temporary file of file to the name the client sent, or to a generated one when that exists already.
+ * link() fails instead of replacing an existing file, so two uploads racing for a name both keep their data.
+ */
+bool MultipartParser::link(UploadedFile &file) const
+{
+    std::string sanitized = sanitize(file.filename);
+    for (int attempt = 0; attempt < LINK_ATTEMPTS; ++attempt)
+    {
+        std::string path = FileUtils::joinPath(uploadStore_, attempt == 0 ? sanitized : generateFilename(sanitized));
+        if (::link(file.tempPath.c_str(), path.c_str()) == 0)
+        {
+            file.savedPath = path;
+            return true;
+        }
+        if (errno != EEXIST)
+        {
+            Log::error("Failed to store upload as " + path + ": " + std::strerror(errno));
+            return false;
+        }
+    }
+    Log::error("Failed to find a free name for upload " + sanitized);
+    return false;
+}
+
+bool MultipartParser::isValid() const noexcept
+{
+    return state_ == State::Done;
+}
+
+const std::vector<MultipartParser::UploadedFile> &MultipartParser::getFiles() const noexcept
+{
+    return files_;
+}
+
+bool MultipartParser::parsePreamble()
+{
+    std::string_view input = std::string_view(pending_).substr(offset_);
+    size_t pos = scan::find(input, firstDelimiter_);
+    if (pos == std::string_view::npos)
+    {
+        // Whatever precedes the first boundary is ignored, except a tail that may be its start
+        if (input.size() >= firstDelimiter_.size())
+        {
+            offset_ += input.size() - (firstDelimiter_.size() - 1);
+        }
+        return false;
+    }
+    offset_ += pos + firstDelimiter_.size();
+    state_ = State::Boundary;
+    return true;
+}
+
+/**
+ * After a boundary: "--" closes the body, otherwise the rest of the line is skipped and a part follows.
+ */
+bool MultipartParser::parseBoundary()
+{
+    std::string_view input = std::string_view(pending_).substr(offset_);
+    if (input.size() < 2)
+    {
+        return false;
+    }
+    if (input.starts_with("--"))
+    {
+        state_ = State::Done;
+        return false;
+    }
+    size_t eol = input.find('\n');
+    if (eol == std::string_view::npos)
+    {
+        if (input.size() > Http::Protocol::MAX_HEADER_SIZE)
+        {
+            fail("Malformed multipart boundary line");
+        }
+        return false;
+    }
+    offset_ += eol + 1;
+    state_ = State::Headers;
+    return true;
+}
+
+bool MultipartParser::parseHeaders()
+{
+    std::string_view input = std::string_view(pending_).substr(offset_);
+    size_t end = 0;
+    size_t separator = 0;
+    if (input.starts_with(Http::Protocol::CRLF))
+    {
+        separator = Http::Protocol::CRLF.size();
+    }
+    else if (input.starts_with("\n"))
+    {
+        separator = 1;
+    }
+    else
+    {
+        size_t crlf = scan::find(input, Http::Protocol::DOUBLE_CRLF);
+        size_t lf = scan::find(input, "\n\n");
+        if (crlf == std::string_view::npos && lf == std::string_view::npos)
+        {
+            if (input.size() > Http::Protocol::MAX_HEADER_SIZE)
+            {
+                fail("Malformed multipart part: no header/content separator");
+            }
+            return false;
+        }
+        end = std::min(crlf, lf);
+        separator = end == crlf ? Http::Protocol::DOUBLE_CRLF.size() : 2;
+    }
+    openPart(std::string(input.substr(0, end)));
+    offset_ += end + separator;
+    if (state_ == State::Failed)
+    {
+        return false;
+    }
+    state_ = State::Data;
+    return true;
+}
+
+/**
+ * Writes part content up to the next boundary. Without one in sight everything is written except as many bytes as
+ * the delimiter is long, which may be its start or the CR in front of it.
+ */
+bool MultipartParser::parseData()
+{
+    std::string_view input = std::string_view(pending_).substr(offset_);
+    size_t pos = scan::find(input, delimiter_);
+    if (pos == std::string_view::npos)
+    {
+        if (input.size() > delimiter_.size())
+        {
+            size_t length = input.size() - delimiter_.size();
+            writePart(input.substr(0, length));
+            offset_ += length;
+        }
+        return false;
+    }
+    size_t end = pos > 0 && input[pos - 1] == '\r' ? pos - 1 : pos;
+    writePart(input.substr(0, end));
+    if (state_ == State::Failed)
+    {
+        return false;
+    }
+    closePart();
+    offset_ += pos + delimiter_.size();
+    state_ = State::Boundary;
+    return true;
+}
+
+/**
+ * Starts a part: file parts get a file in the upload store, other parts are skipped.
+ */
+void MultipartParser::openPart(const std::string &headers)
+{
+    std::string disposition = getHeaderValue(headers, "Content-Disposition");
+    if (disposition.empty())
+    {
+        Log::warning("Multipart part missing Content-Disposition header");
+        return;
+    }
+    std::string filename = getFileName(disposition);
+    if (filename.empty())
+    {
+        Log::debug("Multipart part is a form field, not a file");
+        return;
+    }
+    UploadedFile info;
+    info.fieldName = getFieldName(disposition);
+    info.filename = filename;
+    info.contentType = getHeaderValue(headers, "Content-Type");
+    if (info.contentType.empty())
+    {
+        info.contentType = "application/octet-stream";
+    }
+    info.size = 0;
+    // mkostemp creates the file with O_EXCL under a name nobody else has
+    std::string tempPath = FileUtils::joinPath(uploadStore_, ".upload-XXXXXX");
+    fd_ = mkostemp(tempPath.data(), O_CLOEXEC);
+    if (fd_ == -1)
+    {
+        fail("Failed to create a file in " + uploadStore_ + ": " + std::strerror(errno));
+        return;
+    }
+    fchmod(fd_, 0644);
+    info.tempPath = std::move(tempPath);
+    Log::debug("Saving file to: " + info.tempPath);
+    files_.push_back(std::move(info));
+}
+
+void MultipartParser::writePart(std::string_view data)
+{
+    if (fd_ == -1)
+    {
+        return;
+    }
+    files_.back().size += data.size();
+    while (!data.empty())
+    {
+        ssize_t written = ::write(fd_, data.data(), data.size());
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            fail("Error writing file: " + files_.back().tempPath + ": " + std::strerror(errno));
+            return;
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+/**
+ * Ends the current part. An empty file part is not kept.
+ */
+void MultipartParser::closePart()
+{
+    if (fd_ == -1)
+    {
+        return;
+    }
+    close(fd_);
+    fd_ = -1;
+    if (files_.back().size == 0)
+    {
+        Log::debug("Empty multipart part");
+        unlink(files_.back().tempPath.c_str());
+        files_.pop_back();
+    }
+}
+
+void MultipartParser::fail(const std::string &reason)
+{
+    Log::warning("Multipart upload failed: " + reason);
+    if (fd_ != -1)
+    {
+        close(fd_);
+        fd_ = -1;
+    }
+    state_ = State::Failed;
+}
+
+std::string MultipartParser::getHeaderValue(const std::string &headers, const std::string &key)
+{
+    std::string search = key;
+    std::ranges::transform(search.begin(), search.end(), search.begin(), ::tolower);
+
+    std::istringstream stream(headers);
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        // Remove trailing \r if present
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        size_t colonPos = line.find(':');
+        if (colonPos == std::string::npos)
+        {
+            continue;
+        }
+
+        std::string name = utils::trim(line.substr(0, colonPos));
+        std::ranges::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == search)
+        {
+            return utils::trim(line.substr(colonPos + 1));
+        }
+    }
+
+    return "";
+}
+
+std::string MultipartParser::getFileName(const std::string &disposition)
+{
+    size_t filenamePos = disposition.find("filename=");
+    if (filenamePos == std::string::npos)
+    {
+        return "";
+    }
+    std::string filename = disposition.substr(filenamePos + std::strlen("filename="));
+    filename = utils::extractQuotedValue(filename);
+    if (filename.empty())
+    {
+        Log::warning("Malformed filename in Content-Disposition");
+        return "";
+    }
+    size_t endPos = filename.find(';');
+    if (endPos != std::string::npos)
+    {
+        filename = filename.substr(0, endPos);
+    }
+
+    return utils::trim(filename);
+}
+
+std::string MultipartParser::getFieldName(const std::string &disposition)
+{
+    size_t namePos = disposition.find("name=");
+    if (namePos == std::string::npos)
+    {
+        return "";
+    }
+    std::string fieldName = disposition.substr(namePos + 5);
+    fieldName = utils::extractQuotedValue(fieldName);
+    size_t endPos = fieldName.find(';');
+    if (endPos != std::string::npos)
+    {
+        fieldName = fieldName.substr(0, endPos);
+    }
+
+    return utils::trim(fieldName);
+}
+
+std::string MultipartParser::sanitize(const std::string &filename)
+{
+    std::string sanitized;
+    sanitized.reserve(filename.length());
+    for (char c : filename)
+    {
+        if (std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '.' || c == '-' || c == '_')
+        {
+            sanitized += c;
+        }
+        else if (c == ' ')
+        {
+            sanitized += '_';
+        }
+    }
+    if (sanitized.empty() || sanitized == "." || sanitized == "..")
+    {
+        sanitized = "upload";
+    }
+    if (sanitized.length() > NAME_MAX)
+    {
+        sanitized = sanitized.substr(0, NAME_MAX);
+    }
+    return sanitized;
+}
+
+/**
+ * An alternative to sanitized for when a file of that name exists: a timestamp and a random suffix are added.
+ */
+std::string MultipartParser::generateFilename(const std::string &sanitized)
+{
+    std::string name = sanitized;
+    std::string ext;
+
+    size_t dotPos = sanitized.rfind('.');
+    if (dotPos != std::string::npos)
+    {
+        name = sanitized.substr(0, dotPos);
+        ext = sanitized.substr(dotPos);
+    }
+
+    // Generate unique suffix with timestamp + random number
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<int> dis(1000, 9999);
+
+    time_t now = time(nullptr);
+    std::ostringstream oss;
+    oss << name << "_" << now << "_" << dis(gen) << ext;
+
+    return oss.str();
+}
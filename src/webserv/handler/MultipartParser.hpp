@@ -0,0 +1,89 @@
+#pragma once
+
+#include <webserv/http/ABodySink.hpp> // for ABodySink
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint8_t
+#include <string>      // for string
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+/**
+ * Parses a multipart/form-data body while it is received and writes the file parts straight into the upload store.
+ *
+ * The body is pushed in as it arrives; only the bytes that could still be the start of a boundary are kept between
+ * calls, so memory stays constant however large the files are. Each file is written to a temporary file of its own in
+ * the upload store and only linked to its final name by commit(), which never replaces an existing file. A request
+ * that fails validation or is cut off leaves nothing behind, and concurrent uploads of the same name cannot truncate
+ * or remove each other's files.
+ */
+class MultipartParser : public ABodySink
+{
+  public:
+    struct UploadedFile
+    {
+        std::string fieldName;
+        std::string filename;
+        std::string contentType;
+        std::string savedPath; // Set by commit()
+        std::string tempPath;
+        size_t size;
+    };
+
+    MultipartParser(const std::string &boundary, std::string uploadStore);
+    ~MultipartParser() override;
+
+    MultipartParser(const MultipartParser &other) = delete;
+    MultipartParser &operator=(const MultipartParser &other) = delete;
+    MultipartParser(MultipartParser &&other) noexcept = delete;
+    MultipartParser &operator=(MultipartParser &&other) noexcept = delete;
+
+    void write(std::string_view data) override;
+    void finish() override;
+    [[nodiscard]] bool commit();
+
+    [[nodiscard]] bool isValid() const noexcept;
+    [[nodiscard]] const std::vector<UploadedFile> &getFiles() const noexcept;
+
+  private:
+    enum class State : uint8_t
+    {
+        Preamble,
+        Boundary,
+        Headers,
+        Data,
+        Done,
+        Failed
+    };
+
+    [[nodiscard]] bool parsePreamble();
+    [[nodiscard]] bool parseBoundary();
+    [[nodiscard]] bool parseHeaders();
+    [[nodiscard]] bool parseData();
+
+    void openPart(const std::string &headers);
+    void writePart(std::string_view data);
+    void closePart();
+    void fail(const std::string &reason);
+
+    [[nodiscard]] bool link(UploadedFile &file) const;
+
+    static std::string generateFilename(const std::string &sanitized);
+
+    static std::string getHeaderValue(const std::string &headers, const std::string &key);
+    static std::string getFileName(const std::string &disposition);
+    static std::string getFieldName(const std::string &disposition);
+    static std::string sanitize(const std::string &filename);
+
+    State state_ = State::Preamble;
+    // "--boundary" opens the first part, "\n--boundary" ends each part; a CR before the LF is dropped too
+    std::string firstDelimiter_;
+    std::string delimiter_;
+    std::string uploadStore_;
+    // Received bytes not parsed yet: pending_[offset_, end) is what the current state still waits on
+    std::string pending_;
+    size_t offset_ = 0;
+    int fd_ = -1;
+    bool committed_ = false;
+    std::vector<UploadedFile> files_;
+};
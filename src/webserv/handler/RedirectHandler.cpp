@@ -17,9 +17,9 @@ void RedirectHandler::handle()
                   + " with reason: " + Http::getStatusCodeReason(request_.getUri().getRedirect().first));
         std::pair<int, std::string> redirect = request_.getUri().getRedirect();
         response_.setStatus(redirect.first);
-        response_.addHeader(std::string(Http::Header::REDIRECT_LOCATION), redirect.second);
-        response_.addHeader(std::string(Http::Header::CONTENT_TYPE), std::string(Http::MimeType::TEXT_HTML));
-        response_.addHeader(std::string(Http::Header::CACHE_CONTROL), "no-cache");
+        response_.addHeader(HttpHeaders::Field::Location, redirect.second);
+        response_.addHeader(HttpHeaders::Field::ContentType, std::string(Http::MimeType::TEXT_HTML));
+        response_.addHeader(HttpHeaders::Field::CacheControl, "no-cache");
         std::string body = "<html><head><title>" + std::to_string(redirect.first) + " "
                            + Http::getStatusCodeReason(redirect.first)
                            + "</title></head>"
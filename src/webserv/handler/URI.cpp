@@ -3,10 +3,12 @@
 #include <webserv/config/AConfig.hpp>        // for AConfig
 #include <webserv/config/LocationConfig.hpp> // for LocationConfig
 #include <webserv/config/ServerConfig.hpp>   // for ServerConfig
-#include <webserv/http/HttpHeaders.hpp> // for HttpHeaders
-#include <webserv/log/Log.hpp>          // for Log, LOCATION
-#include <webserv/utils/FileUtils.hpp>  // for joinPath, isDirectory, isFile, getExtension, isValidPath
-#include <webserv/utils/utils.hpp>      // for trim, split
+#include <webserv/http/HttpHeaders.hpp>      // for HttpHeaders
+#include <webserv/log/Log.hpp>               // for Log, LOCATION
+#include <webserv/utils/FileUtils.hpp>       // for joinPath, getExtension
+#include <webserv/utils/HotFileCache.hpp>    // for HotFileCache
+#include <webserv/utils/OpenFileCache.hpp>   // for OpenFileCache
+#include <webserv/utils/utils.hpp>           // for trim, split
 
 #include <cstddef>  // for size_t
 #include <map>      // for map
@@ -46,7 +48,10 @@ URI::URI(const HttpRequest &request, const ServerConfig &serverConfig)
     Log::trace(LOCATION);
     parseUri();
     Log::debug("Parsed URI: " + uriTrimmed_, {{"ConfigType", config_->getType()}});
-    parseFullpath();
+    if (request.getMethod() != "GET" || !loadCached())
+    {
+        parseFullpath();
+    }
 
     authority_ = request.getHeaders().getHost().value();
 }
@@ -147,12 +152,13 @@ void URI::parseFullpath()
             continue;
         }
 
-        if (FileUtils::isFile(currentPath) && baseName_.empty())
+        OpenFileCache::FileInfo info = OpenFileCache::get().stat(currentPath);
+        if (info.isFile && baseName_.empty())
         {
             baseName_ = segment;
             isDir_ = false;
         }
-        else if (FileUtils::isDirectory(currentPath))
+        else if (info.isDirectory)
         {
             dir_ = FileUtils::joinPath(dir_, segment);
         }
@@ -176,11 +182,11 @@ void URI::parseFullpath()
             return;
         }
     }
-    if (baseName_.empty() && FileUtils::isDirectory(fullPath_))
+    if (baseName_.empty() && OpenFileCache::get().stat(fullPath_).isDirectory)
     {
         std::string index = config_->get<std::string>("index").value_or("");
         std::string indexPath = FileUtils::joinPath(fullPath_, index);
-        if (FileUtils::isFile(indexPath))
+        if (OpenFileCache::get().stat(indexPath).isFile)
         {
             baseName_ = index;
         }
@@ -196,6 +202,27 @@ void URI::parseFullpath()
     }
 }
 
+/**
+ * Resolves the target from the hot file cache, which only holds targets that FileHandler served as a regular file.
+ * The path is taken as cached instead of being probed segment by segment.
+ */
+bool URI::loadCached()
+{
+    std::string path;
+    cachedResponse_ = HotFileCache::get().findResponse(config_, uriTrimmed_, path);
+    if (cachedResponse_ == nullptr)
+    {
+        return false;
+    }
+    size_t slash = path.rfind('/');
+    dir_ = slash == std::string::npos ? "" : path.substr(0, slash);
+    baseName_ = slash == std::string::npos ? path : path.substr(slash + 1);
+    fullPath_ = path;
+    isDir_ = false;
+    Log::debug("URI served from hot file cache: " + fullPath_);
+    return true;
+}
+
 const AConfig *URI::getConfig() const noexcept
 {
     return config_;
@@ -217,7 +244,7 @@ bool URI::isDirectory() const noexcept
 
 bool URI::isValid() const noexcept
 {
-    return valid_ && FileUtils::isValidPath(fullPath_);
+    return valid_ && OpenFileCache::get().stat(fullPath_).exists;
 }
 
 bool URI::isCgi() const noexcept
@@ -227,7 +254,7 @@ bool URI::isCgi() const noexcept
     {
         return config_->isCGI(getExtension());
     }
-    return config_->isCGI(getExtension()) && FileUtils::isFile(fullPath_);
+    return config_->isCGI(getExtension()) && OpenFileCache::get().stat(fullPath_).isFile;
 }
 
 bool URI::isRedirect() const noexcept
@@ -349,4 +376,14 @@ const std::string &URI::getFragment() const noexcept
 const std::string &URI::getAuthority() const noexcept
 {
     return authority_;
+}
+
+const std::string &URI::getDecodedTarget() const noexcept
+{
+    return uriTrimmed_;
+}
+
+const std::shared_ptr<const std::vector<uint8_t>> &URI::getCachedResponse() const noexcept
+{
+    return cachedResponse_;
 }
\ No newline at end of file
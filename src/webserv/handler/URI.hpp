@@ -6,7 +6,10 @@
 #include <webserv/http/HttpRequest.hpp> // for HttpRequest
 #include <webserv/server/Server.hpp>
 
-#include <string> // for string, basic_string
+#include <cstdint> // for uint8_t
+#include <memory>  // for shared_ptr
+#include <string>  // for string, basic_string
+#include <vector>  // for vector
 
 class LocationConfig;
 class ServerConfig;
@@ -38,10 +41,13 @@ class URI
     [[nodiscard]] const std::string &getQuery() const noexcept;
     [[nodiscard]] const std::string &getFragment() const noexcept;
     [[nodiscard]] const std::string &getAuthority() const noexcept;
+    [[nodiscard]] const std::string &getDecodedTarget() const noexcept;
+    [[nodiscard]] const std::shared_ptr<const std::vector<uint8_t>> &getCachedResponse() const noexcept;
 
   private:
     void parseUri();
     void parseFullpath();
+    bool loadCached();
 
     std::string uriTrimmed_;
     const AConfig *config_;
@@ -55,6 +61,7 @@ class URI
     bool valid_ = true;
 
     bool isDir_ = true;
+    std::shared_ptr<const std::vector<uint8_t>> cachedResponse_;
 
     static const AConfig *matchConfig(const std::string &uri, const ServerConfig &serverConfig);
 };
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string_view> // for string_view
+
+/**
+ * Destination of a request body. The parser hands it the decoded body piece by piece while it is received, so the
+ * body never has to be held in the receive buffer as a whole.
+ */
+class ABodySink
+{
+  public:
+    ABodySink() = default;
+    virtual ~ABodySink() = default;
+
+    ABodySink(const ABodySink &other) = delete;
+    ABodySink &operator=(const ABodySink &other) = delete;
+    ABodySink(ABodySink &&other) noexcept = delete;
+    ABodySink &operator=(ABodySink &&other) noexcept = delete;
+
+    /**
+     * Takes the next piece of the body. Throws when it cannot be stored; the request then fails with a 500.
+     */
+    virtual void write(std::string_view data) = 0;
+
+    /**
+     * Called once the whole body has been received.
+     */
+    virtual void finish() {}
+};
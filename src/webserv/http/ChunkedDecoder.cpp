@@ -0,0 +1,152 @@
+#include <webserv/http/ChunkedDecoder.hpp>
+
+#include <webserv/http/HttpConstants.hpp> // for CRLF, MAX_HEADER_SIZE
+#include <webserv/log/Log.hpp>            // for Log
+#include <webserv/utils/Scan.hpp>         // for find
+
+#include <algorithm> // for min
+#include <cctype>    // for tolower
+#include <cstdint>   // for SIZE_MAX
+#include <string>    // for string, operator+
+
+/**
+ * Decodes input up to the next piece of chunk data, or as far as it goes. consumed is set to the number of bytes of
+ * input used, including those of data, which points into input.
+ */
+ChunkedDecoder::Result ChunkedDecoder::decode(std::string_view input, size_t &consumed, std::string_view &data)
+{
+    consumed = 0;
+    while (true)
+    {
+        std::string_view rest = input.substr(consumed);
+        switch (state_)
+        {
+        case State::Size: {
+            // chunk-size [ chunk-ext ] CRLF
+            size_t end = findLineEnd(rest);
+            if (end == std::string_view::npos)
+            {
+                return rest.size() > Http::Protocol::MAX_HEADER_SIZE ? fail("Chunk size line too long")
+                                                                     : Result::NeedMore;
+            }
+            if (!parseSize(rest.substr(0, end), remaining_))
+            {
+                return fail("Invalid chunk size");
+            }
+            consumed += end + Http::Protocol::CRLF.size();
+            state_ = remaining_ == 0 ? State::Trailer : State::Data;
+            break;
+        }
+        case State::Data: {
+            size_t length = std::min(rest.size(), remaining_);
+            if (length == 0)
+            {
+                return Result::NeedMore;
+            }
+            data = rest.substr(0, length);
+            consumed += length;
+            remaining_ -= length;
+            if (remaining_ == 0)
+            {
+                state_ = State::DataEnd;
+            }
+            return Result::Data;
+        }
+        case State::DataEnd:
+            if (rest.size() < Http::Protocol::CRLF.size())
+            {
+                return Result::NeedMore;
+            }
+            if (!rest.starts_with(Http::Protocol::CRLF))
+            {
+                return fail("Chunk data not followed by CRLF");
+            }
+            consumed += Http::Protocol::CRLF.size();
+            state_ = State::Size;
+            break;
+        case State::Trailer: {
+            // Trailer fields up to and including the empty line; the whole section counts against MAX_HEADER_SIZE
+            size_t end = findLineEnd(rest);
+            size_t lineSize = end == std::string_view::npos ? rest.size() : end + Http::Protocol::CRLF.size();
+            if (trailerSize_ + lineSize > Http::Protocol::MAX_HEADER_SIZE)
+            {
+                return fail("Chunked trailer section too long");
+            }
+            if (end == std::string_view::npos)
+            {
+                return Result::NeedMore;
+            }
+            trailerSize_ += lineSize;
+            consumed += lineSize;
+            if (end == 0)
+            {
+                state_ = State::Done;
+            }
+            break;
+        }
+        case State::Done: return Result::Done;
+        case State::Error: return Result::Error;
+        }
+    }
+}
+
+void ChunkedDecoder::reset() noexcept
+{
+    state_ = State::Size;
+    remaining_ = 0;
+    searched_ = 0;
+    trailerSize_ = 0;
+    error_ = {};
+}
+
+std::string_view ChunkedDecoder::getError() const noexcept
+{
+    return error_;
+}
+
+/**
+ * Offset of the CRLF ending the line input starts with, or npos. A line split across reads is only searched from
+ * where the previous search stopped.
+ */
+size_t ChunkedDecoder::findLineEnd(std::string_view input) noexcept
+{
+    // The CR of the CRLF may have been the last byte searched
+    size_t from = searched_ > 0 ? searched_ - 1 : 0;
+    size_t pos = scan::find(input, Http::Protocol::CRLF, from);
+    searched_ = pos == std::string_view::npos ? input.size() : 0;
+    return pos;
+}
+
+ChunkedDecoder::Result ChunkedDecoder::fail(std::string_view reason) noexcept
+{
+    Log::warning(std::string(reason));
+    state_ = State::Error;
+    error_ = reason;
+    return Result::Error;
+}
+
+/**
+ * Reads a chunk-size: hex digits, optionally followed by whitespace before the chunk extensions. Fails on anything
+ * else and on sizes that do not fit in a size_t.
+ */
+bool ChunkedDecoder::parseSize(std::string_view line, size_t &size) noexcept
+{
+    std::string_view digits = line.substr(0, line.find(';'));
+    digits = digits.substr(0, digits.find_last_not_of(" \t") + 1);
+    if (digits.empty())
+    {
+        return false;
+    }
+    size = 0;
+    for (char c : digits)
+    {
+        auto lower = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        size_t digit = std::string_view("0123456789abcdef").find(lower);
+        if (digit == std::string_view::npos || size > (SIZE_MAX >> 4))
+        {
+            return false;
+        }
+        size = (size << 4) | digit;
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint8_t
+#include <string_view> // for string_view
+
+/**
+ * Incremental decoder for the chunked transfer coding (RFC 9112 7.1).
+ *
+ * decode() is given the unparsed input every time more arrives and reports how much of it it consumed; the caller
+ * drops exactly that much before the next call. Chunk data is handed back as soon as any of it is in, so a chunk never
+ * has to fit in the receive buffer, and a line that is still incomplete is not searched again from its start, so every
+ * byte is looked at a constant number of times however the input is split. Chunk extensions and trailer fields are
+ * read and discarded.
+ */
+class ChunkedDecoder
+{
+  public:
+    enum class Result : uint8_t
+    {
+        Data,     // data holds the next piece of the body
+        NeedMore, // Everything consumed that could be
+        Done,     // The last chunk and the trailer section are through
+        Error     // Malformed or over a limit; getError() says why
+    };
+
+    [[nodiscard]] Result decode(std::string_view input, size_t &consumed, std::string_view &data);
+    void reset() noexcept;
+
+    [[nodiscard]] std::string_view getError() const noexcept;
+
+  private:
+    enum class State : uint8_t
+    {
+        Size,
+        Data,
+        DataEnd,
+        Trailer,
+        Done,
+        Error
+    };
+
+    [[nodiscard]] size_t findLineEnd(std::string_view input) noexcept;
+    Result fail(std::string_view reason) noexcept;
+
+    [[nodiscard]] static bool parseSize(std::string_view line, size_t &size) noexcept;
+
+    State state_ = State::Size;
+    // Data left of the current chunk
+    size_t remaining_ = 0;
+    // Bytes of the current line already searched for its CRLF
+    size_t searched_ = 0;
+    // Size of the trailer section so far
+    size_t trailerSize_ = 0;
+    std::string_view error_;
+};
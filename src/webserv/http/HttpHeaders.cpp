@@ -1,106 +1,296 @@
-#include <webserv/http/HttpHeaders.hpp>   // for HttpHeaders
+#include <webserv/http/HttpHeaders.hpp> // for HttpHeaders
 
 #include <webserv/http/HttpConstants.hpp> // for CRLF
 #include <webserv/log/Log.hpp>
-#include <webserv/utils/utils.hpp> // for trim
+#include <webserv/utils/Scan.hpp>  // for find
+#include <webserv/utils/utils.hpp> // for stoul
 
-#include <algorithm> // for __transform_fn, transform
-#include <cctype>    // for tolower
-#include <string>
-#include <unordered_map>
-#include <utility> // for pair
+#include <array>   // for array
+#include <cctype>  // for isalnum
+#include <cstddef> // for ptrdiff_t
+#include <string>  // for string, operator+, to_string
+
+static inline std::string_view trimView(std::string_view str)
+{
+    constexpr std::string_view whitespace = " \t\n\r";
+    size_t first = str.find_first_not_of(whitespace);
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    size_t last = str.find_last_not_of(whitespace);
+    return str.substr(first, last - first + 1);
+}
+
+using Field = HttpHeaders::Field;
+
+static constexpr size_t FIELD_COUNT = static_cast<size_t>(Field::Count);
+static constexpr size_t FIELD_HASH_SLOTS = 64;
+
+// Indexed by Field
+static constexpr std::array<std::string_view, FIELD_COUNT> FIELD_NAMES
+    = {"Accept", "Accept-Encoding", "Accept-Language", "Allow", "Authorization", "Cache-Control", "Connection",
+       "Content-Encoding", "Content-Length", "Content-Type", "Cookie", "Date", "ETag", "Expect", "Host",
+       "If-Modified-Since", "Keep-Alive", "Last-Modified", "Location", "Range", "Referer", "Server", "Set-Cookie",
+       "Status", "Transfer-Encoding", "User-Agent"};
+
+static constexpr unsigned char toLower(char c) noexcept
+{
+    return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+}
+
+/**
+ * Perfect hash over FIELD_NAMES: their length, first and last letter tell them apart. Adding a Field may need new
+ * multipliers, the static_assert below says so.
+ */
+static constexpr size_t fieldHash(std::string_view name) noexcept
+{
+    return (name.size() * 7 + toLower(name.front()) + toLower(name.back()) * 55) % FIELD_HASH_SLOTS;
+}
+
+static constexpr std::array<Field, FIELD_HASH_SLOTS> buildFieldTable() noexcept
+{
+    std::array<Field, FIELD_HASH_SLOTS> table{};
+    table.fill(Field::Unknown);
+    for (size_t i = 0; i < FIELD_COUNT; ++i)
+    {
+        table.at(fieldHash(FIELD_NAMES.at(i))) = static_cast<Field>(i);
+    }
+    return table;
+}
+
+static constexpr std::array<Field, FIELD_HASH_SLOTS> FIELD_TABLE = buildFieldTable();
+
+static constexpr bool isPerfectHash() noexcept
+{
+    for (size_t i = 0; i < FIELD_COUNT; ++i)
+    {
+        if (FIELD_TABLE.at(fieldHash(FIELD_NAMES.at(i))) != static_cast<Field>(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isPerfectHash(), "Two header fields share a hash slot, adjust fieldHash");
+
+bool HttpHeaders::NameEqual::operator()(std::string_view lhs, std::string_view rhs) const noexcept
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        if (toLower(lhs[i]) != toLower(rhs[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+HttpHeaders::HttpHeaders(std::pmr::memory_resource *resource) : entries_(resource), slots_()
+{
+    slots_.fill(NO_ENTRY);
+}
+
+HttpHeaders::Field HttpHeaders::toField(std::string_view name) noexcept
+{
+    if (name.empty())
+    {
+        return Field::Unknown;
+    }
+    Field field = FIELD_TABLE.at(fieldHash(name));
+    if (field != Field::Unknown && NameEqual()(name, getName(field)))
+    {
+        return field;
+    }
+    return Field::Unknown;
+}
+
+std::string_view HttpHeaders::getName(Field field) noexcept
+{
+    return field == Field::Unknown ? std::string_view() : FIELD_NAMES.at(static_cast<size_t>(field));
+}
 
 std::optional<size_t> HttpHeaders::getContentLength() const
 {
-    const auto &value = this->get("Content-Length");
+    std::string_view value = get(Field::ContentLength);
     if (value.empty())
     {
         return std::nullopt;
     }
-    return utils::stoul(value);
+    return utils::stoul(std::string(value));
 }
 
 std::optional<std::string> HttpHeaders::getContentType() const noexcept
 {
-    const auto &value = this->get("Content-Type");
+    std::string_view value = get(Field::ContentType);
     if (value.empty())
     {
         return std::nullopt;
     }
-    return value;
+    return std::string(value);
 }
 
 std::optional<std::string> HttpHeaders::getHost() const noexcept
 {
-    const auto &value = this->get("Host");
+    std::string_view value = get(Field::Host);
     if (value.empty())
     {
         return std::nullopt;
     }
-    return value;
+    return std::string(value);
+}
+
+/**
+ * Index of the entry for field, or for name when field is Unknown. NO_ENTRY if there is none.
+ */
+size_t HttpHeaders::indexOf(Field field, std::string_view name) const noexcept
+{
+    if (field != Field::Unknown)
+    {
+        return slots_.at(static_cast<size_t>(field));
+    }
+    for (size_t i = 0; i < entries_.size(); ++i)
+    {
+        if (NameEqual()(entries_[i].name, name))
+        {
+            return i;
+        }
+    }
+    return NO_ENTRY;
 }
 
-void HttpHeaders::add(const std::string &name, const std::string &value) noexcept
+void HttpHeaders::insert(Field field, std::string_view name, std::string_view value) noexcept
 {
-    std::string lower = name;
-    std::ranges::transform(lower, lower.begin(), ::tolower);
-    if (!originalCase_.contains(lower))
+    size_t index = indexOf(field, name);
+    if (index == NO_ENTRY)
     {
-        originalCase_[lower] = name;
+        index = entries_.size();
+        if (field != Field::Unknown)
+        {
+            slots_.at(static_cast<size_t>(field)) = static_cast<uint32_t>(index);
+        }
+        entries_.push_back(Entry{.name = std::pmr::string(name, entries_.get_allocator()),
+                                 .values = Values(entries_.get_allocator())});
     }
-    headers_[lower].push_back(value);
+    entries_[index].values.emplace_back(value);
 }
 
-void HttpHeaders::remove(const std::string &name) noexcept
+void HttpHeaders::add(Field field, std::string_view value) noexcept
 {
-    std::string lower = name;
-    std::ranges::transform(lower, lower.begin(), ::tolower);
-    headers_.erase(lower);
-    originalCase_.erase(lower);
+    insert(field, getName(field), value);
 }
 
-const std::string &HttpHeaders::get(const std::string &name) const noexcept
+void HttpHeaders::add(std::string_view name, std::string_view value) noexcept
 {
-    std::string lower = name;
-    std::ranges::transform(lower, lower.begin(), ::tolower);
-    auto it = headers_.find(lower);
-    if (it != headers_.end() && !it->second.empty())
+    insert(toField(name), name, value);
+}
+
+/**
+ * Removes the entry at index, keeping the order of the rest and the slots pointing past it.
+ */
+void HttpHeaders::erase(size_t index) noexcept
+{
+    entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(index));
+    for (uint32_t &slot : slots_)
     {
-        return it->second.front();
+        if (slot == index)
+        {
+            slot = NO_ENTRY;
+        }
+        else if (slot != NO_ENTRY && slot > index)
+        {
+            --slot;
+        }
     }
-    static const std::string empty;
-    return empty;
 }
 
-bool HttpHeaders::has(const std::string &name) const noexcept
+void HttpHeaders::remove(Field field) noexcept
 {
-    std::string lower = name;
-    std::ranges::transform(lower, lower.begin(), ::tolower);
-    return headers_.contains(lower);
+    size_t index = indexOf(field, getName(field));
+    if (index != NO_ENTRY)
+    {
+        erase(index);
+    }
 }
 
-bool HttpHeaders::parse(const std::string &rawHeaders) noexcept
+void HttpHeaders::remove(std::string_view name) noexcept
+{
+    size_t index = indexOf(toField(name), name);
+    if (index != NO_ENTRY)
+    {
+        erase(index);
+    }
+}
+
+void HttpHeaders::clear() noexcept
+{
+    entries_.clear();
+    slots_.fill(NO_ENTRY);
+}
+
+std::string_view HttpHeaders::get(Field field) const noexcept
+{
+    const Values *values = getValues(field);
+    return values == nullptr || values->empty() ? std::string_view() : std::string_view(values->front());
+}
+
+std::string_view HttpHeaders::get(std::string_view name) const noexcept
+{
+    const Values *values = getValues(name);
+    return values == nullptr || values->empty() ? std::string_view() : std::string_view(values->front());
+}
+
+bool HttpHeaders::has(Field field) const noexcept
+{
+    return getValues(field) != nullptr;
+}
+
+bool HttpHeaders::has(std::string_view name) const noexcept
+{
+    return getValues(name) != nullptr;
+}
+
+const HttpHeaders::Values *HttpHeaders::getValues(Field field) const noexcept
+{
+    size_t index = indexOf(field, getName(field));
+    return index == NO_ENTRY ? nullptr : &entries_[index].values;
+}
+
+const HttpHeaders::Values *HttpHeaders::getValues(std::string_view name) const noexcept
+{
+    size_t index = indexOf(toField(name), name);
+    return index == NO_ENTRY ? nullptr : &entries_[index].values;
+}
+
+/**
+ * Parses the header block line by line. Names and values are views into rawHeaders until add() copies them into the
+ * map's memory resource.
+ */
+bool HttpHeaders::parse(std::string_view rawHeaders) noexcept
 {
     Log::trace(LOCATION);
     size_t start = 0;
-    size_t end = rawHeaders.find(Http::Protocol::CRLF);
+    size_t end = scan::find(rawHeaders, Http::Protocol::CRLF);
     size_t headerCount = 0;
 
-    while (end != std::string::npos)
+    while (end != std::string_view::npos)
     {
-        std::string line = rawHeaders.substr(start, end - start);
+        std::string_view line = rawHeaders.substr(start, end - start);
         size_t col = line.find(':');
-        if (col != std::string::npos)
+        if (col != std::string_view::npos)
         {
-            std::string name = line.substr(0, col);
-            std::string value = line.substr(col + 1);
-            name = utils::trim(name);
-            value = utils::trim(value);
+            std::string_view name = trimView(line.substr(0, col));
+            std::string_view value = trimView(line.substr(col + 1));
 
             // Reject headers with empty names
             if (name.empty())
             {
-                Log::warning("Malformed header line (empty header name): " + line);
+                Log::warning("Malformed header line (empty header name): " + std::string(line));
                 return false;
             }
 
@@ -112,7 +302,7 @@ bool HttpHeaders::parse(const std::string &rawHeaders) noexcept
                     && c != '&' && c != '\'' && c != '*' && c != '+' && c != '-' && c != '.' && c != '^' && c != '_'
                     && c != '`' && c != '|' && c != '~')
                 {
-                    Log::warning("Malformed header line (invalid character in header name): " + line);
+                    Log::warning("Malformed header line (invalid character in header name): " + std::string(line));
                     return false;
                 }
             }
@@ -120,14 +310,15 @@ bool HttpHeaders::parse(const std::string &rawHeaders) noexcept
             // Reject values that start with ':' (e.g., "Badly-Formed:: value")
             if (!value.empty() && value.front() == ':')
             {
-                Log::warning("Malformed header line (value starts with colon): " + line);
+                Log::warning("Malformed header line (value starts with colon): " + std::string(line));
                 return false;
             }
 
             // Enforce per-header value size limit
             if (value.size() > Http::Protocol::MAX_HEADER_SIZE)
             {
-                Log::warning("Header value exceeds maximum size (" + std::to_string(value.size()) + ") for: " + name);
+                Log::warning("Header value exceeds maximum size (" + std::to_string(value.size())
+                             + ") for: " + std::string(name));
                 return false;
             }
 
@@ -144,36 +335,42 @@ bool HttpHeaders::parse(const std::string &rawHeaders) noexcept
         else if (!line.empty())
         {
             // Malformed header line (no colon) - this is an error
-            Log::warning("Malformed header line (missing colon): " + line);
+            Log::warning("Malformed header line (missing colon): " + std::string(line));
             return false;
         }
         start = end + Http::Protocol::CRLF.size();
-        end = rawHeaders.find(Http::Protocol::CRLF, start);
+        end = scan::find(rawHeaders, Http::Protocol::CRLF, start);
     }
     return true;
 }
 
-const std::unordered_map<std::string, std::vector<std::string>> &HttpHeaders::getAll() const noexcept
+const HttpHeaders::Entries &HttpHeaders::getAll() const noexcept
 {
-    return headers_;
+    return entries_;
 }
 
 std::string HttpHeaders::toString() const noexcept
 {
     std::string result;
-    for (const auto &pair : headers_)
+    appendTo(result);
+    return result;
+}
+
+/**
+ * Serializes the header fields and the blank line ending them onto out.
+ */
+void HttpHeaders::appendTo(std::string &out) const
+{
+    for (const Entry &entry : entries_)
     {
-        // Use original case for output (looks up from originalCase_ map)
-        const std::string &outputName = originalCase_.contains(pair.first) ? originalCase_.at(pair.first) : pair.first;
         // Emit each value on its own header line
-        for (const auto &val : pair.second)
+        for (const auto &val : entry.values)
         {
-            result += outputName;
-            result += ": ";
-            result += val;
-            result += "\r\n";
+            out += entry.name;
+            out += ": ";
+            out += val;
+            out += "\r\n";
         }
     }
-    result += "\r\n";
-    return result;
-}
\ No newline at end of file
+    out += "\r\n";
+}
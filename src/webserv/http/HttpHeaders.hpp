@@ -1,10 +1,13 @@
 #pragma once
 
-#include <cstddef>       // for size_t
-#include <optional>      // for optional
-#include <string>        // for basic_string, string, hash
-#include <unordered_map> // for unordered_map
-#include <vector>        // for storing multiple header values
+#include <array>           // for array
+#include <cstddef>         // for size_t
+#include <cstdint>         // for uint8_t, uint32_t
+#include <memory_resource> // for memory_resource, get_default_resource, polymorphic_allocator
+#include <optional>        // for optional
+#include <string>          // for pmr::string, string
+#include <string_view>     // for string_view
+#include <vector>          // for pmr::vector
 
 /**
  * @file HttpHeaders.hpp
@@ -15,24 +18,97 @@
  *
  * Without this class the HttpRequest and Response classes would become too bloated, and we'd end up adding members
  * to those classes for every new header we want to support.
+ *
+ * Names are matched case-insensitively and kept in the case they were first added in. All storage comes from the
+ * memory resource given at construction, for a request that is its arena.
+ *
+ * Headers are kept in a flat list in the order they were first added. The common ones, listed in Field, also get a
+ * fixed slot pointing into that list, so looking them up is an array index; names given as strings are mapped to a
+ * Field by a perfect hash first, and only unknown names are searched for.
  */
 class HttpHeaders
 {
   public:
-    [[nodiscard]] const std::string &get(const std::string &name) const noexcept;
-    [[nodiscard]] bool has(const std::string &name) const noexcept;
+    enum class Field : uint8_t
+    {
+        Accept,
+        AcceptEncoding,
+        AcceptLanguage,
+        Allow,
+        Authorization,
+        CacheControl,
+        Connection,
+        ContentEncoding,
+        ContentLength,
+        ContentType,
+        Cookie,
+        Date,
+        ETag,
+        Expect,
+        Host,
+        IfModifiedSince,
+        KeepAlive,
+        LastModified,
+        Location,
+        Range,
+        Referer,
+        Server,
+        SetCookie,
+        Status,
+        TransferEncoding,
+        UserAgent,
+        Count,
+        Unknown = Count
+    };
+
+    struct NameEqual
+    {
+        [[nodiscard]] bool operator()(std::string_view lhs, std::string_view rhs) const noexcept;
+    };
+
+    using Values = std::pmr::vector<std::pmr::string>;
+
+    struct Entry
+    {
+        std::pmr::string name;
+        Values values;
+    };
+
+    using Entries = std::pmr::vector<Entry>;
 
-    [[nodiscard]] bool parse(const std::string &rawHeaders) noexcept;
-    void add(const std::string &name, const std::string &value) noexcept;
-    void remove(const std::string &name) noexcept;
+    explicit HttpHeaders(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    [[nodiscard]] static Field toField(std::string_view name) noexcept;
+    [[nodiscard]] static std::string_view getName(Field field) noexcept;
+
+    [[nodiscard]] std::string_view get(Field field) const noexcept;
+    [[nodiscard]] std::string_view get(std::string_view name) const noexcept;
+    [[nodiscard]] bool has(Field field) const noexcept;
+    [[nodiscard]] bool has(std::string_view name) const noexcept;
+    [[nodiscard]] const Values *getValues(Field field) const noexcept;
+    [[nodiscard]] const Values *getValues(std::string_view name) const noexcept;
+
+    [[nodiscard]] bool parse(std::string_view rawHeaders) noexcept;
+    void add(Field field, std::string_view value) noexcept;
+    void add(std::string_view name, std::string_view value) noexcept;
+    void remove(Field field) noexcept;
+    void remove(std::string_view name) noexcept;
+    void clear() noexcept;
 
     [[nodiscard]] std::string toString() const noexcept;
+    void appendTo(std::string &out) const;
     [[nodiscard]] std::optional<size_t> getContentLength() const;
     [[nodiscard]] std::optional<std::string> getContentType() const noexcept;
     [[nodiscard]] std::optional<std::string> getHost() const noexcept;
-    [[nodiscard]] const std::unordered_map<std::string, std::vector<std::string>> &getAll() const noexcept;
+    [[nodiscard]] const Entries &getAll() const noexcept;
 
   private:
-    std::unordered_map<std::string, std::vector<std::string>> headers_;
-    std::unordered_map<std::string, std::string> originalCase_; // Maps lowercase name -> original case
-};
\ No newline at end of file
+    static constexpr uint32_t NO_ENTRY = UINT32_MAX;
+
+    [[nodiscard]] size_t indexOf(Field field, std::string_view name) const noexcept;
+    void insert(Field field, std::string_view name, std::string_view value) noexcept;
+    void erase(size_t index) noexcept;
+
+    Entries entries_;
+    std::array<uint32_t, static_cast<size_t>(Field::Count)> slots_;
+};
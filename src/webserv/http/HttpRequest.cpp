@@ -1,20 +1,32 @@
 #include <webserv/http/HttpRequest.hpp>
 
+#include <webserv/config/AConfig.hpp>       // for AConfig
 #include <webserv/config/ConfigManager.hpp> // for ConfigManager
 #include <webserv/config/ServerConfig.hpp>
-#include <webserv/handler/URI.hpp>        // for URI
-#include <webserv/http/HttpConstants.hpp> // for CRLF, DOUBLE_CRLF
+#include <webserv/handler/MultipartParser.hpp> // for MultipartParser
+#include <webserv/handler/URI.hpp>             // for URI
+#include <webserv/handler/UploadHandler.hpp>   // for UploadHandler
+#include <webserv/http/ABodySink.hpp>          // for ABodySink
+#include <webserv/http/HttpConstants.hpp>      // for CRLF, DOUBLE_CRLF, MAX_BODY_SIZE
 #include <webserv/log/Log.hpp>     // for Log, LOCATION
+#include <webserv/main.hpp>        // for CHUNK_SIZE, CLIENT_BODY_BUFFER_SIZE, CLIENT_BODY_TEMP_PATH
+#include <webserv/utils/Scan.hpp>  // for find
 #include <webserv/utils/utils.hpp> // for stoul
 
-#include <exception> // for exception
-#include <map>       // for map
-#include <memory>    // for allocator, make_unique, unique_ptr
-#include <optional>  // for optional
-#include <sstream>   // for basic_stringstream, basic_istream, stringstream
-#include <vector>    // for vector
+#include <algorithm>   // for min
+#include <cctype>      // for tolower
+#include <cstdint>     // for SIZE_MAX
+#include <cstring>     // for memmove
+#include <exception>   // for exception
+#include <map>         // for map
+#include <memory>      // for allocator, unique_ptr
+#include <optional>    // for optional
+#include <string_view> // for string_view
+#include <vector>      // for vector
 
-HttpRequest::HttpRequest(Client *client) : client_(client), uri_(nullptr)
+HttpRequest::HttpRequest(Client *client)
+    : client_(client), arenaBuffer_(), arena_(arenaBuffer_.data(), arenaBuffer_.size()), headers_(&arena_),
+      uri_(nullptr)
 {
     Log::trace(LOCATION);
 }
@@ -31,65 +43,306 @@ HttpRequest::State HttpRequest::getState() const noexcept
 
 void HttpRequest::setState(State state)
 {
-    if (state == State::Complete)
+    if (state == State::Complete && uri_ == nullptr && !resolveUri())
     {
-        if (!headers_.getHost().has_value())
+        return;
+    }
+    state_ = state;
+}
+
+/**
+ * Finds the server and location the request is for, as soon as the headers are in. Fails the request with a 400 when
+ * there is none.
+ */
+bool HttpRequest::resolveUri()
+{
+    if (!headers_.getHost().has_value())
+    {
+        client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
+        state_ = State::ParseError;
+        return false;
+    }
+    ServerConfig *serverConfig = getServerConfig();
+    if (serverConfig == nullptr)
+    {
+        client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
+        state_ = State::ParseError;
+        return false;
+    }
+    if (target_.starts_with("http://") || target_.starts_with("https://"))
+    {
+        size_t pos = target_.find('/', 8); // Skip "http://" or "https://"
+        if (pos == std::string::npos)
         {
-            client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
-            state_ = State::ParseError;
-            return;
+            target_ = "/";
         }
-        ServerConfig *serverConfig = getServerConfig();
-        if (serverConfig == nullptr)
+        else
         {
-            client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
-            state_ = State::ParseError;
-            return;
+            target_ = target_.substr(pos);
         }
-        if (target_.starts_with("http://") || target_.starts_with("https://"))
+    }
+    try
+    {
+        uri_ = makeArena<URI>(&arena_, *this, *serverConfig);
+    }
+    catch (const std::invalid_argument &)
+    {
+        Log::warning("Invalid URI encoding (null byte or malformed)");
+        client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
+        state_ = State::ParseError;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Sets up the sink for a request that has a body, with the limits of its location. Multipart uploads are parsed into
+ * the upload store as they arrive; other bodies stay in memory up to client_body_buffer_size.
+ */
+bool HttpRequest::openBody()
+{
+    if (!resolveUri())
+    {
+        return false;
+    }
+    const AConfig *config = uri_->getConfig();
+    maxBodySize_ = config->get<size_t>("client_max_body_size").value_or(Http::Protocol::MAX_BODY_SIZE);
+    if (uri_->isUpload() && method_ == Http::Method::POST)
+    {
+        multipart_ = UploadHandler::createParser(*this);
+        if (multipart_ != nullptr)
         {
-            size_t pos = target_.find('/', 8); // Skip "http://" or "https://"
-            if (pos == std::string::npos)
-            {
-                target_ = "/";
-            }
-            else
-            {
-                target_ = target_.substr(pos);
-            }
+            bodySink_ = multipart_.get();
+            return true;
         }
-        try
+    }
+    size_t memoryLimit = config->get<size_t>("client_body_buffer_size").value_or(CLIENT_BODY_BUFFER_SIZE);
+    try
+    {
+        body_.open(memoryLimit, config->get<std::string>("client_body_temp_path").value_or(CLIENT_BODY_TEMP_PATH));
+    }
+    catch (const std::exception &e)
+    {
+        Log::error("Failed to prepare request body: " + std::string(e.what()));
+        client_->getHttpResponse().setError(Http::StatusCode::INTERNAL_SERVER_ERROR);
+        state_ = State::ParseError;
+        return false;
+    }
+    bodySink_ = &body_;
+    return true;
+}
+
+/**
+ * Passes the next piece of the decoded body to the sink. Past client_max_body_size the rest is only counted, so the
+ * validator can answer 413 once the request is complete without the body taking up space meanwhile.
+ */
+bool HttpRequest::appendBody(std::string_view data)
+{
+    bodyLength_ += data.size();
+    if (bodyLength_ > maxBodySize_)
+    {
+        return true;
+    }
+    try
+    {
+        bodySink_->write(data);
+    }
+    catch (const std::exception &e)
+    {
+        Log::error("Failed to store request body: " + std::string(e.what()));
+        client_->getHttpResponse().setError(Http::StatusCode::INTERNAL_SERVER_ERROR);
+        state_ = State::ParseError;
+        return false;
+    }
+    return true;
+}
+
+const HttpHeaders &HttpRequest::getHeaders() const noexcept
+{
+    return headers_;
+}
+
+const RequestBody &HttpRequest::getBody() const noexcept
+{
+    return body_;
+}
+
+/**
+ * The parser a multipart upload was streamed into, or null when its body went to getBody().
+ */
+MultipartParser *HttpRequest::getMultipart() const noexcept
+{
+    return multipart_.get();
+}
+
+/**
+ * Number of body bytes received, which can be more than getBody() holds once client_max_body_size was exceeded.
+ */
+size_t HttpRequest::getBodyLength() const noexcept
+{
+    return bodyLength_;
+}
+
+/**
+ * Clears the parsed request so the connection can be reused. Bytes received past the end of the previous
+ * request stay in the buffer: they belong to the next, pipelined request.
+ */
+void HttpRequest::reset()
+{
+    Log::trace(LOCATION);
+    state_ = State::RequestLine;
+    scanned_ = begin_;
+    uri_.reset();
+    multipart_.reset();
+    // The buckets of the map live in the arena too, so the map is rebuilt rather than cleared before the release
+    headers_ = HttpHeaders(&arena_);
+    arena_.release();
+    body_.reset();
+    bodySink_ = &body_;
+    bodyLength_ = 0;
+    maxBodySize_ = 0;
+    chunked_.reset();
+    method_.clear();
+    target_.clear();
+    httpVersion_.clear();
+}
+
+/**
+ * Like reset(), but also drops buffered input, for when the connection itself ends. Buffers grown past
+ * Constants::CHUNK_SIZE by a large request are freed so an idle pooled client stays small.
+ */
+void HttpRequest::clear()
+{
+    reset();
+    begin_ = 0;
+    end_ = 0;
+    scanned_ = 0;
+    if (buffer_.capacity() > Constants::CHUNK_SIZE)
+    {
+        std::string().swap(buffer_);
+    }
+    body_.shrink();
+}
+
+/**
+ * HTTP/1.1 connections are persistent unless the client sends "Connection: close";
+ * HTTP/1.0 connections only persist when the client explicitly asks for "keep-alive".
+ */
+bool HttpRequest::isKeepAlive() const noexcept
+{
+    bool keepAlive = httpVersion_ == Http::Version::HTTP_1_1;
+    std::string_view options = headers_.get(HttpHeaders::Field::Connection);
+    while (!options.empty())
+    {
+        size_t comma = options.find(',');
+        std::string_view option = options.substr(0, comma);
+        options = comma == std::string_view::npos ? std::string_view() : options.substr(comma + 1);
+        option.remove_prefix(std::min(option.find_first_not_of(" \t"), option.size()));
+        option = option.substr(0, option.find_last_not_of(" \t") + 1);
+        if (HttpHeaders::NameEqual()(option, "close"))
         {
-            uri_ = std::make_unique<URI>(*this, *serverConfig);
+            return false;
         }
-        catch (const std::invalid_argument &)
+        if (HttpHeaders::NameEqual()(option, "keep-alive"))
         {
-            Log::warning("Invalid URI encoding (null byte or malformed)");
-            client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
-            state_ = State::ParseError;
-            return;
+            keepAlive = true;
         }
     }
-    state_ = state;
+    return keepAlive;
 }
 
-const HttpHeaders &HttpRequest::getHeaders() const noexcept
+size_t HttpRequest::getBufferedSize() const noexcept
 {
-    return headers_;
+    return end_ - begin_;
 }
 
-const std::string &HttpRequest::getBody() const noexcept
+/**
+ * Memory for data that lives as long as the current request, such as its header fields and URI. Everything allocated
+ * from it is given back at once when the request is reset.
+ */
+std::pmr::memory_resource *HttpRequest::getArena() noexcept
 {
-    return body_;
+    return &arena_;
 }
 
-void HttpRequest::receiveData(const char *data, size_t length)
+void HttpRequest::resume()
 {
     Log::trace(LOCATION);
-    buffer_.append(data, length);
     parseBuffer();
 }
 
+/**
+ * Returns room for length more bytes at the end of the receive buffer; pass the number actually written to
+ * receiveData(). Consumed input is dropped first when that is cheap enough to keep the cost linear.
+ */
+char *HttpRequest::prepareData(size_t length)
+{
+    compact();
+    if (buffer_.size() < end_ + length)
+    {
+        buffer_.resize(end_ + length);
+    }
+    return buffer_.data() + end_;
+}
+
+void HttpRequest::receiveData(size_t length)
+{
+    Log::trace(LOCATION);
+    end_ += length;
+    parseBuffer();
+}
+
+std::string_view HttpRequest::input() const noexcept
+{
+    return {buffer_.data() + begin_, end_ - begin_};
+}
+
+/**
+ * Offset of delimiter in input(), or npos. A search that comes up empty remembers how far it got, so data trickling
+ * in a few bytes at a time is only scanned once.
+ */
+size_t HttpRequest::find(std::string_view delimiter) noexcept
+{
+    size_t overlap = delimiter.size() - 1;
+    size_t from = scanned_ > begin_ + overlap ? scanned_ - overlap : begin_;
+    size_t pos = scan::find(std::string_view(buffer_.data(), end_), delimiter, from);
+    if (pos == std::string_view::npos)
+    {
+        scanned_ = end_;
+        return std::string_view::npos;
+    }
+    return pos - begin_;
+}
+
+void HttpRequest::consume(size_t length) noexcept
+{
+    begin_ += length;
+    scanned_ = begin_;
+}
+
+/**
+ * Moves the unparsed input to the front once at least as much has been consumed as is left, so every byte is moved
+ * at most a constant number of times on average.
+ */
+void HttpRequest::compact() noexcept
+{
+    if (begin_ == end_)
+    {
+        begin_ = 0;
+        end_ = 0;
+        scanned_ = 0;
+        return;
+    }
+    if (begin_ == 0 || begin_ < end_ - begin_)
+    {
+        return;
+    }
+    std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    scanned_ -= begin_;
+    begin_ = 0;
+}
+
 void HttpRequest::parseBuffer()
 {
     Log::trace(LOCATION);
@@ -138,36 +391,56 @@ void HttpRequest::parseBuffer()
     }
 }
 
+/**
+ * Splits the next whitespace-separated token off line, like reading it with operator>>.
+ */
+static inline std::string_view nextToken(std::string_view &line)
+{
+    constexpr std::string_view whitespace = " \t\n\v\f\r";
+    size_t start = line.find_first_not_of(whitespace);
+    if (start == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+    size_t end = std::min(line.find_first_of(whitespace, start), line.size());
+    std::string_view token = line.substr(start, end - start);
+    line.remove_prefix(end);
+    return token;
+}
+
 bool HttpRequest::parseBufferforRequestLine()
 {
     Log::trace(LOCATION);
-    size_t pos = buffer_.find(Http::Protocol::CRLF);
-    if (pos == std::string::npos)
+    // RFC 9112 2.2: ignore empty lines received prior to the request-line
+    while (input().starts_with(Http::Protocol::CRLF))
     {
-        Log::debug("RequestLine waiting for more data");
-        return false;
+        consume(Http::Protocol::CRLF.size());
     }
-    std::string requestLine_ = buffer_.substr(0, pos);
-
-    buffer_.erase(0, pos + Http::Protocol::CRLF.size());
-    state_ = State::Headers;
-
-    std::vector<std::string> parts;
-    std::string part;
-    std::stringstream ss(requestLine_);
-    while (ss >> part)
+    size_t pos = find(Http::Protocol::CRLF);
+    if (pos == std::string_view::npos)
     {
-        parts.push_back(part);
+        Log::debug("RequestLine waiting for more data");
+        return false;
     }
-    if (parts.size() != 3)
+    std::string_view requestLine = input().substr(0, pos);
+    std::string_view rest = requestLine;
+    std::string_view method = nextToken(rest);
+    std::string_view target = nextToken(rest);
+    std::string_view version = nextToken(rest);
+    if (version.empty() || !nextToken(rest).empty())
     {
-        Log::warning("Invalid request line: " + requestLine_);
+        Log::warning("Invalid request line: " + std::string(requestLine));
+        consume(pos + Http::Protocol::CRLF.size());
         client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
         state_ = State::ParseError; // Mark as complete to avoid further processing
         return true;
     }
-    method_ = parts[0];
-    target_ = parts[1];
+    method_.assign(method);
+    target_.assign(target);
+    httpVersion_.assign(version);
+    consume(pos + Http::Protocol::CRLF.size());
+    state_ = State::Headers;
     if (target_.size() > 2048)
     {
         Log::warning("Request target too long: " + target_);
@@ -175,7 +448,6 @@ bool HttpRequest::parseBufferforRequestLine()
         state_ = State::ParseError; // Mark as complete to avoid further processing
         return true;
     }
-    httpVersion_ = parts[2];
     Log::debug("Parsed Request Line: Method=" + method_ + " Target=" + target_ + " Version=" + httpVersion_);
     return true;
 }
@@ -183,14 +455,16 @@ bool HttpRequest::parseBufferforRequestLine()
 bool HttpRequest::parseBufferforHeaders()
 {
     Log::trace(LOCATION);
-    size_t pos = buffer_.find(Http::Protocol::DOUBLE_CRLF);
-    if (pos == std::string::npos)
+    // An empty line right away ends a request without header fields
+    size_t pos = input().starts_with(Http::Protocol::CRLF) ? 0 : find(Http::Protocol::DOUBLE_CRLF);
+    if (pos == std::string_view::npos)
     {
-        Log::debug("Headers waiting for more data: " + LOCATION);
+        Log::debug("Headers waiting for more data: " + LOCATION.toString());
         return false; // Wait for more data
     }
+    size_t blockEnd = pos == 0 ? 0 : pos + Http::Protocol::CRLF.size();
 
-    if (!headers_.parse(buffer_.substr(0, pos + Http::Protocol::CRLF.size())))
+    if (!headers_.parse(input().substr(0, blockEnd)))
     {
         Log::warning("Failed to parse headers - malformed header detected");
         client_->getHttpResponse().setError(400);
@@ -198,19 +472,19 @@ bool HttpRequest::parseBufferforHeaders()
         return false;
     }
 
-    buffer_.erase(0, pos + Http::Protocol::DOUBLE_CRLF.size());
+    consume(blockEnd + Http::Protocol::CRLF.size());
 
     // Validate Content-Length value (must be a valid integer)
-    const std::string &cl = headers_.get("Content-Length");
+    std::string_view cl = headers_.get(HttpHeaders::Field::ContentLength);
     if (!cl.empty())
     {
         try
         {
-            static_cast<void>(utils::stoul(cl));
+            static_cast<void>(utils::stoul(std::string(cl)));
         }
         catch (const std::exception &)
         {
-            Log::warning("Invalid Content-Length value: " + cl);
+            Log::warning("Invalid Content-Length value: " + std::string(cl));
             client_->getHttpResponse().setError(400);
             setState(State::ParseError);
             return false;
@@ -219,6 +493,10 @@ bool HttpRequest::parseBufferforHeaders()
 
     if (this->headers_.getContentLength().value_or(0) > 0)
     {
+        if (!openBody())
+        {
+            return false;
+        }
         state_ = State::Body;
         return true;
     }
@@ -229,9 +507,13 @@ bool HttpRequest::parseBufferforHeaders()
         setState(State::ParseError);
         return false;
     }
-    if (this->headers_.has("Transfer-Encoding") && this->headers_.get("Transfer-Encoding") == "chunked")
+    if (this->headers_.get(HttpHeaders::Field::TransferEncoding) == "chunked")
     {
         Log::debug("HttpRequest::parseBuffer() in state Headers with chunked encoding");
+        if (!openBody())
+        {
+            return false;
+        }
         state_ = State::Chunked;
         return true;
     }
@@ -240,48 +522,46 @@ bool HttpRequest::parseBufferforHeaders()
     return false; // No body to read
 }
 
+/**
+ * Decodes as much of a chunked body as has arrived, passing chunk data to the sink as soon as it is received.
+ */
 bool HttpRequest::parseBufferforChunkedBody()
 {
     Log::trace(LOCATION);
     while (true)
     {
-        size_t pos = buffer_.find(Http::Protocol::CRLF);
-        if (pos == std::string::npos)
+        size_t consumed = 0;
+        std::string_view data;
+        ChunkedDecoder::Result result = chunked_.decode(input(), consumed, data);
+        // data points into the buffer, which consuming leaves alone
+        consume(consumed);
+        switch (result)
         {
-            Log::debug("Chunked body waiting for more data: " + LOCATION);
-            return false;
-        }
-        std::string chunkSizeStr = buffer_.substr(0, pos);
-        Log::debug("Chunk size string: " + chunkSizeStr);
-        size_t chunkSize = 0;
-        try
-        {
-            chunkSize = utils::stoul(chunkSizeStr, 16);
-        }
-        catch (const std::exception &e)
-        {
-            Log::warning("Invalid chunk size: " + chunkSizeStr + " - " + e.what());
-            client_->getHttpResponse().setError(400);
-            setState(State::ParseError);
+        case ChunkedDecoder::Result::Data:
+            if (!appendBody(data))
+            {
+                return false;
+            }
+            break;
+        case ChunkedDecoder::Result::NeedMore:
+            Log::debug("Chunked body waiting for more data: " + LOCATION.toString());
             return false;
-        }
-        if (chunkSize == 0)
-        {
-            setState(State::Complete); // Last chunk
-            buffer_.erase(0, pos + Http::Protocol::CRLF.size());
+        case ChunkedDecoder::Result::Done:
+            bodySink_->finish();
+            setState(State::Complete);
             return true;
-        }
-        if (buffer_.size() < pos + Http::Protocol::CRLF.size() + chunkSize + Http::Protocol::CRLF.size())
-        {
-            Log::debug("Chunked body waiting for more data: " + LOCATION);
+        case ChunkedDecoder::Result::Error:
+            client_->getHttpResponse().setError(Http::StatusCode::BAD_REQUEST);
+            setState(State::ParseError);
             return false;
         }
-        body_ += buffer_.substr(pos + Http::Protocol::CRLF.size(), chunkSize);
-        buffer_.erase(0, pos + Http::Protocol::CRLF.size() + chunkSize + Http::Protocol::CRLF.size());
     }
-    return true;
 }
 
+/**
+ * Passes whatever part of the body has arrived on to the sink right away, so the receive buffer never has to hold more
+ * than one read of it.
+ */
 bool HttpRequest::parseBufferforBody()
 {
     if (!headers_.getContentLength().has_value())
@@ -290,14 +570,20 @@ bool HttpRequest::parseBufferforBody()
         setState(State::Complete);
         return true;
     }
-    Log::trace(LOCATION, {{"Content-Length", std::to_string(*headers_.getContentLength())}});
-    if (buffer_.size() < *headers_.getContentLength())
+    size_t contentLength = *headers_.getContentLength();
+    Log::trace(LOCATION, {{"Content-Length", std::to_string(contentLength)}});
+    size_t length = std::min(getBufferedSize(), contentLength - bodyLength_);
+    if (!appendBody(input().substr(0, length)))
+    {
+        return false;
+    }
+    consume(length);
+    if (bodyLength_ < contentLength)
     {
-        Log::debug("Body waiting for more data: " + LOCATION);
+        Log::debug("Body waiting for more data: " + LOCATION.toString());
         return false; // Wait for more data
     }
-    body_ = buffer_.substr(0, *headers_.getContentLength());
-    buffer_.erase(0, *headers_.getContentLength());
+    bodySink_->finish();
     setState(State::Complete);
 
     return true;
@@ -1,15 +1,22 @@
 #pragma once
 
 #include <webserv/config/ServerConfig.hpp>
+#include <webserv/http/ChunkedDecoder.hpp> // for ChunkedDecoder
 #include <webserv/http/HttpHeaders.hpp> // for HttpHeaders
 #include <webserv/http/HttpResponse.hpp>
+#include <webserv/http/RequestBody.hpp> // for RequestBody
+#include <webserv/utils/ArenaPtr.hpp>   // for ArenaPtr
 
-#include <cstddef> // for size_t
-#include <cstdint> // for uint8_t
-#include <memory>  // for unique_ptr
-#include <string>  // for string, basic_string
+#include <array>           // for array
+#include <cstddef>         // for size_t, byte
+#include <cstdint>         // for uint8_t
+#include <memory_resource> // for memory_resource, monotonic_buffer_resource
+#include <string>          // for string, basic_string
+#include <string_view>     // for string_view
 
+class ABodySink;
 class Client;
+class MultipartParser;
 class ServerConfig;
 class URI;
 
@@ -37,16 +44,27 @@ class HttpRequest
     [[nodiscard]] State getState() const noexcept;
     [[nodiscard]] const URI &getUri() const noexcept;
     [[nodiscard]] const HttpHeaders &getHeaders() const noexcept;
-    [[nodiscard]] const std::string &getBody() const noexcept;
+    [[nodiscard]] const RequestBody &getBody() const noexcept;
+    [[nodiscard]] MultipartParser *getMultipart() const noexcept;
+    [[nodiscard]] size_t getBodyLength() const noexcept;
     [[nodiscard]] const std::string &getMethod() const noexcept;
     [[nodiscard]] const std::string &getTarget() const noexcept;
     [[nodiscard]] const std::string &getHttpVersion() const noexcept;
     [[nodiscard]] Client &getClient() const noexcept;
+    [[nodiscard]] bool isKeepAlive() const noexcept;
+    [[nodiscard]] size_t getBufferedSize() const noexcept;
+    [[nodiscard]] std::pmr::memory_resource *getArena() noexcept;
 
     void setState(State state);
-    void receiveData(const char *data, size_t length);
+    [[nodiscard]] char *prepareData(size_t length);
+    void receiveData(size_t length);
+    void reset();
+    void clear();
+    void resume();
 
   private:
+    static constexpr size_t ARENA_SIZE = 8192;
+
     [[nodiscard]] bool parseBufferforRequestLine();
     [[nodiscard]] bool parseBufferforHeaders();
     [[nodiscard]] bool parseHeaderLine();
@@ -55,19 +73,43 @@ class HttpRequest
 
     void parseBuffer();
     void parseContentLength();
+    [[nodiscard]] bool resolveUri();
+    [[nodiscard]] bool openBody();
+    [[nodiscard]] bool appendBody(std::string_view data);
+
+    [[nodiscard]] std::string_view input() const noexcept;
+    [[nodiscard]] size_t find(std::string_view delimiter) noexcept;
+    void consume(size_t length) noexcept;
+    void compact() noexcept;
 
     ServerConfig *getServerConfig() const;
 
     Client *client_;
 
+    // Scratch memory of the current request, released in one go by reset(). Declared before its users
+    std::array<std::byte, ARENA_SIZE> arenaBuffer_;
+    std::pmr::monotonic_buffer_resource arena_;
+
     State state_ = State::RequestLine;
 
     HttpHeaders headers_;
 
-    std::unique_ptr<URI> uri_;
+    ArenaPtr<URI> uri_;
+    ArenaPtr<MultipartParser> multipart_;
 
+    // Receive buffer of the connection: buffer_[begin_, end_) is input not parsed yet, the rest is free space
     std::string buffer_;
-    std::string body_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    // Input before this offset has already been searched for the delimiter the current stage waits for
+    size_t scanned_ = 0;
+    // Where the body goes while it is received
+    RequestBody body_;
+    ABodySink *bodySink_ = &body_;
+    // Body bytes received so far, including those dropped past maxBodySize_
+    size_t bodyLength_ = 0;
+    size_t maxBodySize_ = 0;
+    ChunkedDecoder chunked_;
     std::string method_;
     std::string target_;
     std::string httpVersion_;
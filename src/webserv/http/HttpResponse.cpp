@@ -2,16 +2,26 @@
 
 #include <webserv/http/HttpConstants.hpp> // for getStatusCodeReason
 #include <webserv/log/Log.hpp>
+#include <webserv/main.hpp> // for CHUNK_SIZE
 
-#include <iomanip>
-#include <string> // for basic_string, operator+, string, char_traits, to_string
-#include <vector> // for vector
+#include <array>    // for array
+#include <charconv> // for to_chars
+#include <ctime> // for gmtime_r, strftime, time, tm
+#include <string>  // for basic_string, operator+, string, char_traits, to_string
+#include <utility> // for move
+#include <vector>  // for vector
+
+HttpResponse::HttpResponse() : arenaBuffer_(), arena_(arenaBuffer_.data(), arenaBuffer_.size()), headers_(&arena_) {}
 
-HttpResponse::HttpResponse() : headers_(std::make_unique<HttpHeaders>()) {}
 
 void HttpResponse::addHeader(const std::string &key, const std::string &value)
 {
-    headers_->add(key, value);
+    headers_.add(key, value);
+}
+
+void HttpResponse::addHeader(HttpHeaders::Field field, const std::string &value)
+{
+    headers_.add(field, value);
 }
 
 void HttpResponse::appendBody(const std::vector<uint8_t> &data)
@@ -41,30 +51,228 @@ void HttpResponse::setBody(const std::vector<uint8_t> &data)
         Log::warning("Attempt to set body on a completed HttpResponse");
         return;
     }
+    clearBodyFile();
+    clearSerialized();
     body_ = data;
     setComplete();
 }
 
 void HttpResponse::setBody(const std::string &body)
 {
+    clearBodyFile();
+    clearSerialized();
     body_.assign(body.begin(), body.end());
     setComplete();
 }
 
+/**
+ * length bytes of file starting at offset are sent as the body without being read into memory.
+ */
+void HttpResponse::setBodyFile(std::shared_ptr<const FileDescriptor> file, off_t offset, size_t length)
+{
+    if (complete_)
+    {
+        Log::warning("Attempt to set body on a completed HttpResponse");
+        return;
+    }
+    clearBodyFile();
+    clearSerialized();
+    body_.clear();
+    bodyFile_ = std::move(file);
+    bodyFileOffset_ = offset;
+    bodyFileLength_ = length;
+    setComplete();
+}
+
+/**
+ * The response consists of the status line and per-connection headers followed by fieldsAndBody as is; headers added
+ * to this response are not sent.
+ */
+void HttpResponse::setSerialized(std::shared_ptr<const std::vector<uint8_t>> fieldsAndBody)
+{
+    if (complete_)
+    {
+        Log::warning("Attempt to set body on a completed HttpResponse");
+        return;
+    }
+    clearBodyFile();
+    body_.clear();
+    serialized_ = std::move(fieldsAndBody);
+    setComplete();
+}
+
+/**
+ * Marks the response ready to send while its body is still being produced; the body follows through appendStream().
+ * A chunked stream frames every piece as a chunk, otherwise the body is delimited by a Content-Length the producer set
+ * or by closing the connection.
+ */
+void HttpResponse::startStream(bool chunked)
+{
+    if (complete_)
+    {
+        Log::warning("Attempt to stream a completed HttpResponse");
+        return;
+    }
+    clearBodyFile();
+    clearSerialized();
+    body_.clear();
+    stream_ = Stream::Open;
+    chunked_ = chunked;
+    if (chunked)
+    {
+        headers_.add(HttpHeaders::Field::TransferEncoding, "chunked");
+    }
+    setComplete();
+}
+
+/**
+ * Queues the next piece of a streamed body. The client is woken up again if it had sent everything before.
+ */
+void HttpResponse::appendStream(std::string_view data)
+{
+    if (stream_ != Stream::Open || data.empty())
+    {
+        return;
+    }
+    bool wasDrained = body_.empty();
+    if (chunked_)
+    {
+        std::array<char, sizeof(size_t) * 2> size{};
+        char *end = std::to_chars(size.data(), size.data() + size.size(), data.size(), 16).ptr;
+        body_.insert(body_.end(), size.data(), end);
+        body_.insert(body_.end(), Http::Protocol::CRLF.begin(), Http::Protocol::CRLF.end());
+        body_.insert(body_.end(), data.begin(), data.end());
+        body_.insert(body_.end(), Http::Protocol::CRLF.begin(), Http::Protocol::CRLF.end());
+    }
+    else
+    {
+        body_.insert(body_.end(), data.begin(), data.end());
+    }
+    if (wasDrained)
+    {
+        setComplete();
+    }
+}
+
+void HttpResponse::endStream()
+{
+    if (stream_ != Stream::Open)
+    {
+        return;
+    }
+    if (chunked_)
+    {
+        constexpr std::string_view lastChunk = "0\r\n\r\n";
+        body_.insert(body_.end(), lastChunk.begin(), lastChunk.end());
+    }
+    stream_ = Stream::Ended;
+    setComplete();
+}
+
+/**
+ * Ends a stream whose producer failed. A chunked body then lacks its last chunk, so the client can tell.
+ */
+void HttpResponse::abortStream()
+{
+    if (stream_ != Stream::Open)
+    {
+        return;
+    }
+    stream_ = Stream::Aborted;
+    keepAlive_ = false;
+    setComplete();
+}
+
+/**
+ * Called by the client once everything queued has been sent. Drops the sent bytes and lets the producer continue.
+ */
+void HttpResponse::drained()
+{
+    body_.clear();
+    if (onDrain_ != nullptr)
+    {
+        onDrain_();
+    }
+}
+
+void HttpResponse::clearBodyFile() noexcept
+{
+    bodyFile_.reset();
+    bodyFileOffset_ = 0;
+    bodyFileLength_ = 0;
+}
+
+void HttpResponse::clearSerialized() noexcept
+{
+    serialized_.reset();
+}
+
 void HttpResponse::setStatus(uint16_t statusCode)
 {
     statusCode_ = statusCode;
 }
 
+void HttpResponse::setKeepAlive(bool keepAlive)
+{
+    // The connection header is owned by the client connection, not by handlers or CGI output
+    headers_.remove(HttpHeaders::Field::Connection);
+    keepAlive_ = keepAlive;
+}
+
+void HttpResponse::reset()
+{
+    clearBodyFile();
+    clearSerialized();
+    head_.clear();
+    body_.clear();
+    headers_ = HttpHeaders(&arena_);
+    arena_.release();
+    onDrain_ = nullptr;
+    stream_ = Stream::None;
+    chunked_ = false;
+    complete_ = false;
+    keepAlive_ = false;
+    statusCode_ = Http::StatusCode::OK;
+}
+
+/**
+ * Like reset(), for when the connection ends; a body buffer grown past Constants::CHUNK_SIZE is freed.
+ */
+void HttpResponse::clear()
+{
+    reset();
+    if (body_.capacity() > Constants::CHUNK_SIZE)
+    {
+        std::vector<uint8_t>().swap(body_);
+    }
+}
+
 void HttpResponse::setComplete()
 {
     complete_ = true;
+    if (onComplete_ != nullptr)
+    {
+        onComplete_();
+    }
 }
 
 void HttpResponse::setError(uint16_t statusCode)
 {
     statusCode_ = statusCode;
-    complete_ = true;
+    setComplete();
+}
+
+/**
+ * callback runs every time the response is marked complete, so its owner can start sending it.
+ */
+void HttpResponse::onComplete(std::function<void()> callback)
+{
+    onComplete_ = std::move(callback);
+}
+
+void HttpResponse::onDrain(std::function<void()> callback)
+{
+    onDrain_ = std::move(callback);
 }
 
 bool HttpResponse::isComplete() const noexcept
@@ -72,14 +280,34 @@ bool HttpResponse::isComplete() const noexcept
     return complete_;
 }
 
-const HttpHeaders &HttpResponse::getHeaders() const noexcept
+bool HttpResponse::isKeepAlive() const noexcept
+{
+    return keepAlive_;
+}
+
+bool HttpResponse::hasBodyFile() const noexcept
+{
+    return bodyFile_ != nullptr;
+}
+
+int HttpResponse::getBodyFileFd() const noexcept
+{
+    return bodyFile_ != nullptr ? bodyFile_->get() : -1;
+}
+
+off_t HttpResponse::getBodyFileOffset() const noexcept
+{
+    return bodyFileOffset_;
+}
+
+size_t HttpResponse::getBodySize() const noexcept
 {
-    return *headers_;
+    return hasBodyFile() ? bodyFileLength_ : getBody().size();
 }
 
-std::string HttpResponse::getContentLengthHeader() const
+const HttpHeaders &HttpResponse::getHeaders() const noexcept
 {
-    return "Content-Length: " + std::to_string(body_.size()) + "\r\n";
+    return headers_;
 }
 
 uint16_t HttpResponse::getStatusCode() const noexcept
@@ -87,36 +315,53 @@ uint16_t HttpResponse::getStatusCode() const noexcept
     return statusCode_;
 }
 
-std::string HttpResponse::getDateHeader()
+HttpResponse::Stream HttpResponse::getStream() const noexcept
 {
-    time_t now = time(nullptr);
-    struct tm *gmt = gmtime(&now);
+    return stream_;
+}
 
-    std::ostringstream oss;
-    oss << std::put_time(gmt, "%a, %d %b %Y %H:%M:%S GMT");
+void HttpResponse::appendDateHeader(std::string &head)
+{
+    time_t now = time(nullptr);
+    struct tm gmt{};
+    gmtime_r(&now, &gmt);
 
-    return "Date: " + oss.str() + "\r\n";
+    std::array<char, 64> date{};
+    size_t length = strftime(date.data(), date.size(), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &gmt);
+    head.append(date.data(), length);
 }
 
-std::vector<uint8_t> HttpResponse::toBytes(long offset) const
+const std::vector<uint8_t> &HttpResponse::getBody() const noexcept
 {
-    std::string headerStr;
-    std::string reason;
-
-    reason = Http::getStatusCodeReason(statusCode_);
+    return serialized_ != nullptr ? *serialized_ : body_;
+}
 
-    headerStr = "HTTP/1.1 " + std::to_string(statusCode_) + " " + reason + "\r\n"; // todo: status line
-    if (headers_->get("Content-Length").empty())
+/**
+ * Serializes the status line and headers once, on first use when the response is about to be sent. The result is
+ * kept until reset() so partial writes never rebuild it.
+ */
+const std::string &HttpResponse::getHead()
+{
+    if (!head_.empty())
     {
-        headers_->add("Content-Length", std::to_string(body_.size()));
+        return head_;
     }
-    headerStr += getDateHeader();
-    headerStr += "Connection: close\r\n";
-    headerStr += "Server: Webserv/1.0\r\n";
-
-    headerStr += headers_->toString();
-
-    std::vector<uint8_t> responseData(headerStr.begin(), headerStr.end());
-    responseData.insert(responseData.end(), body_.begin(), body_.end());
-    return {responseData.begin() + offset, responseData.end()};
-}
\ No newline at end of file
+    if (serialized_ == nullptr && stream_ == Stream::None && !headers_.has(HttpHeaders::Field::ContentLength))
+    {
+        headers_.add(HttpHeaders::Field::ContentLength, std::to_string(getBodySize()));
+    }
+    // Built in place, so head_ keeps its capacity from one response of the connection to the next
+    head_ += "HTTP/1.1 ";
+    head_ += std::to_string(statusCode_);
+    head_ += ' ';
+    head_ += Http::getStatusCodeReason(statusCode_);
+    head_ += "\r\n";
+    appendDateHeader(head_);
+    head_ += keepAlive_ ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    head_ += "Server: Webserv/1.0\r\n";
+    if (serialized_ == nullptr)
+    {
+        headers_.appendTo(head_);
+    }
+    return head_;
+}
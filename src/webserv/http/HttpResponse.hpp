@@ -1,55 +1,112 @@
 #pragma once
 
-#include <webserv/http/HttpHeaders.hpp> // for HttpHeaders
-#include <webserv/log/Log.hpp>          // for LOCATION, Log
-
-#include <cstdint> // for uint8_t, uint16_t
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <webserv/http/HttpHeaders.hpp>     // for HttpHeaders
+#include <webserv/log/Log.hpp>              // for LOCATION, Log
+#include <webserv/utils/FileDescriptor.hpp> // for FileDescriptor
+
+#include <array>           // for array
+#include <cstddef>         // for size_t, byte
+#include <cstdint>         // for uint8_t, uint16_t
+#include <functional>      // for function
+#include <memory>          // for shared_ptr
+#include <memory_resource> // for monotonic_buffer_resource
+#include <string>          // for string
+#include <string_view>     // for string_view
+#include <vector>          // for vector
+
+#include <sys/types.h> // for off_t
 
 class Client;
 
 class HttpResponse
 {
   public:
+    enum class Stream : uint8_t
+    {
+        None,   // The body is complete before the response is sent
+        Open,   // The head is sent while the body is still being produced
+        Ended,  // The producer has appended all of the body
+        Aborted // The producer failed; the connection is closed once what was queued has been sent
+    };
+
     HttpResponse();
 
-    HttpResponse(const HttpResponse &other) = delete;                 // Disable copy constructor
-    HttpResponse &operator=(const HttpResponse &other) = delete;      // Disable copy assignment
-    HttpResponse(HttpResponse &&other) noexcept = default;            // Move constructor
-    HttpResponse &operator=(HttpResponse &&other) noexcept = default; // Move assignment
+    HttpResponse(const HttpResponse &other) = delete;                // Disable copy constructor
+    HttpResponse &operator=(const HttpResponse &other) = delete;     // Disable copy assignment
+    HttpResponse(HttpResponse &&other) noexcept = delete;            // The headers point into arenaBuffer_
+    HttpResponse &operator=(HttpResponse &&other) noexcept = delete; // The headers point into arenaBuffer_
 
     ~HttpResponse() = default;
 
     void addHeader(const std::string &key, const std::string &value);
+    void addHeader(HttpHeaders::Field field, const std::string &value);
 
     void appendBody(const std::vector<uint8_t> &data);
     void appendBody(const std::string &body);
 
     void setBody(const std::vector<uint8_t> &data);
     void setBody(const std::string &body);
+    void setBodyFile(std::shared_ptr<const FileDescriptor> file, off_t offset, size_t length);
+    void setSerialized(std::shared_ptr<const std::vector<uint8_t>> fieldsAndBody);
+
+    void startStream(bool chunked);
+    void appendStream(std::string_view data);
+    void endStream();
+    void abortStream();
+    void drained();
 
     void setComplete();
     void setError(uint16_t statusCode);
+    void onComplete(std::function<void()> callback);
+    void onDrain(std::function<void()> callback);
 
     void setStatus(uint16_t statusCode);
+    void setKeepAlive(bool keepAlive);
+    void reset();
+    void clear();
 
     [[nodiscard]] bool isComplete() const noexcept;
+    [[nodiscard]] bool isKeepAlive() const noexcept;
+    [[nodiscard]] bool hasBodyFile() const noexcept;
+
+    [[nodiscard]] int getBodyFileFd() const noexcept;
+    [[nodiscard]] off_t getBodyFileOffset() const noexcept;
+    [[nodiscard]] size_t getBodySize() const noexcept;
 
     [[nodiscard]] uint16_t getStatusCode() const noexcept;
+    [[nodiscard]] Stream getStream() const noexcept;
 
     [[nodiscard]] const HttpHeaders &getHeaders() const noexcept;
 
-    [[nodiscard]] std::vector<uint8_t> toBytes(long offset = 0) const;
+    [[nodiscard]] const std::vector<uint8_t> &getBody() const noexcept;
+    [[nodiscard]] const std::string &getHead();
 
   private:
-    [[nodiscard]] std::string getStatusLine() const;
-    [[nodiscard]] std::string getContentLengthHeader() const;
-    [[nodiscard]] static std::string getDateHeader();
+    static constexpr size_t ARENA_SIZE = 2048;
+
+    static void appendDateHeader(std::string &head);
+    void clearBodyFile() noexcept;
+    void clearSerialized() noexcept;
+
+    // Memory of the header fields, released in one go by reset(). Declared before its users
+    std::array<std::byte, ARENA_SIZE> arenaBuffer_;
+    std::pmr::monotonic_buffer_resource arena_;
 
+    std::string head_;
     std::vector<uint8_t> body_;
-    std::unique_ptr<HttpHeaders> headers_;
+    // Static file bodies are not loaded into memory, the client streams them with sendfile()
+    std::shared_ptr<const FileDescriptor> bodyFile_;
+    off_t bodyFileOffset_ = 0;
+    size_t bodyFileLength_ = 0;
+    // Header fields and body serialized ahead of time and shared with the hot file cache; sent after the status line
+    std::shared_ptr<const std::vector<uint8_t>> serialized_;
+    HttpHeaders headers_;
+    std::function<void()> onComplete_ = nullptr;
+    // Set by the producer of a streamed body, to be told when the client has sent everything queued so far
+    std::function<void()> onDrain_ = nullptr;
+    Stream stream_ = Stream::None;
+    bool chunked_ = false;
     bool complete_ = false;
+    bool keepAlive_ = false;
     uint16_t statusCode_ = 200;
 };
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <webserv/http/RequestBody.hpp>
+
+#include <webserv/log/Log.hpp> // for Log, LOCATION
+#include <webserv/main.hpp>    // for CHUNK_SIZE
+
+#include <algorithm> // for min
+#include <cerrno>    // for errno, EINTR
+#include <cstdlib>   // for mkostemp
+#include <cstring>   // for strerror
+#include <stdexcept> // for runtime_error
+#include <vector>    // for vector
+
+#include <fcntl.h>  // for O_CLOEXEC
+#include <unistd.h> // for close, pread, unlink, write
+
+RequestBody::~RequestBody()
+{
+    reset();
+}
+
+/**
+ * Prepares for the body of a new request: up to memoryLimit bytes are kept in memory, beyond that the body goes to a
+ * temporary file in tempDir. A limit of 0 writes every body to a file.
+ */
+void RequestBody::open(size_t memoryLimit, const std::string &tempDir)
+{
+    reset();
+    memoryLimit_ = memoryLimit;
+    tempDir_ = tempDir;
+}
+
+void RequestBody::write(std::string_view data)
+{
+    if (fd_ == -1 && memory_.size() + data.size() > memoryLimit_)
+    {
+        spool();
+    }
+    size_ += data.size();
+    if (fd_ == -1)
+    {
+        memory_.append(data);
+        return;
+    }
+    while (!data.empty())
+    {
+        ssize_t written = ::write(fd_, data.data(), data.size());
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            Log::error("Failed to write request body to temporary file: " + std::string(std::strerror(errno)));
+            throw std::runtime_error("Failed to write request body to temporary file");
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+/**
+ * Moves what is in memory so far to a new temporary file, which is unlinked right away so it disappears with its
+ * descriptor however the request ends.
+ */
+void RequestBody::spool()
+{
+    std::string path = tempDir_ + "/webserv-body-XXXXXX";
+    std::vector<char> pathBuffer(path.begin(), path.end());
+    pathBuffer.push_back('\0');
+    fd_ = mkostemp(pathBuffer.data(), O_CLOEXEC);
+    if (fd_ == -1)
+    {
+        Log::error("Failed to create temporary file for request body in " + tempDir_ + ": "
+                   + std::string(std::strerror(errno)));
+        throw std::runtime_error("Failed to create temporary file for request body");
+    }
+    unlink(pathBuffer.data());
+    Log::debug("Request body exceeds " + std::to_string(memoryLimit_) + " bytes, spooling to a temporary file");
+    std::string buffered;
+    buffered.swap(memory_);
+    size_ -= buffered.size();
+    write(buffered);
+}
+
+size_t RequestBody::size() const noexcept
+{
+    return size_;
+}
+
+bool RequestBody::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+bool RequestBody::isSpooled() const noexcept
+{
+    return fd_ != -1;
+}
+
+/**
+ * Returns up to scratch.size() bytes of the body starting at offset, or an empty view past its end. A body in memory
+ * is returned as a view of it, one in a file is read into scratch.
+ */
+std::string_view RequestBody::read(size_t offset, std::span<char> scratch) const
+{
+    if (offset >= size_)
+    {
+        return {};
+    }
+    size_t length = std::min(scratch.size(), size_ - offset);
+    if (fd_ == -1)
+    {
+        return std::string_view(memory_).substr(offset, length);
+    }
+    ssize_t bytesRead = pread(fd_, scratch.data(), length, static_cast<off_t>(offset));
+    if (bytesRead < 0)
+    {
+        Log::error("Failed to read request body from temporary file: " + std::string(std::strerror(errno)));
+        throw std::runtime_error("Failed to read request body from temporary file");
+    }
+    return {scratch.data(), static_cast<size_t>(bytesRead)};
+}
+
+/**
+ * The whole body as one string. Reads it back into memory when it was spooled, so only for bodies known to be small.
+ */
+std::string RequestBody::toString() const
+{
+    if (fd_ == -1)
+    {
+        return memory_;
+    }
+    std::string result(size_, '\0');
+    size_t offset = 0;
+    while (offset < size_)
+    {
+        std::string_view piece = read(offset, std::span<char>(result).subspan(offset));
+        if (piece.empty())
+        {
+            break;
+        }
+        offset += piece.size();
+    }
+    result.resize(offset);
+    return result;
+}
+
+void RequestBody::reset() noexcept
+{
+    if (fd_ != -1)
+    {
+        close(fd_);
+        fd_ = -1;
+    }
+    memory_.clear();
+    size_ = 0;
+}
+
+/**
+ * Frees the memory buffer when a large limit let it grow past Constants::CHUNK_SIZE, for idle pooled clients.
+ */
+void RequestBody::shrink() noexcept
+{
+    if (memory_.capacity() > Constants::CHUNK_SIZE)
+    {
+        std::string().swap(memory_);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <webserv/http/ABodySink.hpp> // for ABodySink
+
+#include <cstddef>     // for size_t
+#include <span>        // for span
+#include <string>      // for string
+#include <string_view> // for string_view
+
+/**
+ * The default body sink: keeps the body in memory up to a limit, in the spirit of nginx's client_body_buffer_size,
+ * and moves it to an unlinked temporary file once it grows past that. Memory per request stays bounded by the limit
+ * no matter how large the body is.
+ */
+class RequestBody : public ABodySink
+{
+  public:
+    RequestBody() = default;
+    ~RequestBody() override;
+
+    RequestBody(const RequestBody &other) = delete;
+    RequestBody &operator=(const RequestBody &other) = delete;
+    RequestBody(RequestBody &&other) noexcept = delete;
+    RequestBody &operator=(RequestBody &&other) noexcept = delete;
+
+    void open(size_t memoryLimit, const std::string &tempDir);
+    void write(std::string_view data) override;
+
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] bool isSpooled() const noexcept;
+    [[nodiscard]] std::string_view read(size_t offset, std::span<char> scratch) const;
+    [[nodiscard]] std::string toString() const;
+
+    void reset() noexcept;
+    void shrink() noexcept;
+
+  private:
+    void spool();
+
+    std::string memory_;
+    int fd_ = -1;
+    size_t size_ = 0;
+    size_t memoryLimit_ = 0;
+    std::string tempDir_;
+};
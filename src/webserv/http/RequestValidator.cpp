@@ -37,11 +37,11 @@ std::optional<RequestValidator::ValidationError> RequestValidator::validate() co
 
 std::optional<RequestValidator::ValidationError> RequestValidator::validateHostHeader() const
 {
-    if (!request->getHeaders().has("Host"))
+    if (!request->getHeaders().has(HttpHeaders::Field::Host))
     {
         return ValidationError{.statusCode = 400, .message = "Bad Request: Missing Host header"};
     }
-    std::string hostHeader = request->getHeaders().get("Host");
+    std::string hostHeader(request->getHeaders().get(HttpHeaders::Field::Host));
     // Basic validation: check if host header is not empty
     if (hostHeader.empty())
     {
@@ -63,7 +63,7 @@ std::optional<RequestValidator::ValidationError> RequestValidator::validateHttpV
 
 std::optional<RequestValidator::ValidationError> RequestValidator::validateContentLength() const
 {
-    size_t bodySize = request->getBody().size();
+    size_t bodySize = request->getBodyLength();
     size_t maxBodySize = config->get<size_t>("client_max_body_size").value_or(Http::Protocol::MAX_BODY_SIZE);
     if (bodySize > maxBodySize) // exceed server limit
     {
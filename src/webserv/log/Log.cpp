@@ -8,6 +8,7 @@
 #include <exception> // for exception
 #include <iostream>  // for basic_ostream, operator<<, cerr
 #include <memory>    // for allocator, unique_ptr, make_unique
+#include <mutex>     // for lock_guard, recursive_mutex
 #include <utility>   // for pair
 
 Log::Log()
@@ -19,6 +20,7 @@ Log::Log()
 void Log::setStdoutChannel()
 {
     Log &log = getInstance();
+    std::lock_guard<std::recursive_mutex> lock(log.mutex_);
     if (log.channels_.contains("stdout"))
     {
         log.channels_.erase("stdout");
@@ -36,6 +38,7 @@ void Log::setStdoutChannel()
 void Log::setFileChannel(const std::string &filename)
 {
     Log &log = getInstance();
+    std::lock_guard<std::recursive_mutex> lock(log.mutex_);
     if (log.channels_.contains("file"))
     {
         log.channels_.erase("file");
@@ -53,6 +56,7 @@ void Log::setFileChannel(const std::string &filename)
 void Log::clearChannels()
 {
     Log &log = getInstance();
+    std::lock_guard<std::recursive_mutex> lock(log.mutex_);
     log.channels_.clear();
 }
 
@@ -64,6 +68,7 @@ Log &Log::getInstance()
 
 void Log::log(Level level, const std::string &message, const std::map<std::string, std::string> &context)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     for (auto &it : channels_)
     {
         std::string statusBackup = _statusMessage;
@@ -101,6 +106,15 @@ void Log::trace(const std::string &message, const std::map<std::string, std::str
     getInstance().log(Level::Trace, message, context);
 }
 
+void Log::trace(const Location &location, const std::map<std::string, std::string> &context)
+{
+    if constexpr (COMPILE_TIME_LOG_LEVEL > Level::Trace)
+    {
+        return;
+    }
+    getInstance().log(Level::Trace, location.toString(), context);
+}
+
 void Log::debug(const std::string &message, const std::map<std::string, std::string> &context)
 {
     if constexpr (COMPILE_TIME_LOG_LEVEL > Level::Debug)
@@ -146,6 +160,11 @@ void Log::fatal(const std::string &message, const std::map<std::string, std::str
     getInstance().log(Level::Fatal, message, context);
 }
 
+std::string Log::Location::toString() const
+{
+    return std::string(extractFilename(file)) + ":" + std::to_string(line) + " (" + function + ")";
+}
+
 std::string Log::logLevelToString(Level level)
 {
 
@@ -193,6 +212,7 @@ bool Log::_statusActive = false;
 
 void Log::status(const std::string &message)
 {
+    std::lock_guard<std::recursive_mutex> lock(getInstance().mutex_);
     _statusMessage = message;
     _statusActive = true;
 
@@ -209,6 +229,7 @@ void Log::status(const std::string &message)
 
 void Log::clearStatus()
 {
+    std::lock_guard<std::recursive_mutex> lock(getInstance().mutex_);
     if (_statusActive)
     {
         _statusActive = false;
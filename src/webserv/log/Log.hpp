@@ -8,6 +8,7 @@
 #include <ios>           // for ios_base
 #include <map>           // for map
 #include <memory>        // for unique_ptr
+#include <mutex>         // for recursive_mutex
 #include <string>        // for string, basic_string, hash
 #include <string_view>   // for string_view
 #include <unordered_map> // for unordered_map
@@ -28,8 +29,8 @@ constexpr const char *extractFilename(const char *path)
     return filename;
 }
 
-#define LOCATION                                                                                                       \
-    (std::string(extractFilename(__FILE__)) + ":" + std::to_string(__LINE__) + " (" + std::string(__FUNCTION__) + ")")
+// Formatted only when the message is actually logged, so trace points cost nothing below the compile-time level
+#define LOCATION (Log::Location{.file = __FILE__, .line = __LINE__, .function = __FUNCTION__})
 
 class Log
 {
@@ -49,6 +50,15 @@ class Log
         Fatal = 5
     };
 
+    struct Location
+    {
+        const char *file;
+        int line;
+        const char *function;
+
+        [[nodiscard]] std::string toString() const;
+    };
+
     void log(Level level, const std::string &message, const std::map<std::string, std::string> &context);
 
     static constexpr Log::Level COMPILE_TIME_LOG_LEVEL = Log::Level::LOG_LEVEL_DEFINE;
@@ -59,6 +69,7 @@ class Log
     static int getElapsedTime();
 
     static void trace(const std::string &message, const std::map<std::string, std::string> &context = {});
+    static void trace(const Location &location, const std::map<std::string, std::string> &context = {});
     static void debug(const std::string &message, const std::map<std::string, std::string> &context = {});
     static void info(const std::string &message, const std::map<std::string, std::string> &context = {});
     static void warning(const std::string &message, const std::map<std::string, std::string> &context = {});
@@ -84,6 +95,8 @@ class Log
     static Log &getInstance();
 
     std::chrono::steady_clock::time_point start_time_;
+    // Serializes channel output and the status line between reactor threads
+    std::recursive_mutex mutex_;
     std::unordered_map<std::string, std::unique_ptr<Channel>> channels_;
 
     struct LevelMapping
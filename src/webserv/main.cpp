@@ -2,6 +2,9 @@
 #include <webserv/config/validation/ConfigValidator.hpp>  // for ConfigValidator
 #include <webserv/config/validation/ValidationResult.hpp> // for ValidationResult
 #include <webserv/log/Log.hpp>                            // for Log
+#include <webserv/main.hpp>                               // for WORKER_THREADS, WORKER_PROCESSES
+#include <webserv/server/Master.hpp>                      // for Master
+#include <webserv/server/ReactorPool.hpp>                 // for ReactorPool
 #include <webserv/server/Server.hpp>                      // for Server
 
 #include <array>
@@ -52,10 +55,25 @@ int main(int argc, char **argv)
         }
 
         Log::debug("ConfigManager initialized successfully.");
-        Server server(configManager);
+        const GlobalConfig *globalConfig = configManager.getGlobalConfig();
+        int workerThreads = globalConfig->get<int>("worker_threads").value_or(WORKER_THREADS);
+        int workerProcesses = globalConfig->get<int>("worker_processes").value_or(WORKER_PROCESSES);
+        if (workerProcesses > 1)
+        {
+            if (workerThreads > 1)
+            {
+                Log::warning("worker_threads is ignored when worker_processes is set");
+            }
+            Master master(configManager, static_cast<size_t>(workerProcesses));
+            master.run();
+            return 0;
+        }
+
+        ReactorPool reactors(configManager, static_cast<size_t>(workerThreads));
 
         ::signal(SIGINT, Server::signalHandler);
-        server.run();
+        ::signal(SIGTERM, Server::signalHandler);
+        reactors.run();
         return 0;
     }
     catch (const std::exception &e)
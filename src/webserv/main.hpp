@@ -10,8 +10,78 @@
 
 #define CLIENT_TIMEOUT 30
 
+#define KEEPALIVE_TIMEOUT 75
+
+#define MAX_KEEPALIVE_TIMEOUT 3600
+
+#define KEEPALIVE_REQUESTS 1000
+
+#define MAX_KEEPALIVE_REQUESTS 1000000
+
+#define WORKER_THREADS 1
+
+#define MAX_WORKER_THREADS 256
+
+#define WORKER_PROCESSES 1
+
+#define MAX_WORKER_PROCESSES 256
+
+#define WORKER_MIN_UPTIME 1
+
+#define WORKER_RESTART_BACKOFF_MAX 30
+
+#define WORKER_STOP_TIMEOUT 5
+
+#define OPEN_FILE_CACHE 1024
+
+#define MAX_OPEN_FILE_CACHE 65536
+
+#define OPEN_FILE_CACHE_VALID 5
+
+#define MAX_OPEN_FILE_CACHE_VALID 3600
+
+#define HOT_FILE_CACHE (8UL * 1024 * 1024)
+
+#define HOT_FILE_CACHE_MAX_FILE (64UL * 1024)
+
+#define ACCEPT_BATCH 64
+
+#define MAX_ACCEPT_BATCH 4096
+
+#define EVENT_BACKEND "epoll"
+
+#define CLIENT_BODY_BUFFER_SIZE (64UL * 1024)
+
+#define CGI_POOL "off"
+
+#define CGI_POOL_MIN 1
+
+#define CGI_POOL_MAX 4
+
+#define MAX_CGI_POOL 256
+
+#define CGI_POOL_REQUESTS 500
+
+#define MAX_CGI_POOL_REQUESTS 1000000
+
+#define CGI_POOL_IDLE_TIMEOUT 60
+
+#define MAX_CGI_POOL_IDLE_TIMEOUT 86400
+
+#define CLIENT_BODY_TEMP_PATH "/tmp"
+
 namespace Constants
 {
 constexpr static size_t BUFFER_SIZE = 8192; // 8kb
 constexpr static size_t CHUNK_SIZE = 65536; // 64kb
+constexpr static size_t PIPELINE_BUFFER_SIZE = 65536; // 64kb
+constexpr static size_t STREAM_BUFFER_SIZE = 65536; // 64kb of streamed body queued before its producer pauses
+constexpr static int IDLE_WAIT_MS = 1000;
+constexpr static int ACCEPT_PAUSE_MS = 100;
+constexpr static size_t IO_BUDGET = 262144; // 256kb per socket callback
+constexpr static size_t CLIENT_POOL_SIZE = 256; // closed clients kept per reactor
+constexpr static size_t UPSTREAM_KEEPALIVE = 32; // idle backend connections kept per address and reactor
+constexpr static int CGI_POOL_REAP_MS = 1000; // how often idle CGI workers are checked
+constexpr static size_t CGI_POOL_FAILURES = 3; // CGI workers exiting at startup in a row before their group backs off
+constexpr static size_t CGI_POOL_BACKOFF_MAX_S = 60; // longest a failing CGI worker group starts no workers
 } // namespace Constants
\ No newline at end of file
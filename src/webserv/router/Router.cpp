@@ -8,6 +8,7 @@
 #include <webserv/handler/CgiProcess.hpp>              // for CgiProcess
 #include <webserv/handler/DeleteHandler.hpp>
 #include <webserv/handler/ErrorHandler.hpp>
+#include <webserv/handler/FastCgiHandler.hpp>  // for FastCgiHandler
 #include <webserv/handler/FileHandler.hpp>     // for FileHandler
 #include <webserv/handler/RedirectHandler.hpp> // for RedirectHandler
 #include <webserv/handler/URI.hpp>             // for URI
@@ -15,9 +16,9 @@
 #include <webserv/http/HttpRequest.hpp>        // for HttpRequest
 #include <webserv/http/RequestValidator.hpp>
 #include <webserv/log/Log.hpp>       // for Log, LOCATION
+#include <webserv/main.hpp>          // for CGI_POOL
 
 #include <exception> // for exception
-#include <memory>    // for unique_ptr, make_unique
 #include <optional>  // for optional
 #include <ranges>    // for __find_fn, find
 #include <string>    // for basic_string, string, operator+
@@ -30,7 +31,7 @@ Router::Router(Client *client) : client_(client)
     Log::trace(LOCATION);
 }
 
-std::unique_ptr<AHandler> Router::handleRequest()
+ArenaPtr<AHandler> Router::handleRequest()
 {
     Log::trace(LOCATION);
 
@@ -39,8 +40,8 @@ std::unique_ptr<AHandler> Router::handleRequest()
 
     const AConfig *config = request.getUri().getConfig();
 
-    auto validator = std::make_unique<RequestValidator>(config, &request);
-    auto error = validator->validate();
+    RequestValidator validator(config, &request);
+    auto error = validator.validate();
     if (error.has_value())
     {
         Log::warning(client_->getClientSocket()->toString() + ": request validation failed: " + error->message);
@@ -48,24 +49,35 @@ std::unique_ptr<AHandler> Router::handleRequest()
     }
     if (request.getUri().isRedirect())
     {
-        return std::make_unique<RedirectHandler>(request, response);
-    }
-    if (request.getMethod() == "DELETE"
-        && (!request.getUri().getConfig()->get<bool>("cgi_enabled").value_or(false) || !request.getUri().isCgi()))
-    {
-        return std::make_unique<DeleteHandler>(request, response);
+        return makeArena<RedirectHandler>(request.getArena(), request, response);
     }
     if (request.getUri().isUpload() && request.getMethod() == "POST")
     {
         Log::debug("Handling file upload");
-        return std::make_unique<UploadHandler>(request, response);
+        return makeArena<UploadHandler>(request.getArena(), request, response);
+    }
+    // The backend serves every request for its location, whatever the method, except for uploads to upload_store
+    if (config->get<std::string>("fastcgi_pass").has_value())
+    {
+        Log::debug("Passing request to FastCGI backend");
+        return makeArena<FastCgiHandler>(request.getArena(), request, response);
+    }
+    if (request.getMethod() == "DELETE"
+        && (!request.getUri().getConfig()->get<bool>("cgi_enabled").value_or(false) || !request.getUri().isCgi()))
+    {
+        return makeArena<DeleteHandler>(request.getArena(), request, response);
     }
     if (request.getUri().isCgi() && request.getUri().getConfig()->get<bool>("cgi_enabled").value_or(false))
     {
+        if (config->get<std::string>("cgi_pool").value_or(CGI_POOL) == "fastcgi")
+        {
+            Log::debug("Passing request to the CGI worker pool");
+            return makeArena<FastCgiHandler>(request.getArena(), request, response);
+        }
         try
         {
             Log::debug("Starting CGI process");
-            return std::make_unique<CgiHandler>(request, response);
+            return makeArena<CgiHandler>(request.getArena(), request, response);
         }
         catch (const std::exception &e)
         {
@@ -77,7 +89,7 @@ std::unique_ptr<AHandler> Router::handleRequest()
     }
     else
     {
-        return std::make_unique<FileHandler>(request, response);
+        return makeArena<FileHandler>(request.getArena(), request, response);
     }
     return nullptr;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <webserv/http/HttpRequest.hpp>  // for HttpRequest
 #include <webserv/http/HttpResponse.hpp> // for HttpResponse
 #include <webserv/http/RequestValidator.hpp>
+#include <webserv/utils/ArenaPtr.hpp> // for ArenaPtr
 
 #include <memory> // for unique_ptr
 
@@ -17,7 +18,7 @@ class Router
 {
   public:
     Router(Client *client);
-    [[nodiscard]] std::unique_ptr<AHandler> handleRequest();
+    [[nodiscard]] ArenaPtr<AHandler> handleRequest();
 
   private:
     Client *client_;
@@ -0,0 +1,29 @@
+#include <webserv/server/AEventBackend.hpp>
+
+#include <webserv/log/Log.hpp>             // for Log
+#include <webserv/server/EpollBackend.hpp> // for EpollBackend
+#include <webserv/server/UringBackend.hpp> // for UringBackend
+
+#include <exception> // for exception
+#include <memory>    // for make_unique, unique_ptr
+#include <string>    // for operator+, string
+
+/**
+ * Creates the backend called name, "epoll" or "io_uring". io_uring falls back to epoll when the kernel does not
+ * provide it or lacks a feature it needs.
+ */
+std::unique_ptr<AEventBackend> AEventBackend::create(const std::string &name)
+{
+    if (name == "io_uring")
+    {
+        try
+        {
+            return std::make_unique<UringBackend>();
+        }
+        catch (const std::exception &e)
+        {
+            Log::warning("io_uring unavailable, falling back to epoll: " + std::string(e.what()));
+        }
+    }
+    return std::make_unique<EpollBackend>();
+}
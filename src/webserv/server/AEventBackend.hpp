@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>     // for uint32_t, uint64_t
+#include <memory>      // for unique_ptr
+#include <string>      // for string
+#include <string_view> // for string_view
+
+struct epoll_event;
+
+/**
+ * Readiness notification mechanism polled by a reactor. Interest is given as epoll event bits and events are reported
+ * as epoll_event, carrying the data passed to add() or modify(). Like the system calls they replace, the methods
+ * return -1 and set errno on failure.
+ */
+class AEventBackend
+{
+  public:
+    AEventBackend() = default;
+    virtual ~AEventBackend() = default;
+
+    AEventBackend(const AEventBackend &other) = delete;
+    AEventBackend &operator=(const AEventBackend &other) = delete;
+    AEventBackend(AEventBackend &&other) noexcept = delete;
+    AEventBackend &operator=(AEventBackend &&other) noexcept = delete;
+
+    static std::unique_ptr<AEventBackend> create(const std::string &name);
+
+    virtual int add(int fd, uint32_t events, uint64_t data) = 0;
+    virtual int modify(int fd, uint32_t events, uint64_t data) = 0;
+    virtual int remove(int fd) = 0;
+    virtual int wait(struct epoll_event *events, int maxEvents, int timeoutMs) = 0;
+
+    [[nodiscard]] virtual std::string_view getName() const noexcept = 0;
+};
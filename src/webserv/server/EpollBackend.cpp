@@ -0,0 +1,56 @@
+#include <webserv/server/EpollBackend.hpp>
+
+#include <webserv/log/Log.hpp> // for Log
+
+#include <stdexcept> // for runtime_error
+
+#include <fcntl.h>     // for O_CLOEXEC
+#include <sys/epoll.h> // for epoll_event, epoll_create1, epoll_ctl, epoll_wait, EPOLL_CTL_ADD, EPOLL_CTL_MOD, EPOLL_CTL_DEL
+#include <unistd.h>    // for close
+
+EpollBackend::EpollBackend() : epollFd_(epoll_create1(O_CLOEXEC))
+{
+    if (epollFd_ == -1)
+    {
+        Log::fatal("epoll_create1 failed");
+        throw std::runtime_error("epoll_create1 failed");
+    }
+}
+
+EpollBackend::~EpollBackend()
+{
+    close(epollFd_);
+}
+
+int EpollBackend::add(int fd, uint32_t events, uint64_t data)
+{
+    return control(EPOLL_CTL_ADD, fd, events, data);
+}
+
+int EpollBackend::modify(int fd, uint32_t events, uint64_t data)
+{
+    return control(EPOLL_CTL_MOD, fd, events, data);
+}
+
+int EpollBackend::remove(int fd)
+{
+    return epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int EpollBackend::wait(struct epoll_event *events, int maxEvents, int timeoutMs)
+{
+    return epoll_wait(epollFd_, events, maxEvents, timeoutMs);
+}
+
+std::string_view EpollBackend::getName() const noexcept
+{
+    return "epoll";
+}
+
+int EpollBackend::control(int operation, int fd, uint32_t events, uint64_t data) const
+{
+    struct epoll_event event{};
+    event.events = events;
+    event.data.u64 = data;
+    return epoll_ctl(epollFd_, operation, fd, &event);
+}
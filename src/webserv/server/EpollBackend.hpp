@@ -0,0 +1,32 @@
+#pragma once
+
+#include <webserv/server/AEventBackend.hpp> // for AEventBackend
+
+#include <cstdint>     // for uint32_t, uint64_t
+#include <string_view> // for string_view
+
+struct epoll_event;
+
+class EpollBackend : public AEventBackend
+{
+  public:
+    EpollBackend();
+    ~EpollBackend() override;
+
+    EpollBackend(const EpollBackend &other) = delete;
+    EpollBackend &operator=(const EpollBackend &other) = delete;
+    EpollBackend(EpollBackend &&other) noexcept = delete;
+    EpollBackend &operator=(EpollBackend &&other) noexcept = delete;
+
+    int add(int fd, uint32_t events, uint64_t data) override;
+    int modify(int fd, uint32_t events, uint64_t data) override;
+    int remove(int fd) override;
+    int wait(struct epoll_event *events, int maxEvents, int timeoutMs) override;
+
+    [[nodiscard]] std::string_view getName() const noexcept override;
+
+  private:
+    int epollFd_;
+
+    int control(int operation, int fd, uint32_t events, uint64_t data) const;
+};
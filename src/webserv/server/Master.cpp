@@ -0,0 +1,205 @@
+#include <webserv/server/Master.hpp>
+
+#include <webserv/config/ConfigManager.hpp> // for ConfigManager
+#include <webserv/log/Log.hpp>              // for Log, LOCATION
+#include <webserv/main.hpp>                 // for WORKER_MIN_UPTIME, WORKER_RESTART_BACKOFF_MAX, WORKER_STOP_TIMEOUT
+#include <webserv/server/Server.hpp>        // for Server
+#include <webserv/socket/ServerSocket.hpp>  // for ServerSocket
+
+#include <algorithm> // for any_of, min
+#include <atomic>    // for atomic
+#include <chrono>    // for steady_clock, seconds, milliseconds
+#include <csignal>   // for signal, kill, SIGINT, SIGTERM, SIGKILL
+#include <cstdlib>   // for exit, EXIT_FAILURE, EXIT_SUCCESS
+#include <exception> // for exception
+#include <stdexcept> // for runtime_error
+#include <string>    // for operator+, to_string, string
+#include <thread>    // for sleep_for
+
+#include <sys/wait.h> // for waitpid, WNOHANG, WIFSIGNALED, WTERMSIG, WEXITSTATUS
+#include <unistd.h>   // for fork
+
+std::atomic<int> Master::signum_ = 0;
+
+static inline std::string describeExit(int status)
+{
+    if (WIFSIGNALED(status))
+    {
+        return "was killed by signal " + std::to_string(WTERMSIG(status));
+    }
+    return "exited with status " + std::to_string(WEXITSTATUS(status));
+}
+
+Master::Master(const ConfigManager &configManager, size_t workers)
+    : configManager_(configManager), listeners_(Server::bindListeners(configManager))
+{
+    Log::trace(LOCATION);
+    if (listeners_.empty())
+    {
+        Log::fatal("No server sockets created.");
+        throw std::runtime_error("No server sockets created.");
+    }
+    workers_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        workers_.push_back({.id = i, .pid = -1, .failures = 0, .startedAt = {}, .restartAt = {}});
+    }
+}
+
+Master::~Master()
+{
+    stop();
+}
+
+void Master::signalHandler(int signum)
+{
+    if (signum == SIGINT || signum == SIGTERM)
+    {
+        signum_ = signum;
+    }
+}
+
+void Master::run()
+{
+    Log::trace(LOCATION);
+    ::signal(SIGINT, Master::signalHandler);
+    ::signal(SIGTERM, Master::signalHandler);
+
+    for (auto &worker : workers_)
+    {
+        spawn(worker);
+    }
+    Log::info("Master running " + std::to_string(workers_.size()) + " worker processes");
+
+    while (signum_ != SIGINT && signum_ != SIGTERM)
+    {
+        reap();
+        respawn();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // NOLINT
+    }
+    stop();
+    Log::info("Master stopped");
+}
+
+void Master::spawn(Worker &worker)
+{
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        ++worker.failures;
+        worker.restartAt = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        Log::error("Failed to fork worker " + std::to_string(worker.id));
+        return;
+    }
+    if (pid == 0)
+    {
+        runWorker(worker.id);
+    }
+    worker.pid = pid;
+    worker.startedAt = std::chrono::steady_clock::now();
+    Log::debug("Worker " + std::to_string(worker.id) + " started with PID " + std::to_string(pid));
+}
+
+void Master::runWorker(size_t id)
+{
+    ::signal(SIGINT, Server::signalHandler);
+    ::signal(SIGTERM, Server::signalHandler);
+    int status = EXIT_SUCCESS;
+    try
+    {
+        Server server(configManager_, std::move(listeners_), id, true);
+        server.run();
+    }
+    catch (const std::exception &e)
+    {
+        Log::error("Worker " + std::to_string(id) + " failed: " + std::string(e.what()));
+        status = EXIT_FAILURE;
+    }
+    std::exit(status); // NOLINT(concurrency-mt-unsafe)
+}
+
+void Master::reap()
+{
+    int status = 0;
+    pid_t pid = 0;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+    {
+        auto it = std::ranges::find_if(workers_, [pid](const Worker &worker) { return worker.pid == pid; });
+        if (it == workers_.end())
+        {
+            continue;
+        }
+        auto now = std::chrono::steady_clock::now();
+        it->pid = -1;
+        // Workers that die right after starting are restarted with an exponential backoff
+        if (now - it->startedAt < std::chrono::seconds(WORKER_MIN_UPTIME))
+        {
+            ++it->failures;
+        }
+        else
+        {
+            it->failures = 0;
+        }
+        int delay = 0;
+        if (it->failures > 0)
+        {
+            delay = std::min(1 << std::min(it->failures - 1, 16U), WORKER_RESTART_BACKOFF_MAX);
+        }
+        it->restartAt = now + std::chrono::seconds(delay);
+        Log::warning("Worker " + std::to_string(it->id) + " (PID " + std::to_string(pid) + ") " + describeExit(status)
+                     + ", restarting in " + std::to_string(delay) + "s");
+    }
+}
+
+void Master::respawn()
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto &worker : workers_)
+    {
+        if (worker.pid == -1 && now >= worker.restartAt)
+        {
+            spawn(worker);
+        }
+    }
+}
+
+void Master::stop()
+{
+    auto isAlive = [](const Worker &worker) { return worker.pid > 0; };
+    if (!std::ranges::any_of(workers_, isAlive))
+    {
+        return;
+    }
+    Log::info("Stopping worker processes...");
+    for (const auto &worker : workers_)
+    {
+        if (isAlive(worker))
+        {
+            ::kill(worker.pid, SIGTERM);
+        }
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(WORKER_STOP_TIMEOUT);
+    while (std::ranges::any_of(workers_, isAlive))
+    {
+        bool expired = std::chrono::steady_clock::now() >= deadline;
+        for (auto &worker : workers_)
+        {
+            if (!isAlive(worker))
+            {
+                continue;
+            }
+            if (expired)
+            {
+                Log::warning("Worker " + std::to_string(worker.id) + " did not stop in time, killing it");
+                ::kill(worker.pid, SIGKILL);
+            }
+            int status = 0;
+            if (waitpid(worker.pid, &status, expired ? 0 : WNOHANG) != 0)
+            {
+                worker.pid = -1;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // NOLINT
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <webserv/socket/ServerSocket.hpp> // for ServerSocket
+
+#include <atomic>    // for atomic
+#include <chrono>    // for steady_clock
+#include <cstddef>   // for size_t
+#include <memory>    // for unique_ptr
+#include <vector>    // for vector
+
+#include <sys/types.h> // for pid_t
+
+class ConfigManager;
+
+/**
+ * Prefork process model: the master binds every listener once, forks worker processes that each run their own
+ * Server event loop on the inherited listeners, and restarts workers that exit unexpectedly.
+ */
+class Master
+{
+  public:
+    Master() = delete;
+    Master(const ConfigManager &configManager, size_t workers);
+
+    Master(const Master &other) = delete;
+    Master &operator=(const Master &other) = delete;
+    Master(Master &&other) noexcept = delete;
+    Master &operator=(Master &&other) noexcept = delete;
+
+    ~Master();
+
+    static void signalHandler(int signum);
+
+    void run();
+
+  private:
+    struct Worker
+    {
+        size_t id;
+        pid_t pid;
+        unsigned int failures;
+        std::chrono::steady_clock::time_point startedAt;
+        std::chrono::steady_clock::time_point restartAt;
+    };
+
+    static std::atomic<int> signum_;
+    const ConfigManager &configManager_;
+    std::vector<std::unique_ptr<ServerSocket>> listeners_;
+    std::vector<Worker> workers_;
+
+    void spawn(Worker &worker);
+    [[noreturn]] void runWorker(size_t id);
+    void reap();
+    void respawn();
+    void stop();
+};
@@ -0,0 +1,64 @@
+#include <webserv/server/ReactorPool.hpp>
+
+#include <webserv/config/ConfigManager.hpp> // for ConfigManager
+#include <webserv/log/Log.hpp>              // for Log, LOCATION
+#include <webserv/server/Server.hpp>        // for Server
+
+#include <exception> // for exception
+#include <memory>    // for make_unique, unique_ptr
+#include <string>    // for operator+, to_string, string
+#include <thread>    // for thread
+#include <vector>    // for vector
+
+ReactorPool::ReactorPool(const ConfigManager &configManager, size_t size)
+{
+    Log::trace(LOCATION);
+    if (size == 0)
+    {
+        size = 1;
+    }
+    bool reusePort = size > 1;
+    reactors_.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        reactors_.emplace_back(std::make_unique<Server>(configManager, i, reusePort));
+    }
+}
+
+void ReactorPool::run()
+{
+    Log::trace(LOCATION);
+    std::vector<std::thread> threads;
+    threads.reserve(reactors_.size() - 1);
+    for (size_t i = 1; i < reactors_.size(); ++i)
+    {
+        Server *reactor = reactors_[i].get();
+        threads.emplace_back([reactor, i]() {
+            try
+            {
+                reactor->run();
+            }
+            catch (const std::exception &e)
+            {
+                Log::error("Reactor " + std::to_string(i) + " stopped: " + std::string(e.what()));
+            }
+        });
+    }
+    if (!threads.empty())
+    {
+        Log::info("Running " + std::to_string(reactors_.size()) + " reactor threads");
+    }
+
+    // The calling thread drives the first reactor, so a pool of one behaves exactly like a plain Server
+    reactors_.front()->run();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+size_t ReactorPool::size() const noexcept
+{
+    return reactors_.size();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <webserv/server/Server.hpp> // for Server
+
+#include <cstddef> // for size_t
+#include <memory>  // for unique_ptr
+#include <vector>  // for vector
+
+class ConfigManager;
+
+/**
+ * Runs one or more independent Server event loops, each on its own thread.
+ * Every reactor owns its epoll instance, listeners and clients; with more than one reactor the listeners are
+ * bound with SO_REUSEPORT so the kernel balances new connections across them.
+ */
+class ReactorPool
+{
+  public:
+    ReactorPool() = delete;
+    ReactorPool(const ConfigManager &configManager, size_t size);
+
+    ReactorPool(const ReactorPool &other) = delete;
+    ReactorPool &operator=(const ReactorPool &other) = delete;
+    ReactorPool(ReactorPool &&other) noexcept = delete;
+    ReactorPool &operator=(ReactorPool &&other) noexcept = delete;
+
+    ~ReactorPool() = default;
+
+    void run();
+
+    [[nodiscard]] size_t size() const noexcept;
+
+  private:
+    std::vector<std::unique_ptr<Server>> reactors_;
+};
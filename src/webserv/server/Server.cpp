@@ -2,15 +2,31 @@
 
 #include <webserv/client/Client.hpp>        // for Client
 #include <webserv/config/ConfigManager.hpp> // for ConfigManager
+#include <webserv/config/GlobalConfig.hpp>  // for GlobalConfig
 #include <webserv/config/ServerConfig.hpp>  // for ServerConfig
+#include <webserv/handler/CgiWorkerPool.hpp> // for CgiWorkerPool
 #include <webserv/log/Log.hpp>              // for Log, LOCATION
+#include <webserv/main.hpp>                 // for IDLE_WAIT_MS, ACCEPT_BATCH, ACCEPT_PAUSE_MS, CLIENT_POOL_SIZE, EVENT_BACKEND
+#include <webserv/server/AEventBackend.hpp> // for AEventBackend
 #include <webserv/socket/ASocket.hpp>      // for ASocket
 #include <webserv/socket/ClientSocket.hpp> // for ClientSocket
 #include <webserv/socket/ServerSocket.hpp> // for ServerSocket
+#include <webserv/socket/TimerSocket.hpp>  // for TimerSocket
+#include <webserv/socket/TimerWheel.hpp>   // for TimerWheel
+#include <webserv/socket/UpstreamPool.hpp> // for UpstreamPool
+#include <webserv/socket/WatchSocket.hpp>  // for WatchSocket
+#include <webserv/utils/HotFileCache.hpp>  // for HotFileCache
+#include <webserv/utils/OpenFileCache.hpp> // for OpenFileCache
+#include <webserv/utils/Scan.hpp>          // for getKernelName
 #include <webserv/utils/utils.hpp>         // for stateToEpoll
 
-#include <cerrno>  // for errno, EBADF, ENOENT, EINTR
-#include <csignal> // for SIGINT, sig_atomic_t
+#include <algorithm> // for any_of, copy, find, replace
+#include <array>     // for array
+#include <atomic>    // for atomic
+#include <cerrno>    // for errno, EBADF, ENOENT, EINTR, EMFILE, ENFILE
+#include <chrono>    // for milliseconds
+#include <csignal>   // for SIGINT, SIGTERM
+#include <cstddef>   // for ptrdiff_t
 #include <cstdio>
 #include <cstring>       // for strerror
 #include <exception>     // for exception
@@ -18,15 +34,12 @@
 #include <optional>      // for optional
 #include <stdexcept>     // for runtime_error, invalid_argument
 #include <string>        // for basic_string, operator+, to_string, char_traits, string
-#include <unordered_map> // for unordered_map
 #include <utility>       // for move
-#include <vector>        // for vector, erase_if
+#include <vector>        // for vector, erase
 
-#include <fcntl.h>     // for O_CLOEXEC
 #include <stdint.h>    // for uint32_t
-#include <sys/epoll.h> // for epoll_event, epoll_ctl, EPOLLOUT, EPOLL_CTL_MOD, epoll_create1, epoll_wait, EPOLLERR, EPOLLHUP, EPOLLIN, EPOLL_CTL_ADD, EPOLL_CTL_DEL
-#include <sys/socket.h> // for SOMAXCONN
-#include <unistd.h>     // for close
+#include <sys/epoll.h> // for epoll_event, EPOLLOUT, EPOLLERR, EPOLLHUP, EPOLLIN, EPOLLEXCLUSIVE, EPOLLET
+#include <sys/socket.h> // for SOMAXCONN, sockaddr
 
 /**
 
@@ -50,27 +63,49 @@
 
 */
 
-volatile sig_atomic_t Server::signum_ = 0;
+std::atomic<int> Server::signum_ = 0;
 
-Server::Server(const ConfigManager &configManager) : epoll_fd_(epoll_create1(O_CLOEXEC)), configManager_(configManager)
+static inline std::string eventBackendName(const ConfigManager &configManager)
+{
+    const GlobalConfig *config = configManager.getGlobalConfig();
+    return config == nullptr ? EVENT_BACKEND : config->get<std::string>("event_backend").value_or(EVENT_BACKEND);
+}
+
+Server::Server(const ConfigManager &configManager, size_t id, bool reusePort)
+    : Server(configManager, bindListeners(configManager, reusePort), id)
+{
+}
+
+Server::Server(const ConfigManager &configManager, std::vector<std::unique_ptr<ServerSocket>> listeners, size_t id,
+               bool sharedListeners)
+    : backend_(AEventBackend::create(eventBackendName(configManager))), configManager_(configManager), id_(id),
+      listeners_(std::move(listeners)), sharedListeners_(sharedListeners), acceptBatch_(ACCEPT_BATCH), edgeTriggered_(false),
+      timers_(std::make_unique<TimerWheel>()),
+      acceptTimer_(std::make_unique<TimerSocket>(*timers_, std::chrono::milliseconds(Constants::ACCEPT_PAUSE_MS))),
+      upstreams_(std::make_unique<UpstreamPool>()), cgiWorkers_(std::make_unique<CgiWorkerPool>(*timers_))
 {
     Log::trace(LOCATION);
-    const auto &serverConfigs = configManager.getServerConfigs();
-    if (serverConfigs.empty())
+    if (id_ == 0)
     {
-        Log::fatal("No server configurations available.");
-        throw std::runtime_error("No server configurations available.");
+        Log::info("Using the " + std::string(backend_->getName()) + " event backend");
+        Log::info("Using the " + std::string(scan::getKernelName()) + " delimiter scanner");
     }
-    if (epoll_fd_ == -1)
+    if (const GlobalConfig *globalConfig = configManager_.getGlobalConfig())
     {
-        Log::fatal("epoll_create1 failed");
-        throw std::runtime_error("epoll_create1 failed");
+        acceptBatch_ = static_cast<size_t>(globalConfig->get<int>("accept_batch").value_or(ACCEPT_BATCH));
+        edgeTriggered_ = globalConfig->get<bool>("edge_triggered").value_or(false);
     }
-    for (const auto &config : configManager_.getServerConfigs())
+    acceptTimer_->setCallback([this]() { resumeAccepting(); });
+    add(*timers_);
+    for (const auto &listener : listeners_)
     {
-        setupServerSocket(*config);
+        add(*listener);
+        if (id_ == 0)
+        {
+            Log::info("Server listening on " + listener->getHost() + ":" + std::to_string(listener->getPort()) + "...");
+        }
     }
-    if (listener_fds_.empty())
+    if (listeners_.empty())
     {
         Log::fatal("No server sockets created.");
         throw std::runtime_error("No server sockets created.");
@@ -80,112 +115,256 @@ Server::Server(const ConfigManager &configManager) : epoll_fd_(epoll_create1(O_C
 Server::~Server()
 {
     Log::trace(LOCATION);
-    if (epoll_fd_ != -1)
-    {
-        close(epoll_fd_);
-    }
 }
 
 void Server::add(ASocket &socket, Client *client)
 {
-    if (socket.getType() != ASocket::Type::SERVER_SOCKET && client == nullptr)
+    bool isService = socket.getType() == ASocket::Type::TIMER_SOCKET || socket.getType() == ASocket::Type::WATCH_SOCKET;
+    if (socket.getType() != ASocket::Type::SERVER_SOCKET && !isService && client == nullptr)
     {
         Log::error("Client pointer must be provided for non-server sockets");
         throw std::invalid_argument("Client pointer must be provided for non-server sockets");
     }
     Log::trace(LOCATION);
     int fd = socket.getFd();
-    struct epoll_event event{};
-    event.events = utils::stateToEpoll(socket.getEvent());
-    event.data.fd = fd;
-    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1)
+    if (static_cast<size_t>(fd) >= slots_.size())
     {
-        Log::error(socket.toString() + ": epoll_ctl ADD failed");
-        throw std::runtime_error("epoll_ctl ADD failed");
+        slots_.resize(static_cast<size_t>(fd) + 1);
     }
-    Log::debug(socket.toString() + ": added to epoll");
-    socketToClient_[fd] = client;
-    sockets_.insert(&socket);
+    Slot &slot = slots_[fd];
+    if (backend_->add(fd, epollEvents(socket), eventData(fd, slot)) == -1)
+    {
+        Log::error(socket.toString() + ": event backend ADD failed");
+        throw std::runtime_error("event backend ADD failed");
+    }
+    Log::debug(socket.toString() + ": added to " + std::string(backend_->getName()));
+    socket.attach(&dirtySockets_);
+    slot.socket = &socket;
+    slot.client = client;
+    ++socketCounts_.at(static_cast<size_t>(socket.getType()));
 }
 
 void Server::remove(ASocket &socket)
 {
     Log::trace(LOCATION);
     int fd = socket.getFd();
-    if (epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr) == -1)
+    if (socket.isDirty())
+    {
+        std::erase(dirtySockets_, &socket);
+    }
+    // pollDeferred() may be walking the queue, so the entry is only cleared
+    std::ranges::replace(deferredSockets_, &socket, nullptr);
+    socket.attach(nullptr);
+    if (static_cast<size_t>(fd) < slots_.size() && slots_[fd].socket == &socket)
+    {
+        Slot &slot = slots_[fd];
+        slot.socket = nullptr;
+        slot.client = nullptr;
+        ++slot.generation;
+        --socketCounts_.at(static_cast<size_t>(socket.getType()));
+    }
+    if (backend_->remove(fd) == -1)
     {
         if (errno == EBADF || errno == ENOENT)
         {
-            Log::debug(socket.toString() + " was already closed or removed from epoll");
+            Log::debug(socket.toString() + " was already closed or removed from the event backend");
             return;
         }
-        Log::error(socket.toString() + ": epoll_ctl DEL failed");
-        throw std::runtime_error("epoll_ctl DEL failed");
+        Log::error(socket.toString() + ": event backend DEL failed");
+        throw std::runtime_error("event backend DEL failed");
+    }
+}
+
+/**
+ * Queues client to have its completed response sent. Called when the response is marked complete, whether that
+ * happens synchronously in a handler or later from a CGI, timer or other event.
+ */
+void Server::ready(Client &client)
+{
+    if (readyClients_.empty() || readyClients_.back() != &client)
+    {
+        readyClients_.push_back(&client);
     }
-    socketToClient_.erase(fd);
-    sockets_.erase(&socket);
 }
 
+/**
+ * Calls the socket back on the next loop iteration. Used by callbacks that stop before the socket would block, which
+ * an edge-triggered epoll would not report again. Level-triggered epoll keeps reporting it, so nothing is queued.
+ */
+void Server::defer(ASocket &socket)
+{
+    if (edgeTriggered_ && std::ranges::find(deferredSockets_, &socket) == deferredSockets_.end())
+    {
+        deferredSockets_.push_back(&socket);
+    }
+}
+
+/**
+ * Closes the connection of client and keeps the object in the pool for a later connection, or frees it once the pool
+ * is full. Either way the caller must not touch the client afterwards.
+ */
 void Server::disconnect(const Client &client)
 {
     Log::trace(LOCATION);
-    int client_fd = client.getSocket().getFd();
+    auto client_fd = static_cast<size_t>(client.getSocket().getFd());
+    std::erase(readyClients_, &client);
 
-    std::erase_if(clients_, [&](const std::unique_ptr<Client> &c) { return c->getSocket().getFd() == client_fd; });
+    if (client_fd < clients_.size() && clients_[client_fd].get() == &client)
+    {
+        std::unique_ptr<Client> closed = std::move(clients_[client_fd]);
+        closed->close();
+        if (clientPool_.size() < Constants::CLIENT_POOL_SIZE)
+        {
+            clientPool_.push_back(std::move(closed));
+        }
+    }
 }
 
-void Server::setupServerSocket(const ServerConfig &config)
+std::vector<std::unique_ptr<ServerSocket>> Server::bindListeners(const ConfigManager &configManager, bool reusePort)
 {
     Log::trace(LOCATION);
-    try
+    const auto &serverConfigs = configManager.getServerConfigs();
+    if (serverConfigs.empty())
+    {
+        Log::fatal("No server configurations available.");
+        throw std::runtime_error("No server configurations available.");
+    }
+    std::vector<std::unique_ptr<ServerSocket>> listeners;
+    for (const auto &config : serverConfigs)
     {
-        // These are required fields
-        auto host = config.get<std::string>("host").value();
-        auto port = config.get<int>("listen").value();
-        for (const auto &listener : listeners_)
+        try
         {
-            if (listener->getPort() == port && listener->getHost() == host)
+            // These are required fields
+            auto host = config->get<std::string>("host").value();
+            auto port = config->get<int>("listen").value();
+            bool exists = std::ranges::any_of(listeners, [&](const std::unique_ptr<ServerSocket> &listener) {
+                return listener->getPort() == port && listener->getHost() == host;
+            });
+            if (exists)
             {
                 Log::debug("Server socket for " + host + ":" + std::to_string(port)
                            + " already exists, skipping creation.");
-                return;
+                continue;
+            }
+            listeners.push_back(std::make_unique<ServerSocket>(host, port, reusePort));
+        }
+        catch (const std::exception &e)
+        {
+            Log::error("Error setting up server socket: " + std::string(e.what()));
+        }
+    }
+    return listeners;
+}
+
+/**
+ * Accepts up to accept_batch pending connections, so a burst does not cost one epoll round trip per connection.
+ */
+void Server::handleConnection(ServerSocket &listener)
+{
+    Log::trace(LOCATION);
+    for (size_t i = 0; i < acceptBatch_; ++i)
+    {
+        struct sockaddr address{};
+        int fd = listener.accept(address);
+        if (fd == -1)
+        {
+            if (errno == EMFILE || errno == ENFILE)
+            {
+                // Cached file descriptors give way to clients before accepting pauses
+                if (OpenFileCache::get().evictAll())
+                {
+                    continue;
+                }
+                pauseAccepting();
             }
+            return;
         }
-        std::unique_ptr<ServerSocket> serverSocket = std::make_unique<ServerSocket>(host, port);
-        int server_fd = serverSocket->getFd();
+        std::unique_ptr<Client> client = acquireClient(fd, address);
+        client->getSocket().setIOState(ASocket::IoState::READ);
+        add(client->getSocket(), client.get());
+        if (static_cast<size_t>(fd) >= clients_.size())
+        {
+            clients_.resize(static_cast<size_t>(fd) + 1);
+        }
+        clients_[static_cast<size_t>(fd)] = std::move(client);
+    }
+}
 
-        add(*serverSocket);
+/**
+ * Hands the accepted connection fd to a pooled client, allocating a new one only when the pool is empty.
+ */
+std::unique_ptr<Client> Server::acquireClient(int fd, struct sockaddr address)
+{
+    if (clientPool_.empty())
+    {
+        return std::make_unique<Client>(std::make_unique<ClientSocket>(fd, address), *this);
+    }
+    std::unique_ptr<Client> client = std::move(clientPool_.back());
+    clientPool_.pop_back();
+    client->open(fd, address);
+    return client;
+}
 
-        listeners_.push_back(std::move(serverSocket));
-        listener_fds_.insert(server_fd);
-        Log::info("Server listening on " + host + ":" + std::to_string(port) + "...");
+/**
+ * Stops polling the listeners while out of file descriptors. They would otherwise report the same pending connection
+ * on every epoll_wait; the connections wait in the backlog until accepting resumes.
+ */
+void Server::pauseAccepting()
+{
+    if (!pausedListeners_.empty())
+    {
+        return;
     }
-    catch (const std::exception &e)
+    Log::warning("Out of file descriptors, pausing accept for " + std::to_string(Constants::ACCEPT_PAUSE_MS) + "ms");
+    for (const auto &listener : listeners_)
     {
-        Log::error("Error setting up server socket: " + std::string(e.what()));
+        const Slot *slot = findSlot(listener->getFd());
+        if (slot != nullptr && slot->socket == listener.get())
+        {
+            remove(*listener);
+            pausedListeners_.push_back(listener.get());
+        }
     }
+    acceptTimer_->activate();
 }
 
-void Server::handleConnection(struct epoll_event *event)
+void Server::resumeAccepting()
 {
-    Log::trace(LOCATION);
-    ServerSocket &listener = getListener(event->data.fd);
-    std::unique_ptr<ClientSocket> clientSocket = listener.accept();
-    clientSocket->setIOState(ASocket::IoState::READ);
-    auto client = std::make_unique<Client>(std::move(clientSocket), *this);
-    add(client->getSocket(), client.get());
-    clients_.emplace_back(std::move(client));
+    Log::debug("Resuming accept");
+    for (ServerSocket *listener : pausedListeners_)
+    {
+        add(*listener);
+    }
+    pausedListeners_.clear();
+}
+
+TimerWheel &Server::getTimerWheel() const noexcept
+{
+    return *timers_;
+}
+
+UpstreamPool &Server::getUpstreamPool() const noexcept
+{
+    return *upstreams_;
+}
+
+CgiWorkerPool &Server::getCgiWorkerPool() const noexcept
+{
+    return *cgiWorkers_;
+}
+
+bool Server::isEdgeTriggered() const noexcept
+{
+    return edgeTriggered_;
 }
 
 ServerSocket &Server::getListener(int fd) const
 {
     Log::trace(LOCATION);
-    for (const auto &listener : listeners_)
+    const Slot *slot = findSlot(fd);
+    if (slot != nullptr && slot->socket->getType() == ASocket::Type::SERVER_SOCKET)
     {
-        if (listener->getFd() == fd)
-        {
-            return *listener;
-        }
+        return static_cast<ServerSocket &>(*slot->socket);
     }
     Log::error("Listener not found for fd: " + std::to_string(fd));
     throw std::runtime_error("Listener not found for fd: " + std::to_string(fd));
@@ -193,36 +372,60 @@ ServerSocket &Server::getListener(int fd) const
 
 Client &Server::getClient(int fd) const
 {
-    if (socketToClient_.contains(fd))
+    const Slot *slot = findSlot(fd);
+    if (slot != nullptr && slot->client != nullptr)
     {
-        return *(socketToClient_.at(fd));
+        return *slot->client;
     }
     Log::error("Client not found for fd: " + std::to_string(fd));
     throw std::runtime_error("Client not found for fd: " + std::to_string(fd));
 }
 
-void Server::handleRequest(struct epoll_event *event) const
+uint32_t Server::epollEvents(const ASocket &socket) const
 {
-    Log::trace(LOCATION);
-    int client_fd = event->data.fd;
+    uint32_t events = utils::stateToEpoll(socket.getEvent());
+    if (sharedListeners_ && socket.getType() == ASocket::Type::SERVER_SOCKET)
+    {
+        events |= EPOLLEXCLUSIVE;
+    }
+    if (edgeTriggered_ && socket.getType() == ASocket::Type::CLIENT_SOCKET)
+    {
+        events |= EPOLLET;
+    }
+    return events;
+}
 
-    Client &client = getClient(client_fd);
-    client.getSocket(client_fd).callback();
+/**
+ * The epoll user data of fd: its number in the low half and the generation of its slot in the high half.
+ */
+uint64_t Server::eventData(int fd, const Slot &slot) noexcept
+{
+    return (static_cast<uint64_t>(slot.generation) << 32U) | static_cast<uint32_t>(fd);
+}
+
+const Server::Slot *Server::findSlot(int fd) const noexcept
+{
+    if (fd < 0 || static_cast<size_t>(fd) >= slots_.size() || slots_[fd].socket == nullptr)
+    {
+        return nullptr;
+    }
+    return &slots_[fd];
 }
 
 void Server::writable(int client_fd) const
 {
     Log::trace(LOCATION);
-    Client &client = getClient(client_fd);
-    ASocket &socket = client.getSocket(client_fd);
-    Log::debug(socket.toString() + ": response ready");
-    struct epoll_event ev{};
-    ev.events = EPOLLOUT;
-    ev.data.fd = client_fd;
-    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client_fd, &ev) == -1)
+    const Slot *slot = findSlot(client_fd);
+    if (slot == nullptr || slot->client == nullptr)
     {
-        Log::error(socket.toString() + ": epoll_ctl MOD failed");
-        throw std::runtime_error("epoll_ctl MOD failed");
+        Log::error("Client not found for fd: " + std::to_string(client_fd));
+        throw std::runtime_error("Client not found for fd: " + std::to_string(client_fd));
+    }
+    Log::debug(slot->socket->toString() + ": response ready");
+    if (backend_->modify(client_fd, EPOLLOUT, eventData(client_fd, *slot)) == -1)
+    {
+        Log::error(slot->socket->toString() + ": event backend MOD failed");
+        throw std::runtime_error("event backend MOD failed");
     }
 }
 
@@ -231,120 +434,125 @@ void Server::update(const ASocket &socket) const
     Log::trace(LOCATION);
 
     int socketFd = socket.getFd();
-    uint32_t events = utils::stateToEpoll(socket.getEvent());
     Log::debug(socket.toString() + ": is being updated");
-    struct epoll_event evt{};
-    evt.events = events;
-    evt.data.fd = socketFd;
-    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, socketFd, &evt) == -1)
+    const Slot *slot = findSlot(socketFd);
+    if (slot == nullptr || slot->socket != &socket)
+    {
+        Log::debug(socket.toString() + ": is not registered");
+        return;
+    }
+    if (backend_->modify(socketFd, epollEvents(socket), eventData(socketFd, *slot)) == -1)
     {
         if (errno == EBADF || errno == ENOENT)
         {
-            Log::debug(socket.toString() + ": was already closed or removed from epoll");
+            Log::debug(socket.toString() + ": was already closed or removed from the event backend");
             return;
         }
-        Log::error(socket.toString() + ": epoll_ctl MOD failed");
-        throw std::runtime_error("epoll_ctl MOD failed");
+        Log::error(socket.toString() + ": event backend MOD failed");
+        throw std::runtime_error("event backend MOD failed");
     }
 }
 
-void Server::handleResponse(struct epoll_event *event) const
-{
-    int socket_fd = event->data.fd;
-    Client &client = getClient(socket_fd);
-    ASocket &socket = client.getSocket(socket_fd);
-    Log::debug(socket.toString() + ": attempting to send data");
-    socket.callback();
-    // disconnect(client);
-}
-
-void Server::handleEpollHangUp(struct epoll_event *event) const
+void Server::handleEpollHangUp(const Slot &slot)
 {
-    Client &client = getClient(event->data.fd);
-    ASocket &socket = client.getSocket(event->data.fd);
-    if (socket.getType() == ASocket::Type::CGI_SOCKET)
+    ASocket &socket = *slot.socket;
+    if (socket.getType() == ASocket::Type::CGI_SOCKET || socket.getType() == ASocket::Type::UPSTREAM_SOCKET)
     {
-        Log::debug(socket.toString() + ": CGI socket hang up");
+        Log::debug(socket.toString() + ": peer hung up");
         socket.callback();
         return;
     }
     Log::warning(socket.toString() + ": Epoll hang up");
+    if (socket.getType() == ASocket::Type::CLIENT_SOCKET)
+    {
+        // The failing read or write disconnects the client; edge-triggered, the hang up is not reported again
+        socket.callback();
+    }
 }
 
-void Server::handleEpollError(struct epoll_event *event)
+void Server::handleEpollError(const Slot &slot)
 {
-    int fd = event->data.fd;
+    ASocket &socket = *slot.socket;
+    int fd = socket.getFd();
     Log::error("Epoll error on fd " + std::to_string(fd) + ": socket error or connection reset");
-    try
-    {
-        Client &client = getClient(fd);
-        ASocket &socket = client.getSocket(fd);
-        switch (socket.getType())
-        {
-        case ASocket::Type::CLIENT_SOCKET:
-            Log::warning(socket.toString() + ": EPOLLERR disconnecting client");
-            disconnect(client);
-            break;
-        case ASocket::Type::SERVER_SOCKET:
-            Log::warning(socket.toString() + ": EPOLLERR removing server socket");
-            remove(socket);
-            close(fd);
-            listener_fds_.erase(fd);
-            break;
-        case ASocket::Type::TIMER_SOCKET:
-        case ASocket::Type::CGI_SOCKET:
-        default:
-            Log::warning(socket.toString() + ": EPOLLERR removing auxiliary socket");
-            remove(socket);
-            close(fd);
-            break;
-        }
-    }
-    catch (const std::exception &e)
-    {
-        Log::warning(std::string("EPOLLERR on unknown/non-tracked fd, closing: ") + e.what());
-        close(fd);
+    switch (socket.getType())
+    {
+    case ASocket::Type::CLIENT_SOCKET:
+        Log::warning(socket.toString() + ": EPOLLERR disconnecting client");
+        disconnect(*slot.client);
+        break;
+    case ASocket::Type::SERVER_SOCKET:
+        Log::warning(socket.toString() + ": EPOLLERR removing server socket");
+        remove(socket);
+        break;
+    case ASocket::Type::TIMER_SOCKET:
+        remove(socket);
+        Log::fatal(socket.toString() + ": EPOLLERR on the timer wheel");
+        throw std::runtime_error("Timer wheel failed");
+    case ASocket::Type::WATCH_SOCKET:
+        remove(socket);
+        // Without its watches nothing could invalidate the hot file cache anymore
+        Log::warning(socket.toString() + ": EPOLLERR disabling hot file cache");
+        HotFileCache::get().disable();
+        break;
+    case ASocket::Type::UPSTREAM_SOCKET:
+        // The handler learns about the failure from its next read or write and closes the connection
+        socket.callback();
+        break;
+    case ASocket::Type::CGI_SOCKET:
+    default:
+        Log::warning(socket.toString() + ": EPOLLERR removing auxiliary socket");
+        remove(socket);
+        break;
     }
 }
 
 void Server::handleEvent(struct epoll_event *event)
 {
     Log::trace(LOCATION);
-    if ((event->events & EPOLLERR) > 0)
+    auto fd = static_cast<int>(event->data.u64 & 0xFFFFFFFFU);
+    const Slot *slot = findSlot(fd);
+    if (slot == nullptr || eventData(fd, *slot) != event->data.u64)
     {
-        handleEpollError(event);
-        // return;
+        // Removed earlier in this batch, possibly with its fd already reused
+        Log::debug("Dropping stale event for fd " + std::to_string(fd));
+        return;
     }
-    else if ((event->events & EPOLLHUP) > 0)
+    ASocket::Type type = slot->socket->getType();
+    if ((event->events & EPOLLERR) > 0)
     {
-        handleEpollHangUp(event);
+        handleEpollError(*slot);
     }
-    else if (listener_fds_.contains(event->data.fd))
+    else if ((event->events & EPOLLHUP) > 0)
     {
-        handleConnection(event);
+        handleEpollHangUp(*slot);
     }
-    else if ((event->events & EPOLLIN) > 0)
+    else if (type == ASocket::Type::SERVER_SOCKET)
     {
-        handleRequest(event);
+        handleConnection(static_cast<ServerSocket &>(*slot->socket));
     }
-    else if ((event->events & EPOLLOUT) > 0)
+    else if ((event->events & (EPOLLIN | EPOLLOUT)) > 0)
     {
-        handleResponse(event);
+        slot->socket->callback();
     }
 }
 
 void Server::handleEpoll(struct epoll_event *events, int max_events)
 {
-    int nfds = epoll_wait(epoll_fd_, events, max_events, 10); // NOLINT
+    // Everything else arrives as an event; the timeout only bounds how long a reactor thread takes to notice that
+    // another thread received the stop signal
+    bool idle = readyClients_.empty() && dirtySockets_.empty() && deferredSockets_.empty();
+    int timeout = idle ? Constants::IDLE_WAIT_MS : 0;
+    int nfds = backend_->wait(events, max_events, timeout);
     if (nfds == -1)
     {
         if (errno == EINTR)
         {
-            Log::debug("epoll_wait interrupted by signal, continuing...");
+            Log::debug("Event wait interrupted by signal, continuing...");
             return;
         }
-        Log::error("epoll_wait failed");
-        throw std::runtime_error("epoll_wait failed");
+        Log::error("Event wait failed");
+        throw std::runtime_error("Event wait failed");
     }
     for (int i = 0; i < nfds; ++i)
     {
@@ -352,30 +560,60 @@ void Server::handleEpoll(struct epoll_event *events, int max_events)
     }
 }
 
-void Server::pollClients() const
+void Server::pollClients()
 {
-    for (const auto &client : clients_)
+    // Indexed, since a client may become ready again while the queue is processed
+    for (size_t i = 0; i < readyClients_.size(); ++i)
     {
-        client->poll();
+        readyClients_[i]->ready();
     }
+    readyClients_.clear();
 }
 
 void Server::pollSockets()
 {
-    for (auto *socket : sockets_)
+    for (auto *socket : dirtySockets_)
+    {
+        update(*socket);
+        socket->processed();
+    }
+    dirtySockets_.clear();
+}
+
+/**
+ * Calls back the sockets deferred so far. Sockets deferred again while this runs wait for the next iteration, after
+ * everyone else had a turn.
+ */
+void Server::pollDeferred()
+{
+    size_t count = deferredSockets_.size();
+    for (size_t i = 0; i < count; ++i)
     {
-        if (socket->isDirty())
+        if (ASocket *socket = deferredSockets_[i])
         {
-            update(*socket);
-            socket->processed();
+            deferredSockets_[i] = nullptr;
+            socket->callback();
         }
     }
+    deferredSockets_.erase(deferredSockets_.begin(), deferredSockets_.begin() + static_cast<std::ptrdiff_t>(count));
 }
 
 void Server::run()
 {
     Log::trace(LOCATION);
-    Log::info("Listening...");
+    if (id_ == 0)
+    {
+        Log::info("Listening...");
+    }
+    else
+    {
+        Log::debug("Reactor " + std::to_string(id_) + " listening...");
+    }
+    // The hot file cache belongs to the thread running this loop, so its watches are registered from here
+    if (WatchSocket *watchSocket = HotFileCache::get().getSocket())
+    {
+        add(*watchSocket);
+    }
     const int MAX_EVENTS = 1024;
     struct epoll_event events[MAX_EVENTS]; // NOLINT
     while (signum_ != SIGINT && signum_ != SIGTERM)
@@ -383,8 +621,9 @@ void Server::run()
         try
         {
             connectionInfo();
-            pollSockets();
+            pollDeferred();
             pollClients();
+            pollSockets();
             handleEpoll(events, MAX_EVENTS); // NOLINT (cppcoreguidelines-pro-bounds-pointer-arithmetic)
         }
         catch (const std::exception &e)
@@ -403,24 +642,28 @@ void Server::signalHandler(int signum)
     }
 }
 
-void Server::connectionInfo() const
+void Server::connectionInfo()
 {
-    int serverCount = 0;
-    int clientCount = 0;
-    int timerCount = 0;
-    int cgiCount = 0;
-    int otherCount = 0;
-    for (auto *s : sockets_)
+    // The status line is shared by all reactors, only the first one draws it
+    if (id_ != 0)
     {
-        switch (s->getType())
-        {
-        case ASocket::Type::SERVER_SOCKET: ++serverCount; break;
-        case ASocket::Type::CLIENT_SOCKET: ++clientCount; break;
-        case ASocket::Type::TIMER_SOCKET: ++timerCount; break;
-        case ASocket::Type::CGI_SOCKET: ++cgiCount; break;
-        default: ++otherCount; break;
-        }
+        return;
     }
+    // Redraw only when a count changed
+    std::array<size_t, SOCKET_TYPES + 1> counts{};
+    std::copy(socketCounts_.begin(), socketCounts_.end(), counts.begin());
+    counts.back() = timers_->size();
+    if (counts == drawnCounts_)
+    {
+        return;
+    }
+    drawnCounts_ = counts;
+
+    size_t serverCount = socketCounts_.at(static_cast<size_t>(ASocket::Type::SERVER_SOCKET));
+    size_t clientCount = socketCounts_.at(static_cast<size_t>(ASocket::Type::CLIENT_SOCKET));
+    size_t timerCount = timers_->size();
+    size_t cgiCount = socketCounts_.at(static_cast<size_t>(ASocket::Type::CGI_SOCKET));
+    size_t upstreamCount = socketCounts_.at(static_cast<size_t>(ASocket::Type::UPSTREAM_SOCKET));
 
     std::string socketsInfo;
     std::vector<std::string> parts;
@@ -440,9 +683,9 @@ void Server::connectionInfo() const
     {
         parts.emplace_back("CGI(" + std::to_string(cgiCount) + ")");
     }
-    if (otherCount > 0)
+    if (upstreamCount > 0)
     {
-        parts.emplace_back("Other(" + std::to_string(otherCount) + ")");
+        parts.emplace_back("Upstream(" + std::to_string(upstreamCount) + ")");
     }
 
     socketsInfo = utils::implode(parts, ", ");
@@ -2,29 +2,39 @@
 
 #include <webserv/client/Client.hpp>
 #include <webserv/config/ConfigManager.hpp>
-#include <webserv/config/ServerConfig.hpp> // for ServerConfig
-#include <webserv/router/Router.hpp>       // for Router
+#include <webserv/config/ServerConfig.hpp>  // for ServerConfig
+#include <webserv/router/Router.hpp>        // for Router
+#include <webserv/server/AEventBackend.hpp> // for AEventBackend
 #include <webserv/socket/ASocket.hpp>
-#include <webserv/socket/ServerSocket.hpp> // for ServerSocket
+#include <webserv/socket/ServerSocket.hpp>  // for ServerSocket
+#include <webserv/socket/TimerSocket.hpp>   // for TimerSocket
+#include <webserv/socket/TimerWheel.hpp>    // for TimerWheel
+#include <webserv/socket/UpstreamPool.hpp>  // for UpstreamPool
 
-#include <csignal>       // for sig_atomic_t
-#include <cstdint>       // for uint32_t
+#include <array>         // for array
+#include <atomic>        // for atomic
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint32_t, uint64_t
 #include <memory>        // for unique_ptr
-#include <set>           // for set
-#include <unordered_map> // for unordered_map
 #include <vector>        // for vector
 
+class AEventBackend;
 class Client;
 class ConfigManager;
 class ServerConfig;
 class ASocket;
 class ServerSocket;
+class TimerWheel;
+class UpstreamPool;
+class CgiWorkerPool;
 
 class Server
 {
   public:
     Server() = delete;
-    Server(const ConfigManager &configManager);
+    Server(const ConfigManager &configManager, size_t id = 0, bool reusePort = false);
+    Server(const ConfigManager &configManager, std::vector<std::unique_ptr<ServerSocket>> listeners, size_t id = 0,
+           bool sharedListeners = false);
 
     Server(const Server &other) = delete;
     Server &operator=(const Server &other) = delete;
@@ -33,39 +43,87 @@ class Server
 
     ~Server();
     static void signalHandler(int signum);
+    static std::vector<std::unique_ptr<ServerSocket>> bindListeners(const ConfigManager &configManager,
+                                                                    bool reusePort = false);
 
     void run();
     void add(ASocket &socket, Client *client = nullptr);
     void remove(ASocket &socket);
     void update(const ASocket &socket) const;
     void disconnect(const Client &client);
+    void ready(Client &client);
+    void defer(ASocket &socket);
     void writable(int client_fd) const;
 
+    [[nodiscard]] TimerWheel &getTimerWheel() const noexcept;
+    [[nodiscard]] UpstreamPool &getUpstreamPool() const noexcept;
+    [[nodiscard]] CgiWorkerPool &getCgiWorkerPool() const noexcept;
+    [[nodiscard]] bool isEdgeTriggered() const noexcept;
     ServerSocket &getListener(int fd) const;
     Client &getClient(int fd) const;
 
   private:
-    int epoll_fd_;
-    static volatile sig_atomic_t signum_;
+    /**
+     * Dispatch record of a registered fd. The generation changes whenever the fd is removed, so events queued for a
+     * closed fd are not delivered to a socket that reused its number.
+     */
+    struct Slot
+    {
+        ASocket *socket = nullptr;
+        Client *client = nullptr;
+        uint32_t generation = 0;
+    };
+
+    // Declared first, everything below may still unregister sockets while being destroyed
+    std::unique_ptr<AEventBackend> backend_;
+    static std::atomic<int> signum_;
     const ConfigManager &configManager_;
+    size_t id_;
     std::vector<std::unique_ptr<ServerSocket>> listeners_;
-    std::set<int> listener_fds_;
+    // Listeners shared with other processes are registered with EPOLLEXCLUSIVE so a connection wakes only one of them
+    bool sharedListeners_;
+    size_t acceptBatch_;
+    // Client sockets are registered with EPOLLET; their callbacks drain them and defer() when the budget runs out
+    bool edgeTriggered_;
+    std::vector<ServerSocket *> pausedListeners_;
+    static constexpr size_t SOCKET_TYPES = static_cast<size_t>(ASocket::Type::UPSTREAM_SOCKET) + 1;
+    std::array<size_t, SOCKET_TYPES> socketCounts_{};
+    std::array<size_t, SOCKET_TYPES + 1> drawnCounts_{};
+
+    // Indexed by fd. Declared before the sockets they refer to, which unregister themselves when destroyed
+    std::vector<Slot> slots_;
+    std::vector<ASocket *> dirtySockets_;
+    std::vector<ASocket *> deferredSockets_;
+    std::vector<Client *> readyClients_;
+    // Declared before clients_ so the timers of clients are cancelled before the wheel goes away
+    std::unique_ptr<TimerWheel> timers_;
+    std::unique_ptr<TimerSocket> acceptTimer_;
+    // Idle backend connections, shared by the clients of this reactor
+    std::unique_ptr<UpstreamPool> upstreams_;
+    // Interpreter processes of the cgi_pool locations, stopped when the reactor goes away
+    std::unique_ptr<CgiWorkerPool> cgiWorkers_;
+    // Closed clients kept for reuse by the next connections, up to Constants::CLIENT_POOL_SIZE
+    std::vector<std::unique_ptr<Client>> clientPool_;
+    // Indexed by the fd of the client socket
     std::vector<std::unique_ptr<Client>> clients_;
-    std::unordered_map<int, Client *> socketToClient_;
-    std::set<ASocket *> sockets_;
 
-    void pollClients() const;
+    [[nodiscard]] std::unique_ptr<Client> acquireClient(int fd, struct sockaddr address);
+
+    void pollClients();
     void pollSockets();
+    void pollDeferred();
     void handleEpoll(struct epoll_event *events, int max_events);
 
-    void handleEpollError(struct epoll_event *event);
-    void handleEpollHangUp(struct epoll_event *event) const;
-    void handleEvent(struct epoll_event *event);
-    void handleConnection(struct epoll_event *event);
-    void handleRequest(struct epoll_event *event) const;
-    void handleResponse(struct epoll_event *event) const;
+    [[nodiscard]] uint32_t epollEvents(const ASocket &socket) const;
+    [[nodiscard]] static uint64_t eventData(int fd, const Slot &slot) noexcept;
+    [[nodiscard]] const Slot *findSlot(int fd) const noexcept;
 
-    void setupServerSocket(const ServerConfig &config);
+    void handleEpollError(const Slot &slot);
+    static void handleEpollHangUp(const Slot &slot);
+    void handleEvent(struct epoll_event *event);
+    void handleConnection(ServerSocket &listener);
+    void pauseAccepting();
+    void resumeAccepting();
 
-    void connectionInfo() const;
+    void connectionInfo();
 };
@@ -0,0 +1,338 @@
+#include <webserv/server/UringBackend.hpp>
+
+#include <webserv/log/Log.hpp> // for Log
+
+#include <algorithm>    // for max
+#include <atomic>       // for atomic_ref, memory_order
+#include <cerrno>       // for errno, EBADF, EEXIST, ENOENT, ETIME, ECANCELED
+#include <csignal>      // for _NSIG
+#include <stdexcept>    // for runtime_error
+#include <string>       // for operator+, to_string
+#include <system_error> // for system_error, generic_category
+
+#include <linux/io_uring.h>   // for io_uring_params, io_uring_sqe, io_uring_cqe, io_uring_getevents_arg, IORING_*
+#include <linux/time_types.h> // for __kernel_timespec
+#include <sys/epoll.h>        // for epoll_event, EPOLLET, EPOLLERR
+#include <sys/mman.h>         // for mmap, munmap, PROT_READ, PROT_WRITE, MAP_SHARED, MAP_POPULATE, MAP_FAILED
+#include <sys/syscall.h>      // for __NR_io_uring_setup, __NR_io_uring_enter
+#include <unistd.h>           // for syscall, close
+
+// user_data of requests whose completions carry nothing of interest
+static constexpr uint64_t IGNORED = ~0ULL;
+
+static inline uint64_t pollData(int fd, uint32_t sequence)
+{
+    return (static_cast<uint64_t>(sequence) << 32U) | static_cast<uint32_t>(fd);
+}
+
+template <typename T> static inline T *ringField(void *ring, uint32_t offset)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+static inline void *mapRing(int ringFd, size_t size, off_t offset)
+{
+    void *ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+    return ring == MAP_FAILED ? nullptr : ring;
+}
+
+static inline unsigned load(unsigned *value)
+{
+    return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+}
+
+static inline void store(unsigned *value, unsigned newValue)
+{
+    std::atomic_ref<unsigned>(*value).store(newValue, std::memory_order_release);
+}
+
+UringBackend::UringBackend()
+{
+    struct io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = CQ_ENTRIES;
+    ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, SQ_ENTRIES, &params));
+    if (ringFd_ < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "io_uring_setup failed");
+    }
+    // Waiting with a timeout needs 5.11 and multishot polls 5.13, which also introduced IORING_FEAT_RSRC_TAGS
+    constexpr uint32_t required = IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG | IORING_FEAT_RSRC_TAGS;
+    if ((params.features & required) != required)
+    {
+        release();
+        throw std::runtime_error("kernel lacks required io_uring features");
+    }
+
+    sqRingSize_ = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    cqRingSize_ = params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap)
+    {
+        sqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+    sqRing_ = mapRing(ringFd_, sqRingSize_, static_cast<off_t>(IORING_OFF_SQ_RING));
+    cqRing_ = singleMap ? sqRing_ : mapRing(ringFd_, cqRingSize_, static_cast<off_t>(IORING_OFF_CQ_RING));
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = static_cast<struct io_uring_sqe *>(mapRing(ringFd_, sqesSize_, static_cast<off_t>(IORING_OFF_SQES)));
+    if (sqRing_ == nullptr || cqRing_ == nullptr || sqes_ == nullptr)
+    {
+        int error = errno;
+        release();
+        throw std::system_error(error, std::generic_category(), "mapping the io_uring rings failed");
+    }
+
+    sqHead_ = ringField<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = ringField<unsigned>(sqRing_, params.sq_off.tail);
+    sqArray_ = ringField<unsigned>(sqRing_, params.sq_off.array);
+    sqMask_ = *ringField<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    cqHead_ = ringField<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = ringField<unsigned>(cqRing_, params.cq_off.tail);
+    cqes_ = ringField<struct io_uring_cqe>(cqRing_, params.cq_off.cqes);
+    cqMask_ = *ringField<unsigned>(cqRing_, params.cq_off.ring_mask);
+    Log::debug("io_uring ready with " + std::to_string(params.sq_entries) + " submission and "
+               + std::to_string(params.cq_entries) + " completion entries");
+}
+
+UringBackend::~UringBackend()
+{
+    release();
+}
+
+void UringBackend::release() noexcept
+{
+    if (sqes_ != nullptr)
+    {
+        munmap(sqes_, sqesSize_);
+        sqes_ = nullptr;
+    }
+    if (cqRing_ != nullptr && cqRing_ != sqRing_)
+    {
+        munmap(cqRing_, cqRingSize_);
+    }
+    cqRing_ = nullptr;
+    if (sqRing_ != nullptr)
+    {
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = nullptr;
+    }
+    if (ringFd_ != -1)
+    {
+        close(ringFd_);
+        ringFd_ = -1;
+    }
+}
+
+int UringBackend::add(int fd, uint32_t events, uint64_t data)
+{
+    if (fd < 0)
+    {
+        errno = EBADF;
+        return -1;
+    }
+    if (find(fd) != nullptr)
+    {
+        errno = EEXIST;
+        return -1;
+    }
+    if (static_cast<size_t>(fd) >= registrations_.size())
+    {
+        registrations_.resize(static_cast<size_t>(fd) + 1);
+    }
+    Registration &registration = registrations_[static_cast<size_t>(fd)];
+    registration.data = data;
+    registration.events = events;
+    registration.registered = true;
+    ++registration.sequence;
+    arm(fd, registration);
+    return 0;
+}
+
+int UringBackend::modify(int fd, uint32_t events, uint64_t data)
+{
+    Registration *registration = find(fd);
+    if (registration == nullptr)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+    disarm(fd, *registration);
+    registration->data = data;
+    registration->events = events;
+    ++registration->sequence;
+    arm(fd, *registration);
+    return 0;
+}
+
+int UringBackend::remove(int fd)
+{
+    Registration *registration = find(fd);
+    if (registration == nullptr)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+    disarm(fd, *registration);
+    registration->registered = false;
+    ++registration->sequence;
+    return 0;
+}
+
+/**
+ * Submits everything queued since the last call and waits up to timeoutMs for completions. One-shot polls that
+ * completed in the previous round are armed again first, which reports a socket that is still ready right away.
+ */
+int UringBackend::wait(struct epoll_event *events, int maxEvents, int timeoutMs)
+{
+    for (int fd : rearm_)
+    {
+        Registration *registration = find(fd);
+        if (registration != nullptr && !registration->armed)
+        {
+            arm(fd, *registration);
+        }
+    }
+    rearm_.clear();
+
+    unsigned toSubmit = unsubmitted();
+    if (hasCompletions() || timeoutMs == 0)
+    {
+        // Also flushes completions the kernel had to hold back while the queue was full
+        if ((toSubmit > 0 || !hasCompletions()) && enter(toSubmit, 0, IORING_ENTER_GETEVENTS, nullptr, 0) < 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        struct __kernel_timespec timeout{};
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+        struct io_uring_getevents_arg arg{};
+        arg.sigmask_sz = _NSIG / 8;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        arg.ts = timeoutMs < 0 ? 0 : reinterpret_cast<uint64_t>(&timeout);
+        if (enter(toSubmit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)) < 0 && errno != ETIME)
+        {
+            return -1;
+        }
+    }
+    return reap(events, maxEvents);
+}
+
+std::string_view UringBackend::getName() const noexcept
+{
+    return "io_uring";
+}
+
+void UringBackend::arm(int fd, Registration &registration)
+{
+    bool multishot = (registration.events & EPOLLET) != 0;
+    struct io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = registration.events & ~static_cast<uint32_t>(EPOLLET);
+    sqe.len = multishot ? IORING_POLL_ADD_MULTI : 0;
+    sqe.user_data = pollData(fd, registration.sequence);
+    queue(sqe);
+    registration.armed = true;
+}
+
+void UringBackend::disarm(int fd, Registration &registration)
+{
+    if (!registration.armed)
+    {
+        return;
+    }
+    struct io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_POLL_REMOVE;
+    sqe.fd = -1;
+    sqe.addr = pollData(fd, registration.sequence);
+    sqe.user_data = IGNORED;
+    queue(sqe);
+    registration.armed = false;
+}
+
+void UringBackend::queue(const struct io_uring_sqe &sqe)
+{
+    if (unsubmitted() >= sqEntries_)
+    {
+        // Hand the full queue to the kernel to make room
+        if (enter(unsubmitted(), 0, 0, nullptr, 0) < 0 || unsubmitted() >= sqEntries_)
+        {
+            Log::error("io_uring submission queue is full");
+            throw std::runtime_error("io_uring submission queue is full");
+        }
+    }
+    unsigned tail = *sqTail_;
+    unsigned index = tail & sqMask_;
+    sqes_[index] = sqe;      // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    sqArray_[index] = index; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    store(sqTail_, tail + 1);
+}
+
+unsigned UringBackend::unsubmitted() const noexcept
+{
+    return *sqTail_ - load(sqHead_);
+}
+
+bool UringBackend::hasCompletions() const noexcept
+{
+    return *cqHead_ != load(cqTail_);
+}
+
+int UringBackend::enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const void *arg, size_t argSize) const
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete, flags, arg, argSize));
+}
+
+/**
+ * Turns up to maxEvents completions into epoll events. Completions of polls that were replaced or removed since they
+ * were queued are dropped.
+ */
+int UringBackend::reap(struct epoll_event *events, int maxEvents)
+{
+    unsigned head = *cqHead_;
+    unsigned tail = load(cqTail_);
+    int count = 0;
+    for (; head != tail && count < maxEvents; ++head)
+    {
+        const struct io_uring_cqe &cqe = cqes_[head & cqMask_]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (cqe.user_data == IGNORED)
+        {
+            continue;
+        }
+        int fd = static_cast<int>(cqe.user_data & 0xFFFFFFFFU);
+        auto sequence = static_cast<uint32_t>(cqe.user_data >> 32U);
+        Registration *registration = find(fd);
+        if (registration == nullptr || registration->sequence != sequence)
+        {
+            continue;
+        }
+        if ((cqe.flags & IORING_CQE_F_MORE) == 0)
+        {
+            registration->armed = false;
+            rearm_.push_back(fd);
+        }
+        if (cqe.res == -ECANCELED)
+        {
+            continue;
+        }
+        struct epoll_event &event = events[count++]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        event.events = cqe.res < 0 ? static_cast<uint32_t>(EPOLLERR) : static_cast<uint32_t>(cqe.res);
+        event.data.u64 = registration->data;
+    }
+    store(cqHead_, head);
+    return count;
+}
+
+UringBackend::Registration *UringBackend::find(int fd) noexcept
+{
+    if (fd < 0 || static_cast<size_t>(fd) >= registrations_.size() || !registrations_[static_cast<size_t>(fd)].registered)
+    {
+        return nullptr;
+    }
+    return &registrations_[static_cast<size_t>(fd)];
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <webserv/server/AEventBackend.hpp> // for AEventBackend
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint32_t, uint64_t
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
+struct epoll_event;
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * io_uring backend built on poll requests. A one-shot poll that is armed again after each completion behaves like a
+ * level-triggered registration; EPOLLET registrations use a multishot poll instead. Registrations, changes and
+ * re-arms are only queued as submission entries and reach the kernel with the next wait, so changing interest
+ * costs no system call of its own.
+ */
+class UringBackend : public AEventBackend
+{
+  public:
+    UringBackend();
+    ~UringBackend() override;
+
+    UringBackend(const UringBackend &other) = delete;
+    UringBackend &operator=(const UringBackend &other) = delete;
+    UringBackend(UringBackend &&other) noexcept = delete;
+    UringBackend &operator=(UringBackend &&other) noexcept = delete;
+
+    int add(int fd, uint32_t events, uint64_t data) override;
+    int modify(int fd, uint32_t events, uint64_t data) override;
+    int remove(int fd) override;
+    int wait(struct epoll_event *events, int maxEvents, int timeoutMs) override;
+
+    [[nodiscard]] std::string_view getName() const noexcept override;
+
+  private:
+    struct Registration
+    {
+        uint64_t data = 0;
+        uint32_t events = 0;
+        // Tells the completions of the poll in flight apart from those of polls it replaced
+        uint32_t sequence = 0;
+        bool registered = false;
+        bool armed = false;
+    };
+
+    static constexpr unsigned SQ_ENTRIES = 256;
+    static constexpr unsigned CQ_ENTRIES = 4096;
+
+    int ringFd_ = -1;
+    void *sqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    void *cqRing_ = nullptr;
+    size_t cqRingSize_ = 0;
+    struct io_uring_sqe *sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned *sqHead_ = nullptr;
+    unsigned *sqTail_ = nullptr;
+    unsigned *sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned *cqHead_ = nullptr;
+    unsigned *cqTail_ = nullptr;
+    struct io_uring_cqe *cqes_ = nullptr;
+    unsigned cqMask_ = 0;
+
+    std::vector<Registration> registrations_;
+    std::vector<int> rearm_;
+
+    void release() noexcept;
+    void arm(int fd, Registration &registration);
+    void disarm(int fd, Registration &registration);
+    void queue(const struct io_uring_sqe &sqe);
+    [[nodiscard]] unsigned unsubmitted() const noexcept;
+    [[nodiscard]] bool hasCompletions() const noexcept;
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const void *arg, size_t argSize) const;
+    int reap(struct epoll_event *events, int maxEvents);
+    [[nodiscard]] Registration *find(int fd) noexcept;
+};
@@ -12,7 +12,11 @@
 #include <sys/socket.h> // for recv, send
 #include <unistd.h>     // for close
 
-ASocket::ASocket(int fd, IoState event) : fd_(fd), ioState_(event)
+/**
+ * Takes ownership of fd. Pass nonBlocking when fd was created with O_NONBLOCK and FD_CLOEXEC already set, as by
+ * SOCK_NONBLOCK | SOCK_CLOEXEC, to skip the fcntl calls.
+ */
+ASocket::ASocket(int fd, IoState event, bool nonBlocking) : fd_(fd), ioState_(event)
 {
     Log::trace(LOCATION);
     if (fd_ == -1)
@@ -20,12 +24,16 @@ ASocket::ASocket(int fd, IoState event) : fd_(fd), ioState_(event)
         Log::error("Invalid file descriptor");
         throw std::runtime_error("Invalid file descriptor");
     }
-    setNonBlocking();
+    if (!nonBlocking)
+    {
+        setNonBlocking();
+    }
+    logFlags();
 }
 
 ASocket::~ASocket()
 {
-    Log::trace(LOCATION + "Closing socket fd: " + std::to_string(fd_));
+    Log::trace(LOCATION.toString() + "Closing socket fd: " + std::to_string(fd_));
     if (fd_ != -1)
     {
         close(fd_);
@@ -71,10 +79,16 @@ void ASocket::setNonBlocking() const
     {
         throw std::system_error(errno, std::generic_category(), "ASocket: Failed to set FD close-on-exec");
     }
+}
 
-    // Debug output
-    flags = fcntl(fd_, F_GETFL, 0);
-    fdFlags = fcntl(fd_, F_GETFD, 0);
+void ASocket::logFlags() const
+{
+    if constexpr (Log::COMPILE_TIME_LOG_LEVEL > Log::Level::Debug)
+    {
+        return;
+    }
+    int flags = fcntl(fd_, F_GETFL, 0);
+    int fdFlags = fcntl(fd_, F_GETFD, 0);
 
     std::string flagStr = "0x" + std::to_string(flags) + " (";
     int mode = flags & 3;
@@ -121,8 +135,12 @@ void ASocket::setIOState(IoState event)
     }
 
     Log::debug("Processing state change for socket " + std::to_string(fd_));
-    dirty_ = true;
     ioState_ = event;
+    if (!dirty_ && dirtyQueue_ != nullptr)
+    {
+        dirtyQueue_->push_back(this);
+    }
+    dirty_ = true;
 }
 
 void ASocket::processed()
@@ -131,6 +149,16 @@ void ASocket::processed()
     dirty_ = false;
 }
 
+/**
+ * Registers the queue that state changes are reported to, or detaches the socket with nullptr. The current state is
+ * considered applied.
+ */
+void ASocket::attach(std::vector<ASocket *> *dirtyQueue) noexcept
+{
+    dirtyQueue_ = dirtyQueue;
+    dirty_ = false;
+}
+
 void ASocket::setFd(int fd)
 {
     fd_ = fd;
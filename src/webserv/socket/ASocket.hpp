@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional> // for function
 #include <string>
+#include <vector> // for vector
 
 #include <sys/types.h> // for ssize_t
 
@@ -15,7 +16,9 @@ class ASocket
         CLIENT_SOCKET,
         SERVER_SOCKET,
         CGI_SOCKET,
-        TIMER_SOCKET
+        TIMER_SOCKET,
+        WATCH_SOCKET,
+        UPSTREAM_SOCKET
     };
 
     enum class IoState : uint32_t
@@ -23,10 +26,11 @@ class ASocket
         NONE = 0,
         READ = 1 << 0,
         WRITE = 1 << 1,
+        READ_WRITE = READ | WRITE,
     };
 
     ASocket() = delete;
-    explicit ASocket(int fd, IoState state = IoState::NONE);
+    explicit ASocket(int fd, IoState state = IoState::NONE, bool nonBlocking = false);
     ASocket(const ASocket &other) = delete;
     ASocket &operator=(const ASocket &other) = delete;
     ASocket(ASocket &&other) noexcept = default;
@@ -47,11 +51,13 @@ class ASocket
 
     void setIOState(IoState event);
     void processed();
+    void attach(std::vector<ASocket *> *dirtyQueue) noexcept;
 
     [[nodiscard]] virtual std::string toString() const;
 
   protected:
     void setNonBlocking() const;
+    void logFlags() const;
     void setFd(int fd);
 
   private:
@@ -59,4 +65,6 @@ class ASocket
     bool dirty_ = false;
     IoState ioState_;
     std::function<void()> callback_ = nullptr;
+    // Queue of the reactor polling this socket, which applies state changes to its epoll set
+    std::vector<ASocket *> *dirtyQueue_ = nullptr;
 };
@@ -3,7 +3,13 @@
 #include <webserv/log/Log.hpp>        // for LOCATION, Log
 #include <webserv/socket/ASocket.hpp> // for ASocket
 
-ClientSocket::ClientSocket(int fd, struct sockaddr address) : ASocket(fd), address_(address)
+#include <unistd.h> // for close
+
+/**
+ * Takes a connection accepted with SOCK_NONBLOCK | SOCK_CLOEXEC.
+ */
+ClientSocket::ClientSocket(int fd, struct sockaddr address)
+    : ASocket(fd, ASocket::IoState::NONE, true), address_(address)
 {
     Log::trace(LOCATION);
 }
@@ -18,6 +24,28 @@ const struct sockaddr *ClientSocket::getAddress() const noexcept
     return &address_;
 }
 
+/**
+ * Takes over a new connection after release(), so a pooled client can serve it without allocating a socket.
+ */
+void ClientSocket::assign(int fd, struct sockaddr address) noexcept
+{
+    setFd(fd);
+    address_ = address;
+}
+
+/**
+ * Closes the connection but keeps the object for the next assign(). The socket must be removed from its reactor first.
+ */
+void ClientSocket::release()
+{
+    if (getFd() != -1)
+    {
+        ::close(getFd());
+        setFd(-1);
+    }
+    setIOState(ASocket::IoState::NONE);
+}
+
 std::string ClientSocket::toString() const
 {
     return "(Client FD=" + std::to_string(getFd()) + ")";
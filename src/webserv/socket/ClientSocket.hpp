@@ -16,6 +16,9 @@ class ClientSocket : public ASocket
     [[nodiscard]] ASocket::Type getType() const noexcept override;
     [[nodiscard]] const struct sockaddr *getAddress() const noexcept;
 
+    void assign(int fd, struct sockaddr address) noexcept;
+    void release();
+
     [[nodiscard]] std::string toString() const override;
 
   private:
@@ -1,20 +1,21 @@
 #include <webserv/socket/ServerSocket.hpp>
 
-#include <webserv/log/Log.hpp>             // for Log, LOCATION
-#include <webserv/socket/ASocket.hpp>      // for ASocket
-#include <webserv/socket/ClientSocket.hpp> // for ClientSocket
+#include <webserv/log/Log.hpp>        // for Log, LOCATION
+#include <webserv/socket/ASocket.hpp> // for ASocket
 
-#include <memory>    // for allocator, make_unique, unique_ptr
+#include <cerrno>    // for errno, EAGAIN, EWOULDBLOCK, ECONNABORTED, EPROTO, EINTR, EMFILE, ENFILE
+#include <cstring>   // for strerror
 #include <stdexcept> // for runtime_error
 
 #include <arpa/inet.h>  // for htons, inet_addr
 #include <netinet/in.h> // for sockaddr_in, in_addr
 #include <stdint.h>     // for uint16_t
-#include <sys/socket.h> // for AF_INET, accept, bind, listen, setsockopt, socket, SOCK_STREAM, SOL_SOCKET, SO_REUSEADDR
+#include <sys/socket.h> // for AF_INET, accept4, bind, listen, setsockopt, socket, SOCK_STREAM, SOCK_NONBLOCK, SOCK_CLOEXEC, SOL_SOCKET, SO_REUSEADDR, SO_REUSEPORT
 #include <unistd.h>     // for close
 
-ServerSocket::ServerSocket(const std::string &host, int port)
-    : ASocket(socket(AF_INET, SOCK_STREAM, 0), ASocket::IoState::READ), host_(host), port_(port)
+ServerSocket::ServerSocket(const std::string &host, int port, bool reusePort)
+    : ASocket(socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0), ASocket::IoState::READ, true),
+      host_(host), port_(port)
 {
     Log::trace(LOCATION);
     if (getFd() == -1)
@@ -30,6 +31,14 @@ ServerSocket::ServerSocket(const std::string &host, int port)
         Log::error("setsockopt failed");
         throw std::runtime_error("setsockopt failed");
     }
+    // Lets every reactor bind its own listener to the same address; the kernel spreads connections between them
+    if (reusePort && setsockopt(getFd(), SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+    {
+        close(getFd());
+        setFd(-1);
+        Log::error("setsockopt SO_REUSEPORT failed");
+        throw std::runtime_error("setsockopt SO_REUSEPORT failed");
+    }
     bind(host_, port_);
     listen(SOMAXCONN);
 }
@@ -66,18 +75,37 @@ ASocket::Type ServerSocket::getType() const noexcept
     return ASocket::Type::SERVER_SOCKET;
 }
 
-std::unique_ptr<ClientSocket> ServerSocket::accept() const
+/**
+ * Takes the next pending connection and stores the peer in address. The descriptor is created with SOCK_NONBLOCK and
+ * SOCK_CLOEXEC, ready to hand to a ClientSocket. Returns -1 when none could be taken, errno then tells why: EAGAIN
+ * once the backlog is drained, EMFILE or ENFILE when out of file descriptors.
+ */
+int ServerSocket::accept(struct sockaddr &address) const
 {
     Log::trace(LOCATION);
-    struct sockaddr client_address{};
-    socklen_t address_len = sizeof(client_address);
-    int client_fd = ::accept(getFd(), &client_address, &address_len);
-    if (client_fd < 0)
+    while (true)
     {
-        Log::error("Accept failed");
-        throw std::runtime_error("Accept failed");
+        address = {};
+        socklen_t address_len = sizeof(address);
+        int client_fd = ::accept4(getFd(), &address, &address_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd >= 0)
+        {
+            return client_fd;
+        }
+        // The peer gave up while still in the backlog, the next one may be fine
+        if (errno == ECONNABORTED || errno == EPROTO || errno == EINTR)
+        {
+            continue;
+        }
+        // Another reactor or worker sharing this listener may have taken the connection first
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EMFILE && errno != ENFILE)
+        {
+            int error = errno;
+            Log::error(toString() + ": accept failed: " + std::strerror(error));
+            errno = error;
+        }
+        return -1;
     }
-    return std::make_unique<ClientSocket>(client_fd, client_address);
 }
 
 std::string ServerSocket::toString() const
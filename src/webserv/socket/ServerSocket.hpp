@@ -1,21 +1,21 @@
 #pragma once
 
 #include <webserv/socket/ASocket.hpp>
-#include <webserv/socket/ClientSocket.hpp>
 
-#include <memory> // for unique_ptr
 #include <string> // for string
 
+#include <sys/socket.h> // for sockaddr
+
 class ServerSocket : public ASocket
 {
   public:
-    ServerSocket(const std::string &host, int port);
+    ServerSocket(const std::string &host, int port, bool reusePort = false);
 
     void listen(int backlog) const;
     void bind(const std::string &host, int port) const;
 
     [[nodiscard]] ASocket::Type getType() const noexcept override;
-    [[nodiscard]] std::unique_ptr<ClientSocket> accept() const;
+    [[nodiscard]] int accept(struct sockaddr &address) const;
 
     [[nodiscard]] std::string toString() const override;
 
@@ -1,71 +1,45 @@
 #include <webserv/socket/TimerSocket.hpp>
 
-#include <webserv/log/Log.hpp>        // for LOCATION, Log
-#include <webserv/socket/ASocket.hpp> // for ASocket
+#include <webserv/log/Log.hpp>           // for LOCATION, Log
+#include <webserv/socket/TimerWheel.hpp> // for TimerWheel
 
-#include <stdexcept>    // for runtime_error
-#include <system_error> // for generic_category, system_error
+#include <string>  // for operator+, to_string
+#include <utility> // for move
 
-#include <errno.h>       // for errno
-#include <sys/time.h>    // for CLOCK_MONOTONIC
-#include <sys/timerfd.h> // for timerfd_create, timerfd_settime
-#include <time.h>        // for itimerspec, timespec
-#include <unistd.h>      // for read, write
+TimerSocket::TimerSocket(TimerWheel &wheel, std::chrono::milliseconds timeout) : wheel_(wheel), timeout_(timeout) {}
 
-TimerSocket::TimerSocket(std::chrono::milliseconds timeout)
-    : ASocket(timerfd_create(CLOCK_MONOTONIC, 0), ASocket::IoState::NONE), timeout_(timeout)
+TimerSocket::~TimerSocket()
 {
+    cancel();
 }
 
 void TimerSocket::activate()
 {
     Log::trace(LOCATION);
-    struct itimerspec timerSpec{};
-
-    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout_);
-    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout_ - seconds);
-
-    timerSpec.it_value.tv_sec = seconds.count();
-    timerSpec.it_value.tv_nsec = nanoseconds.count();
-    timerSpec.it_interval.tv_sec = 0;
-    timerSpec.it_interval.tv_nsec = 0;
-
-    if (timerfd_settime(getFd(), 0, &timerSpec, nullptr) == -1)
-    {
-        throw std::runtime_error("Failed to set timerfd time");
-    }
-
-    active_ = true;
-    setIOState(IoState::READ);
+    wheel_.schedule(*this, timeout_);
 }
 
-ASocket::Type TimerSocket::getType() const noexcept
+void TimerSocket::cancel() noexcept
 {
-    return ASocket::Type::TIMER_SOCKET;
+    wheel_.cancel(*this);
 }
 
-bool TimerSocket::isActive() const noexcept
+void TimerSocket::setTimeout(std::chrono::milliseconds timeout) noexcept
 {
-    return active_;
+    timeout_ = timeout;
 }
 
-ssize_t TimerSocket::read(void *buf, size_t len) const
+void TimerSocket::setCallback(std::function<void()> callback)
 {
-    Log::trace(LOCATION);
-    ssize_t bytesRead = ::read(getFd(), buf, len);
-
-    return bytesRead;
+    callback_ = std::move(callback);
 }
 
-ssize_t TimerSocket::write(const void *buf, size_t len) const
+bool TimerSocket::isActive() const noexcept
 {
-    Log::trace(LOCATION);
-    ssize_t bytesSent = ::write(getFd(), buf, len);
-
-    return bytesSent;
+    return active_;
 }
 
 std::string TimerSocket::toString() const
 {
-    return "(Timer FD=" + std::to_string(getFd()) + ")";
-}
\ No newline at end of file
+    return "(Timer " + std::to_string(timeout_.count()) + "ms)";
+}
@@ -1,29 +1,50 @@
 #pragma once
 
-#include <webserv/socket/ASocket.hpp> // for ASocket
-
-#include <chrono> // for milliseconds
-#include <string>
-
-#include <stddef.h>    // for size_t
-#include <sys/types.h> // for ssize_t
-
-class TimerSocket : public ASocket
+#include <chrono>     // for milliseconds
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <functional> // for function
+#include <list>       // for list
+#include <string>     // for string
+
+class TimerWheel;
+
+/**
+ * Handle to a timeout on the reactor's TimerWheel. It owns no file descriptor; activate() (re)starts the countdown in
+ * constant time and the callback runs once when it expires. Destroying the handle cancels it.
+ */
+class TimerSocket
 {
   public:
-    explicit TimerSocket(std::chrono::milliseconds timeout);
+    TimerSocket(TimerWheel &wheel, std::chrono::milliseconds timeout);
 
-    [[nodiscard]] ASocket::Type getType() const noexcept override;
-    [[nodiscard]] bool isActive() const noexcept;
+    TimerSocket(const TimerSocket &other) = delete;
+    TimerSocket &operator=(const TimerSocket &other) = delete;
+    TimerSocket(TimerSocket &&other) noexcept = delete;
+    TimerSocket &operator=(TimerSocket &&other) noexcept = delete;
+
+    ~TimerSocket();
 
-    ssize_t read(void *buf, size_t len) const override;
-    ssize_t write(const void *buf, size_t len) const override;
+    [[nodiscard]] bool isActive() const noexcept;
 
     void activate();
+    void cancel() noexcept;
+    void setTimeout(std::chrono::milliseconds timeout) noexcept;
+    void setCallback(std::function<void()> callback);
 
-    [[nodiscard]] std::string toString() const override;
+    [[nodiscard]] std::string toString() const;
 
   private:
-    bool active_ = false;
+    friend class TimerWheel;
+
+    TimerWheel &wheel_;
     std::chrono::milliseconds timeout_;
-};
\ No newline at end of file
+    std::function<void()> callback_ = nullptr;
+    bool active_ = false;
+
+    // Bookkeeping of the wheel
+    uint64_t deadline_ = 0;
+    bool linked_ = false;
+    size_t slot_ = 0;
+    std::list<TimerSocket *>::iterator position_;
+};
@@ -0,0 +1,204 @@
+#include <webserv/socket/TimerWheel.hpp>
+
+#include <webserv/log/Log.hpp>            // for LOCATION, Log
+#include <webserv/socket/ASocket.hpp>     // for ASocket
+#include <webserv/socket/TimerSocket.hpp> // for TimerSocket
+
+#include <algorithm>  // for max
+#include <cerrno>     // for errno, EBADF
+#include <functional> // for function
+#include <stdexcept>  // for runtime_error
+#include <string>     // for operator+, to_string
+
+#include <sys/timerfd.h> // for timerfd_create, timerfd_settime, TFD_NONBLOCK, TFD_CLOEXEC
+#include <time.h>        // for itimerspec, CLOCK_MONOTONIC
+#include <unistd.h>      // for read
+
+TimerWheel::TimerWheel()
+    : ASocket(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC), ASocket::IoState::READ, true),
+      start_(std::chrono::steady_clock::now())
+{
+    setCallback([this]() { expire(); });
+}
+
+ASocket::Type TimerWheel::getType() const noexcept
+{
+    return ASocket::Type::TIMER_SOCKET;
+}
+
+/**
+ * Number of pending timers.
+ */
+size_t TimerWheel::size() const noexcept
+{
+    return size_;
+}
+
+/**
+ * (Re)starts timer so that it fires once timeout has passed, rounded up to whole ticks.
+ */
+void TimerWheel::schedule(TimerSocket &timer, std::chrono::milliseconds timeout)
+{
+    if (!armed_)
+    {
+        // Nothing advanced the wheel while it was idle
+        currentTick_ = now();
+    }
+    auto ticks = static_cast<uint64_t>((timeout + WHEEL_TICK - std::chrono::milliseconds(1)) / WHEEL_TICK);
+    uint64_t deadline = now() + std::max<uint64_t>(ticks, 1);
+    timer.active_ = true;
+    if (timer.linked_ && timer.slot_ != FIRING && deadline >= timer.deadline_)
+    {
+        // The timer is rescheduled when its current bucket comes up
+        timer.deadline_ = deadline;
+        return;
+    }
+    if (timer.linked_)
+    {
+        unlink(timer);
+    }
+    timer.deadline_ = deadline;
+    link(timer);
+    rearm();
+}
+
+/**
+ * Stops timer. Never throws, since timers are cancelled from destructors: if the timerfd cannot be stopped it keeps
+ * ticking on an empty wheel, which is harmless, and stopping it is tried again on the next tick.
+ */
+void TimerWheel::cancel(TimerSocket &timer) noexcept
+{
+    timer.active_ = false;
+    if (timer.linked_)
+    {
+        unlink(timer);
+        static_cast<void>(tryRearm());
+    }
+}
+
+/**
+ * Advances the wheel to the current time and runs the callbacks of every timer that is due. Callbacks may destroy
+ * any timer, including the one being fired.
+ */
+void TimerWheel::expire()
+{
+    Log::trace(LOCATION);
+    uint64_t expirations = 0;
+    static_cast<void>(read(&expirations, sizeof(expirations)));
+
+    uint64_t target = now();
+    if (target - currentTick_ > WHEEL_SLOTS)
+    {
+        // Visiting every bucket once is enough to catch up
+        currentTick_ = target - WHEEL_SLOTS;
+    }
+    while (currentTick_ < target)
+    {
+        ++currentTick_;
+        fire(currentTick_ % WHEEL_SLOTS);
+    }
+    static_cast<void>(tryRearm());
+}
+
+void TimerWheel::fire(size_t slot)
+{
+    auto &firing = slots_.at(FIRING);
+    for (TimerSocket *timer : slots_.at(slot))
+    {
+        timer->slot_ = FIRING;
+    }
+    firing.splice(firing.end(), slots_.at(slot));
+    while (!firing.empty())
+    {
+        TimerSocket &timer = *firing.front();
+        unlink(timer);
+        if (timer.deadline_ > currentTick_)
+        {
+            link(timer);
+            continue;
+        }
+        timer.active_ = false;
+        // The callback may destroy the timer together with its callback
+        std::function<void()> callback = timer.callback_;
+        if (callback)
+        {
+            callback();
+        }
+    }
+}
+
+uint64_t TimerWheel::now() const
+{
+    return static_cast<uint64_t>((std::chrono::steady_clock::now() - start_) / WHEEL_TICK);
+}
+
+void TimerWheel::link(TimerSocket &timer)
+{
+    uint64_t tick = timer.deadline_ > currentTick_ ? timer.deadline_ : currentTick_ + 1;
+    timer.slot_ = tick % WHEEL_SLOTS;
+    auto &bucket = slots_.at(timer.slot_);
+    timer.position_ = bucket.insert(bucket.end(), &timer);
+    timer.linked_ = true;
+    ++size_;
+}
+
+void TimerWheel::unlink(TimerSocket &timer)
+{
+    slots_.at(timer.slot_).erase(timer.position_);
+    timer.linked_ = false;
+    --size_;
+}
+
+/**
+ * Like tryRearm(), but a timerfd that cannot be started is an error: the timers just scheduled would never fire.
+ */
+void TimerWheel::rearm()
+{
+    if (!tryRearm())
+    {
+        throw std::runtime_error("Failed to set timerfd time");
+    }
+}
+
+/**
+ * Lets the timerfd tick while timers are pending and stops it when the wheel runs empty. Returns false, with armed_
+ * unchanged, if timerfd_settime failed.
+ */
+bool TimerWheel::tryRearm() noexcept
+{
+    bool needed = size_ > 0;
+    if (needed == armed_)
+    {
+        return true;
+    }
+    struct itimerspec timerSpec{};
+    if (needed)
+    {
+        auto tick = std::chrono::duration_cast<std::chrono::nanoseconds>(WHEEL_TICK);
+        timerSpec.it_value.tv_nsec = tick.count();
+        timerSpec.it_interval.tv_nsec = tick.count();
+    }
+    if (timerfd_settime(getFd(), 0, &timerSpec, nullptr) == -1)
+    {
+        Log::error(toString() + ": timerfd_settime failed");
+        return false;
+    }
+    armed_ = needed;
+    return true;
+}
+
+ssize_t TimerWheel::read(void *buf, size_t len) const
+{
+    return ::read(getFd(), buf, len);
+}
+
+ssize_t TimerWheel::write(const void * /*buf*/, size_t /*len*/) const
+{
+    errno = EBADF;
+    return -1;
+}
+
+std::string TimerWheel::toString() const
+{
+    return "(TimerWheel FD=" + std::to_string(getFd()) + ", " + std::to_string(size_) + " pending)";
+}
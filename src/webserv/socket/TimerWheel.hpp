@@ -0,0 +1,67 @@
+#pragma once
+
+#include <webserv/socket/ASocket.hpp> // for ASocket
+
+#include <array>   // for array
+#include <chrono>  // for steady_clock, milliseconds
+#include <cstddef> // for size_t
+#include <cstdint> // for uint64_t
+#include <list>    // for list
+#include <string>  // for string
+
+#include <sys/types.h> // for ssize_t
+
+class TimerSocket;
+
+/**
+ * Hashed timer wheel driven by a single timerfd, one per reactor.
+ *
+ * Timers are kept in WHEEL_SLOTS buckets of WHEEL_TICK each; a timer further away than one revolution simply stays in
+ * its bucket for more rounds. Re-arming a timer only moves its deadline forward, it is rescheduled lazily when its
+ * bucket comes up, so the common reset on every read or write costs no list operation and no syscall. The timerfd
+ * ticks only while timers are pending.
+ */
+class TimerWheel : public ASocket
+{
+  public:
+    static constexpr size_t WHEEL_SLOTS = 1024;
+    static constexpr std::chrono::milliseconds WHEEL_TICK{100};
+
+    TimerWheel();
+
+    TimerWheel(const TimerWheel &other) = delete;
+    TimerWheel &operator=(const TimerWheel &other) = delete;
+    TimerWheel(TimerWheel &&other) noexcept = delete;
+    TimerWheel &operator=(TimerWheel &&other) noexcept = delete;
+
+    ~TimerWheel() override = default;
+
+    [[nodiscard]] ASocket::Type getType() const noexcept override;
+    [[nodiscard]] size_t size() const noexcept;
+
+    void schedule(TimerSocket &timer, std::chrono::milliseconds timeout);
+    void cancel(TimerSocket &timer) noexcept;
+    void expire();
+
+    ssize_t read(void *buf, size_t len) const override;
+    ssize_t write(const void *buf, size_t len) const override;
+
+    [[nodiscard]] std::string toString() const override;
+
+  private:
+    // Index of the list holding timers that are being fired
+    static constexpr size_t FIRING = WHEEL_SLOTS;
+
+    std::chrono::steady_clock::time_point start_;
+    uint64_t currentTick_ = 0;
+    size_t size_ = 0;
+    bool armed_ = false;
+    std::array<std::list<TimerSocket *>, WHEEL_SLOTS + 1> slots_;
+
+    [[nodiscard]] uint64_t now() const;
+    void link(TimerSocket &timer);
+    void unlink(TimerSocket &timer);
+    void fire(size_t slot);
+    void rearm();
+    [[nodiscard]] bool tryRearm() noexcept;
+};
@@ -0,0 +1,53 @@
+#include <webserv/socket/UpstreamPool.hpp>
+
+#include <webserv/log/Log.hpp>               // for Log, LOCATION
+#include <webserv/main.hpp>                  // for UPSTREAM_KEEPALIVE
+#include <webserv/socket/ASocket.hpp>        // for ASocket
+#include <webserv/socket/UpstreamSocket.hpp> // for UpstreamSocket
+
+#include <memory>  // for unique_ptr
+#include <string>  // for basic_string, operator+, string
+#include <utility> // for move
+#include <vector>  // for vector
+
+/**
+ * Returns the most recently released connection to address that is still open, or starts a new one. Throws when a
+ * new connection cannot be attempted.
+ */
+std::unique_ptr<UpstreamSocket> UpstreamPool::acquire(const std::string &address)
+{
+    Log::trace(LOCATION);
+    auto it = idle_.find(address);
+    if (it != idle_.end())
+    {
+        std::vector<std::unique_ptr<UpstreamSocket>> &sockets = it->second;
+        while (!sockets.empty())
+        {
+            std::unique_ptr<UpstreamSocket> socket = std::move(sockets.back());
+            sockets.pop_back();
+            if (socket->isAlive())
+            {
+                Log::debug(socket->toString() + ": reusing idle upstream connection");
+                return socket;
+            }
+            Log::debug(socket->toString() + ": idle upstream connection was closed");
+        }
+    }
+    return UpstreamSocket::connect(address);
+}
+
+/**
+ * Keeps socket for the next request to its address, up to Constants::UPSTREAM_KEEPALIVE idle connections per
+ * address. The socket must have been unregistered already and have no request in progress.
+ */
+void UpstreamPool::release(std::unique_ptr<UpstreamSocket> socket)
+{
+    Log::trace(LOCATION);
+    std::vector<std::unique_ptr<UpstreamSocket>> &sockets = idle_[socket->getAddress()];
+    if (!socket->isConnected() || sockets.size() >= Constants::UPSTREAM_KEEPALIVE)
+    {
+        return;
+    }
+    socket->setIOState(ASocket::IoState::WRITE);
+    sockets.push_back(std::move(socket));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <webserv/socket/UpstreamSocket.hpp> // for UpstreamSocket
+
+#include <memory>        // for unique_ptr
+#include <string>        // for string
+#include <unordered_map> // for unordered_map
+#include <vector>        // for vector
+
+/**
+ * Idle connections to backend servers, one pool per reactor. A handler takes a connection for the duration of one
+ * request and gives it back when the backend kept it open, so consecutive requests skip the connection setup. Idle
+ * connections are not registered with the event backend.
+ */
+class UpstreamPool
+{
+  public:
+    UpstreamPool() = default;
+
+    UpstreamPool(const UpstreamPool &other) = delete;
+    UpstreamPool &operator=(const UpstreamPool &other) = delete;
+    UpstreamPool(UpstreamPool &&other) noexcept = delete;
+    UpstreamPool &operator=(UpstreamPool &&other) noexcept = delete;
+
+    ~UpstreamPool() = default;
+
+    [[nodiscard]] std::unique_ptr<UpstreamSocket> acquire(const std::string &address);
+    void release(std::unique_ptr<UpstreamSocket> socket);
+
+  private:
+    std::unordered_map<std::string, std::vector<std::unique_ptr<UpstreamSocket>>> idle_;
+};
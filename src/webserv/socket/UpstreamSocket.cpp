@@ -0,0 +1,178 @@
+#include <webserv/socket/UpstreamSocket.hpp>
+
+#include <webserv/log/Log.hpp>        // for Log, LOCATION
+#include <webserv/socket/ASocket.hpp> // for ASocket
+
+#include <cerrno>      // for errno, EINPROGRESS, EAGAIN, EWOULDBLOCK
+#include <charconv>    // for from_chars
+#include <cstddef>     // for offsetof
+#include <cstdint>     // for uint16_t
+#include <cstring>     // for strerror, memcpy
+#include <stdexcept>   // for runtime_error
+#include <string>      // for basic_string, operator+, string, to_string
+#include <string_view> // for string_view
+#include <utility>     // for move
+
+#include <arpa/inet.h>  // for htons, inet_pton
+#include <netinet/in.h> // for sockaddr_in
+#include <sys/socket.h> // for socket, connect, getsockopt, recv, sockaddr_storage, AF_INET, AF_UNIX, MSG_PEEK
+#include <sys/un.h>     // for sockaddr_un
+#include <unistd.h>     // for close
+
+/**
+ * Fills storage from "unix:/path", "unix:@name" for a name in the abstract namespace, or "ipv4:port". Returns false
+ * when address is none of these.
+ */
+static inline bool parseAddress(const std::string &address, struct sockaddr_storage &storage, socklen_t &length)
+{
+    constexpr std::string_view unixPrefix = "unix:";
+    if (address.starts_with(unixPrefix))
+    {
+        std::string path = address.substr(unixPrefix.size());
+        struct sockaddr_un un{};
+        if (path.empty() || path.size() >= sizeof(un.sun_path))
+        {
+            return false;
+        }
+        un.sun_family = AF_UNIX;
+        std::memcpy(static_cast<char *>(un.sun_path), path.c_str(), path.size() + 1);
+        length = sizeof(un);
+        if (path.starts_with('@'))
+        {
+            // Abstract names start with a null byte and are not null terminated
+            un.sun_path[0] = '\0';
+            length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size());
+        }
+        std::memcpy(&storage, &un, sizeof(un));
+        return true;
+    }
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos)
+    {
+        return false;
+    }
+    std::string host = address.substr(0, colon);
+    int port = 0;
+    const char *first = address.data() + colon + 1;   // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const char *last = address.data() + address.size(); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto [ptr, ec] = std::from_chars(first, last, port);
+    if (first == last || ec != std::errc() || ptr != last || port < 1 || port > 65535)
+    {
+        return false;
+    }
+    struct sockaddr_in in{};
+    in.sin_family = AF_INET;
+    in.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &in.sin_addr) != 1)
+    {
+        return false;
+    }
+    std::memcpy(&storage, &in, sizeof(in));
+    length = sizeof(in);
+    return true;
+}
+
+/**
+ * Takes a socket created with SOCK_NONBLOCK | SOCK_CLOEXEC. It starts out waiting to write: for the connection to
+ * complete, or to send the first request.
+ */
+UpstreamSocket::UpstreamSocket(int fd, std::string address, bool connected)
+    : ASocket(fd, ASocket::IoState::WRITE, true), address_(std::move(address)), connected_(connected)
+{
+    Log::trace(LOCATION);
+}
+
+/**
+ * Starts connecting to address. Throws when it cannot even be attempted or is refused right away, as a Unix socket
+ * without a listener is.
+ */
+std::unique_ptr<UpstreamSocket> UpstreamSocket::connect(const std::string &address)
+{
+    Log::trace(LOCATION);
+    struct sockaddr_storage storage{};
+    socklen_t length = 0;
+    if (!parseAddress(address, storage, length))
+    {
+        Log::error("Invalid upstream address: " + address);
+        throw std::runtime_error("Invalid upstream address: " + address);
+    }
+    int fd = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+    {
+        Log::error("Upstream socket creation failed: " + std::string(strerror(errno)));
+        throw std::runtime_error("Upstream socket creation failed");
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    int result = ::connect(fd, reinterpret_cast<struct sockaddr *>(&storage), length);
+    if (result == -1 && errno != EINPROGRESS)
+    {
+        std::string reason = strerror(errno);
+        close(fd);
+        Log::error("Cannot connect to upstream " + address + ": " + reason);
+        throw std::runtime_error("Cannot connect to upstream " + address);
+    }
+    return std::make_unique<UpstreamSocket>(fd, address, result == 0);
+}
+
+bool UpstreamSocket::isValidAddress(const std::string &address)
+{
+    struct sockaddr_storage storage{};
+    socklen_t length = 0;
+    return parseAddress(address, storage, length);
+}
+
+ASocket::Type UpstreamSocket::getType() const noexcept
+{
+    return ASocket::Type::UPSTREAM_SOCKET;
+}
+
+const std::string &UpstreamSocket::getAddress() const noexcept
+{
+    return address_;
+}
+
+bool UpstreamSocket::isConnected() const noexcept
+{
+    return connected_;
+}
+
+/**
+ * An idle connection can be reused as long as the backend has neither closed it nor sent anything unasked.
+ */
+bool UpstreamSocket::isAlive() const
+{
+    char byte = 0;
+    ssize_t peeked = recv(getFd(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return peeked == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+size_t UpstreamSocket::getRequestCount() const noexcept
+{
+    return requests_;
+}
+
+void UpstreamSocket::countRequest() noexcept
+{
+    ++requests_;
+}
+
+/**
+ * Called once the socket became writable after connect(). Returns 0 when the connection was established, otherwise
+ * the error it failed with.
+ */
+int UpstreamSocket::finishConnect()
+{
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(getFd(), SOL_SOCKET, SO_ERROR, &error, &length) == -1)
+    {
+        return errno;
+    }
+    connected_ = error == 0;
+    return error;
+}
+
+std::string UpstreamSocket::toString() const
+{
+    return "(Upstream FD=" + std::to_string(getFd()) + ", " + address_ + ")";
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <webserv/socket/ASocket.hpp> // for ASocket
+
+#include <cstddef> // for size_t
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+
+/**
+ * Connection to a backend application server, such as a FastCGI process manager. The address is either
+ * "unix:/path/to/socket", "unix:@name" for a socket in the abstract namespace, or "ipv4:port". The connection is set
+ * up without blocking, so it may still be in progress when connect() returns.
+ */
+class UpstreamSocket : public ASocket
+{
+  public:
+    UpstreamSocket(int fd, std::string address, bool connected);
+
+    [[nodiscard]] static std::unique_ptr<UpstreamSocket> connect(const std::string &address);
+    [[nodiscard]] static bool isValidAddress(const std::string &address);
+
+    [[nodiscard]] ASocket::Type getType() const noexcept override;
+    [[nodiscard]] const std::string &getAddress() const noexcept;
+    [[nodiscard]] bool isConnected() const noexcept;
+    [[nodiscard]] bool isAlive() const;
+    [[nodiscard]] size_t getRequestCount() const noexcept;
+
+    void countRequest() noexcept;
+
+    [[nodiscard]] int finishConnect();
+
+    [[nodiscard]] std::string toString() const override;
+
+  private:
+    std::string address_;
+    bool connected_;
+    // Requests the backend completed on this connection
+    size_t requests_ = 0;
+};
@@ -0,0 +1,65 @@
+#include <webserv/socket/WatchSocket.hpp>
+
+#include <webserv/log/Log.hpp>        // for LOCATION, Log
+#include <webserv/socket/ASocket.hpp> // for ASocket
+
+#include <cstring>   // for strerror
+#include <stdexcept> // for runtime_error
+#include <string>    // for operator+, to_string
+
+#include <errno.h>       // for errno, EBADF
+#include <sys/inotify.h> // for inotify_init1, inotify_add_watch, inotify_rm_watch, IN_NONBLOCK, IN_CLOEXEC
+#include <unistd.h>      // for read
+
+WatchSocket::WatchSocket() : ASocket(inotify_init1(IN_NONBLOCK | IN_CLOEXEC), ASocket::IoState::READ, true)
+{
+    Log::trace(LOCATION);
+    if (getFd() == -1)
+    {
+        Log::error("inotify_init1 failed");
+        throw std::runtime_error("inotify_init1 failed");
+    }
+}
+
+ASocket::Type WatchSocket::getType() const noexcept
+{
+    return ASocket::Type::WATCH_SOCKET;
+}
+
+/**
+ * Returns the watch descriptor for path, or -1 with errno set if it cannot be watched. Watching the same path twice
+ * returns the same descriptor.
+ */
+int WatchSocket::addWatch(const std::string &path, uint32_t mask) const
+{
+    int wd = inotify_add_watch(getFd(), path.c_str(), mask);
+    if (wd == -1)
+    {
+        int error = errno;
+        Log::warning(toString() + ": cannot watch " + path + ": " + strerror(error));
+        errno = error;
+    }
+    return wd;
+}
+
+void WatchSocket::removeWatch(int wd) const
+{
+    inotify_rm_watch(getFd(), wd);
+}
+
+ssize_t WatchSocket::read(void *buf, size_t len) const
+{
+    Log::trace(LOCATION);
+    return ::read(getFd(), buf, len);
+}
+
+ssize_t WatchSocket::write(const void * /*buf*/, size_t /*len*/) const
+{
+    errno = EBADF;
+    return -1;
+}
+
+std::string WatchSocket::toString() const
+{
+    return "(Watch FD=" + std::to_string(getFd()) + ")";
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <webserv/socket/ASocket.hpp> // for ASocket
+
+#include <cstdint> // for uint32_t
+#include <string>  // for string
+
+#include <stddef.h>    // for size_t
+#include <sys/types.h> // for ssize_t
+
+/**
+ * Non-blocking inotify instance. It is polled by the reactor like any other socket; whoever owns the watches reads
+ * and interprets the events from its callback.
+ */
+class WatchSocket : public ASocket
+{
+  public:
+    WatchSocket();
+
+    [[nodiscard]] ASocket::Type getType() const noexcept override;
+
+    [[nodiscard]] int addWatch(const std::string &path, uint32_t mask) const;
+    void removeWatch(int wd) const;
+
+    ssize_t read(void *buf, size_t len) const override;
+    ssize_t write(const void *buf, size_t len) const override;
+
+    [[nodiscard]] std::string toString() const override;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>          // for unique_ptr, destroy_at
+#include <memory_resource> // for memory_resource, polymorphic_allocator
+#include <utility>         // for forward
+
+/**
+ * Deleter for objects placed in a monotonic arena: it only runs the destructor, the memory is reclaimed when the
+ * arena is released.
+ */
+template <typename T> struct ArenaDelete
+{
+    ArenaDelete() noexcept = default;
+
+    // Lets an ArenaPtr<Derived> convert to an ArenaPtr<Base>, like std::default_delete
+    template <typename U>
+    ArenaDelete(const ArenaDelete<U> & /* other */) noexcept // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    void operator()(T *object) const noexcept { std::destroy_at(object); }
+};
+
+template <typename T> using ArenaPtr = std::unique_ptr<T, ArenaDelete<T>>;
+
+/**
+ * Constructs a T in arena. The result must be destroyed before the arena is released.
+ */
+template <typename T, typename... Args> ArenaPtr<T> makeArena(std::pmr::memory_resource *arena, Args &&...args)
+{
+    return ArenaPtr<T>(std::pmr::polymorphic_allocator<>(arena).new_object<T>(std::forward<Args>(args)...));
+}
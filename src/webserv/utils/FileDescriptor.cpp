@@ -0,0 +1,18 @@
+#include <webserv/utils/FileDescriptor.hpp>
+
+#include <unistd.h> // for close
+
+FileDescriptor::FileDescriptor(int fd) noexcept : fd_(fd) {}
+
+FileDescriptor::~FileDescriptor()
+{
+    if (fd_ != -1)
+    {
+        close(fd_);
+    }
+}
+
+int FileDescriptor::get() const noexcept
+{
+    return fd_;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * Owns a file descriptor and closes it on destruction. Shared between the open file cache and the responses that
+ * are still sending from it, so an evicted descriptor stays open until the last transfer finishes.
+ */
+class FileDescriptor
+{
+  public:
+    explicit FileDescriptor(int fd) noexcept;
+
+    FileDescriptor(const FileDescriptor &other) = delete;
+    FileDescriptor &operator=(const FileDescriptor &other) = delete;
+    FileDescriptor(FileDescriptor &&other) noexcept = delete;
+    FileDescriptor &operator=(FileDescriptor &&other) noexcept = delete;
+
+    ~FileDescriptor();
+
+    [[nodiscard]] int get() const noexcept;
+
+  private:
+    int fd_;
+};
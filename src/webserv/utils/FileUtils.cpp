@@ -9,7 +9,9 @@
 #include <string>   // for basic_string, string, char_traits, operator+
 #include <vector>
 
-#include <sys/stat.h> // for stat, S_ISDIR, S_ISREG
+#include <fcntl.h>    // for open, O_RDONLY, O_CLOEXEC
+#include <sys/stat.h> // for stat, fstat, S_ISDIR, S_ISREG
+#include <unistd.h>   // for close
 
 namespace FileUtils
 {
@@ -107,6 +109,30 @@ std::vector<char> readBinaryFile(const std::string &filepath)
     return buffer;
 }
 
+/**
+ * Opens a regular file for reading and reports its size. Returns -1 on failure; the caller owns the descriptor.
+ */
+int openFile(const std::string &filepath, size_t &size)
+{
+    Log::trace(LOCATION);
+
+    int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd == -1)
+    {
+        Log::error("Failed to open file: " + filepath);
+        return -1;
+    }
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        Log::error("Failed to determine file size: " + filepath);
+        close(fd);
+        return -1;
+    }
+    size = static_cast<size_t>(fileStat.st_size);
+    return fd;
+}
+
 std::string readFileAsString(const std::string &filepath)
 {
     Log::trace(LOCATION);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>    // for size_t
 #include <filesystem> // for directory_entry
 #include <string>     // for string
 #include <vector>     // for vector
@@ -14,6 +15,7 @@ std::string getExtension(const std::string &filename);
 std::string joinPath(const std::string &base, const std::string &addition);
 
 std::vector<char> readBinaryFile(const std::string &filepath);
+int openFile(const std::string &filepath, size_t &size);
 std::string readFileAsString(const std::string &filepath);
 
 std::vector<std::filesystem::directory_entry> listDirectory(const std::string &dirpath);
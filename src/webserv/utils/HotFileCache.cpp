@@ -0,0 +1,375 @@
+#include <webserv/utils/HotFileCache.hpp>
+
+#include <webserv/config/ConfigManager.hpp> // for ConfigManager
+#include <webserv/config/GlobalConfig.hpp>  // for GlobalConfig
+#include <webserv/log/Log.hpp>              // for Log, LOCATION
+#include <webserv/main.hpp>                 // for HOT_FILE_CACHE, HOT_FILE_CACHE_MAX_FILE
+#include <webserv/utils/FileDescriptor.hpp> // for FileDescriptor
+#include <webserv/utils/FileUtils.hpp>      // for joinPath
+#include <webserv/utils/OpenFileCache.hpp>  // for OpenFileCache
+
+#include <array>     // for array
+#include <atomic>    // for atomic
+#include <cerrno>    // for errno, EINTR, ENOSPC, ENOMEM
+#include <cstdint>   // for uintptr_t
+#include <exception> // for exception
+#include <memory>    // for make_shared, make_unique
+#include <string>    // for string, operator+, to_string
+#include <utility>   // for move
+#include <vector>    // for vector
+
+#include <fcntl.h>       // for open, O_RDONLY, O_CLOEXEC
+#include <sys/inotify.h> // for inotify_event, IN_*
+#include <sys/stat.h>    // for fstat, S_ISREG
+#include <unistd.h>      // for pread
+
+static constexpr uint32_t WATCH_MASK = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM
+                                       | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+// Set once any thread lost its change notifications; every other thread drops its cache when it next uses it
+static std::atomic<bool> disabledEverywhere{false};
+
+static inline std::string responseKey(const AConfig *config, const std::string &target)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return std::to_string(reinterpret_cast<uintptr_t>(config)) + ':' + target;
+}
+
+static inline std::string fileKey(const std::string &path)
+{
+    return "file:" + path;
+}
+
+static inline std::string parentDirectory(const std::string &path)
+{
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos)
+    {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+static inline std::string baseName(const std::string &path)
+{
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+/**
+ * Appends size bytes of fd to data. Returns false if the file is shorter than expected or cannot be read.
+ */
+static inline bool readInto(std::vector<uint8_t> &data, int fd, size_t size)
+{
+    size_t offset = data.size();
+    data.resize(offset + size);
+    size_t done = 0;
+    while (done < size)
+    {
+        ssize_t bytesRead = pread(fd, data.data() + offset + done, size - done, static_cast<off_t>(done));
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytesRead <= 0)
+        {
+            return false;
+        }
+        done += static_cast<size_t>(bytesRead);
+    }
+    return true;
+}
+
+HotFileCache::HotFileCache(size_t capacity, size_t maxFileSize) : capacity_(capacity), maxFileSize_(maxFileSize)
+{
+    if (capacity_ == 0)
+    {
+        return;
+    }
+    try
+    {
+        socket_ = std::make_unique<WatchSocket>();
+        socket_->setCallback([this]() { handleEvents(); });
+    }
+    catch (const std::exception &e)
+    {
+        capacity_ = 0;
+        disableEverywhere("cannot create an inotify instance: " + std::string(e.what()));
+    }
+}
+
+/**
+ * The cache of the calling thread, sized from the global hot_file_cache directives on first use.
+ */
+HotFileCache &HotFileCache::get()
+{
+    thread_local HotFileCache cache = []() {
+        const GlobalConfig *config = ConfigManager::getInstance().getGlobalConfig();
+        size_t capacity = HOT_FILE_CACHE;
+        size_t maxFileSize = HOT_FILE_CACHE_MAX_FILE;
+        if (config != nullptr)
+        {
+            capacity = config->get<size_t>("hot_file_cache").value_or(HOT_FILE_CACHE);
+            maxFileSize = config->get<size_t>("hot_file_cache_max_file").value_or(HOT_FILE_CACHE_MAX_FILE);
+        }
+        return HotFileCache(capacity, maxFileSize);
+    }();
+    return cache;
+}
+
+/**
+ * The inotify socket the owning reactor has to poll, or nullptr when the cache is disabled.
+ */
+WatchSocket *HotFileCache::getSocket() const noexcept
+{
+    return socket_.get();
+}
+
+/**
+ * Returns the serialized header fields and body stored for target in config, and the path of the file it was read
+ * from, or nullptr on a miss.
+ */
+HotFileCache::Data HotFileCache::findResponse(const AConfig *config, const std::string &target, std::string &path)
+{
+    return find(responseKey(config, target), &path);
+}
+
+/**
+ * Reads size bytes of the open file behind fd and stores them after fields, the already serialized header fields.
+ * Returns nullptr when the file does not fit the cache, the caller then serves it from disk.
+ */
+HotFileCache::Data HotFileCache::storeResponse(const AConfig *config, const std::string &target,
+                                               const std::string &path, const std::string &fields, int fd, size_t size)
+{
+    if (!isEnabled() || size > maxFileSize_ || fields.size() + size > capacity_)
+    {
+        return nullptr;
+    }
+    std::vector<uint8_t> data;
+    data.reserve(fields.size() + size);
+    data.assign(fields.begin(), fields.end());
+    if (!readInto(data, fd, size))
+    {
+        Log::warning("Hot file cache: short read on " + path);
+        return nullptr;
+    }
+    return insert(responseKey(config, target), path, std::move(data));
+}
+
+/**
+ * Returns the contents of the file at path, from memory when possible, or nullptr if it cannot be read.
+ */
+HotFileCache::Data HotFileCache::loadFile(const std::string &path)
+{
+    std::string key = fileKey(path);
+    if (Data data = find(key, nullptr))
+    {
+        return data;
+    }
+    FileDescriptor file(::open(path.c_str(), O_RDONLY | O_CLOEXEC)); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    struct stat fileStat{};
+    if (file.get() == -1 || fstat(file.get(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        return nullptr;
+    }
+    std::vector<uint8_t> data;
+    if (!readInto(data, file.get(), static_cast<size_t>(fileStat.st_size)))
+    {
+        return nullptr;
+    }
+    if (!isEnabled() || data.size() > maxFileSize_)
+    {
+        return std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    }
+    return insert(key, path, std::move(data));
+}
+
+/**
+ * Drops every entry and stops caching, for when change notifications can no longer be trusted.
+ */
+void HotFileCache::disable()
+{
+    clear();
+    capacity_ = 0;
+}
+
+/**
+ * Stops caching in every thread of the process. Called when the kernel refuses an inotify instance or watch for lack
+ * of resources, which would otherwise leave some threads caching and others not.
+ */
+void HotFileCache::disableEverywhere(const std::string &reason)
+{
+    if (!disabledEverywhere.exchange(true))
+    {
+        Log::error("Hot file cache disabled in every thread: " + reason
+                   + " (raise fs.inotify.max_user_instances and fs.inotify.max_user_watches, or lower worker_threads)");
+    }
+}
+
+/**
+ * Catches up with a process-wide disable that happened in another thread.
+ */
+bool HotFileCache::isEnabled()
+{
+    if (capacity_ != 0 && disabledEverywhere.load(std::memory_order_relaxed))
+    {
+        disable();
+    }
+    return capacity_ != 0;
+}
+
+void HotFileCache::clear()
+{
+    while (!lru_.empty())
+    {
+        std::string oldest = lru_.back();
+        erase(oldest);
+    }
+}
+
+HotFileCache::Data HotFileCache::find(const std::string &key, std::string *path)
+{
+    if (!isEnabled())
+    {
+        return nullptr;
+    }
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+    if (path != nullptr)
+    {
+        *path = it->second.path;
+    }
+    return it->second.data;
+}
+
+/**
+ * Stores data under key and watches the directory of path. Data that cannot be watched is returned without being
+ * cached, since nothing would ever invalidate it.
+ */
+HotFileCache::Data HotFileCache::insert(const std::string &key, const std::string &path, std::vector<uint8_t> data)
+{
+    auto shared = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    if (shared->size() > capacity_)
+    {
+        return shared;
+    }
+    erase(key);
+    while (size_ + shared->size() > capacity_ && !lru_.empty())
+    {
+        std::string oldest = lru_.back();
+        erase(oldest);
+    }
+
+    // Evict first: dropping the last entry of a directory removes its watch, which may be the one we are about to add
+    std::string dir = parentDirectory(path);
+    int wd = socket_->addWatch(dir, WATCH_MASK);
+    if (wd == -1)
+    {
+        if (errno == ENOSPC || errno == ENOMEM)
+        {
+            disableEverywhere("cannot watch " + dir);
+            disable();
+        }
+        return shared;
+    }
+    Watch &watch = watches_[wd];
+    watch.dir = dir;
+    watch.keys.insert(key);
+
+    lru_.push_front(key);
+    entries_.emplace(key, Entry{.path = path, .data = shared, .wd = wd, .lruPosition = lru_.begin()});
+    size_ += shared->size();
+    Log::debug("Hot file cache: stored " + path + " (" + std::to_string(shared->size()) + " bytes, "
+               + std::to_string(size_) + " of " + std::to_string(capacity_) + " used)");
+    return shared;
+}
+
+void HotFileCache::erase(const std::string &key)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    int wd = it->second.wd;
+    size_ -= it->second.data->size();
+    lru_.erase(it->second.lruPosition);
+    entries_.erase(it);
+
+    auto watch = watches_.find(wd);
+    if (watch == watches_.end())
+    {
+        return;
+    }
+    watch->second.keys.erase(key);
+    if (watch->second.keys.empty())
+    {
+        socket_->removeWatch(wd);
+        watches_.erase(watch);
+    }
+}
+
+/**
+ * Drains the inotify queue. A change to a file only drops the entries read from that file; anything that changes
+ * the directory itself (files created, removed or renamed) drops every entry in it, since it may change how targets
+ * resolve.
+ */
+void HotFileCache::handleEvents()
+{
+    Log::trace(LOCATION);
+    alignas(struct inotify_event) std::array<char, 4096> buffer{};
+    while (true)
+    {
+        ssize_t bytesRead = socket_->read(buffer.data(), buffer.size());
+        if (bytesRead <= 0)
+        {
+            return;
+        }
+        for (size_t offset = 0; offset < static_cast<size_t>(bytesRead);)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto *event = reinterpret_cast<const struct inotify_event *>(buffer.data() + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                Log::warning("Hot file cache: inotify queue overflowed, dropping all entries");
+                clear();
+                continue;
+            }
+            auto watch = watches_.find(event->wd);
+            if (watch == watches_.end())
+            {
+                continue;
+            }
+            if (event->len > 0)
+            {
+                // The open file cache would otherwise keep describing the old file until its entry expires
+                OpenFileCache::get().invalidate(FileUtils::joinPath(watch->second.dir, event->name));
+            }
+            bool fileChanged = event->len > 0 && (event->mask & (IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE)) != 0;
+            std::vector<std::string> stale;
+            for (const auto &key : watch->second.keys)
+            {
+                if (!fileChanged || baseName(entries_.at(key).path) == event->name)
+                {
+                    stale.push_back(key);
+                }
+            }
+            for (const auto &key : stale)
+            {
+                Log::debug("Hot file cache: invalidated " + entries_.at(key).path);
+                erase(key);
+            }
+            if ((event->mask & IN_IGNORED) != 0)
+            {
+                // The kernel already dropped the watch
+                watches_.erase(event->wd);
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <webserv/socket/WatchSocket.hpp> // for WatchSocket
+
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint8_t
+#include <list>          // for list
+#include <memory>        // for shared_ptr, unique_ptr
+#include <string>        // for string
+#include <unordered_map> // for unordered_map
+#include <unordered_set> // for unordered_set
+#include <vector>        // for vector
+
+class AConfig;
+
+/**
+ * Keeps small, frequently requested files in memory. Static file responses are stored fully serialized, header fields
+ * and body, under the location they were matched in and the request target, so a hit needs neither disk probes nor a
+ * MIME lookup. Error page files are stored by path.
+ *
+ * Each reactor thread (and each worker process) has its own instance. The total size is bounded by hot_file_cache
+ * and evicted least recently used first. Entries are dropped as soon as inotify reports a change in the directory of
+ * their file; the inotify descriptor is registered in the reactor's epoll set. When the kernel runs out of inotify
+ * instances or watches (fs.inotify.max_user_instances, max_user_watches) for any thread, caching stops in every thread
+ * of the process, so no thread keeps serving files it cannot see change while the others do not.
+ */
+class HotFileCache
+{
+  public:
+    using Data = std::shared_ptr<const std::vector<uint8_t>>;
+
+    HotFileCache(size_t capacity, size_t maxFileSize);
+
+    HotFileCache(const HotFileCache &other) = delete;
+    HotFileCache &operator=(const HotFileCache &other) = delete;
+    HotFileCache(HotFileCache &&other) noexcept = delete;
+    HotFileCache &operator=(HotFileCache &&other) noexcept = delete;
+
+    ~HotFileCache() = default;
+
+    static HotFileCache &get();
+
+    [[nodiscard]] WatchSocket *getSocket() const noexcept;
+
+    [[nodiscard]] Data findResponse(const AConfig *config, const std::string &target, std::string &path);
+    [[nodiscard]] Data storeResponse(const AConfig *config, const std::string &target, const std::string &path,
+                                     const std::string &fields, int fd, size_t size);
+    [[nodiscard]] Data loadFile(const std::string &path);
+    void disable();
+    static void disableEverywhere(const std::string &reason);
+
+  private:
+    struct Entry
+    {
+        std::string path;
+        Data data;
+        int wd;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    struct Watch
+    {
+        std::string dir;
+        std::unordered_set<std::string> keys;
+    };
+
+    size_t capacity_;
+    size_t maxFileSize_;
+    size_t size_ = 0;
+    std::unique_ptr<WatchSocket> socket_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<int, Watch> watches_;
+    std::list<std::string> lru_; // most recently used first
+
+    [[nodiscard]] bool isEnabled();
+    Data find(const std::string &key, std::string *path);
+    Data insert(const std::string &key, const std::string &path, std::vector<uint8_t> data);
+    void erase(const std::string &key);
+    void clear();
+    void handleEvents();
+};
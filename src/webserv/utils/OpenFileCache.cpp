@@ -0,0 +1,233 @@
+#include <webserv/utils/OpenFileCache.hpp>
+
+#include <webserv/config/ConfigManager.hpp> // for ConfigManager
+#include <webserv/config/GlobalConfig.hpp>  // for GlobalConfig
+#include <webserv/log/Log.hpp>              // for Log, LOCATION
+#include <webserv/main.hpp>                 // for OPEN_FILE_CACHE, OPEN_FILE_CACHE_VALID, WORKER_THREADS
+#include <webserv/utils/FileDescriptor.hpp> // for FileDescriptor
+#include <webserv/utils/FileUtils.hpp>      // for openFile
+
+#include <algorithm> // for max, min
+#include <cerrno>    // for errno, EMFILE, ENFILE
+#include <chrono>    // for steady_clock, seconds
+#include <memory>    // for shared_ptr, make_shared
+#include <mutex>     // for once_flag, call_once
+#include <string>    // for string, operator+, to_string
+#include <utility>   // for pair
+
+#include <fcntl.h>        // for open, O_RDONLY, O_CLOEXEC
+#include <sys/resource.h> // for getrlimit, rlimit, RLIMIT_NOFILE
+#include <sys/stat.h>     // for stat, fstat, S_ISDIR, S_ISREG
+
+static inline OpenFileCache::FileInfo toFileInfo(const struct stat &fileStat)
+{
+    return {.exists = true,
+            .isFile = S_ISREG(fileStat.st_mode),
+            .isDirectory = S_ISDIR(fileStat.st_mode),
+            .size = static_cast<size_t>(fileStat.st_size),
+            .mtime = fileStat.st_mtime};
+}
+
+OpenFileCache::OpenFileCache(size_t capacity, std::chrono::seconds validity) : capacity_(capacity), validity_(validity)
+{
+}
+
+/**
+ * Caps capacity at the share of RLIMIT_NOFILE one reactor thread may fill with cached descriptors: a quarter of the
+ * descriptor table, split between the threads, leaving the rest for clients, CGI pipes and upstream connections.
+ */
+static inline size_t limitCapacity(size_t capacity, size_t threads)
+{
+    struct rlimit limit{};
+    if (capacity == 0 || getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY)
+    {
+        return capacity;
+    }
+    size_t share = static_cast<size_t>(limit.rlim_cur) / 4 / std::max<size_t>(threads, 1);
+    if (capacity > share)
+    {
+        static std::once_flag logged;
+        std::call_once(logged, [&]() {
+            Log::warning("open_file_cache " + std::to_string(capacity) + " exceeds the descriptor limit of "
+                         + std::to_string(limit.rlim_cur) + "; caching up to " + std::to_string(share)
+                         + " files per reactor");
+        });
+    }
+    return std::min(capacity, share);
+}
+
+/**
+ * The cache of the calling thread, sized from the global open_file_cache directives on first use.
+ */
+OpenFileCache &OpenFileCache::get()
+{
+    thread_local OpenFileCache cache = []() {
+        const GlobalConfig *config = ConfigManager::getInstance().getGlobalConfig();
+        int capacity = OPEN_FILE_CACHE;
+        int validity = OPEN_FILE_CACHE_VALID;
+        int threads = WORKER_THREADS;
+        if (config != nullptr)
+        {
+            capacity = config->get<int>("open_file_cache").value_or(OPEN_FILE_CACHE);
+            validity = config->get<int>("open_file_cache_valid").value_or(OPEN_FILE_CACHE_VALID);
+            threads = config->get<int>("worker_threads").value_or(WORKER_THREADS);
+        }
+        return OpenFileCache(limitCapacity(static_cast<size_t>(capacity), static_cast<size_t>(threads)),
+                             std::chrono::seconds(validity));
+    }();
+    return cache;
+}
+
+OpenFileCache::FileInfo OpenFileCache::stat(const std::string &path)
+{
+    if (const Entry *entry = find(path))
+    {
+        return entry->info;
+    }
+    struct stat fileStat{};
+    if (::stat(path.c_str(), &fileStat) != 0)
+    {
+        return {};
+    }
+    if (capacity_ == 0)
+    {
+        return toFileInfo(fileStat);
+    }
+    return insert(path, fileStat).info;
+}
+
+/**
+ * Returns a shared descriptor for a regular file, or nullptr if it cannot be opened. Concurrent responses may use the
+ * same descriptor since sendfile() is always given an explicit offset.
+ */
+std::shared_ptr<const FileDescriptor> OpenFileCache::open(const std::string &path, size_t &size)
+{
+    if (capacity_ == 0)
+    {
+        int fd = FileUtils::openFile(path, size);
+        return fd == -1 ? nullptr : std::make_shared<const FileDescriptor>(fd);
+    }
+
+    Entry *entry = find(path);
+    if (entry != nullptr && entry->fd != nullptr)
+    {
+        // Another thread or process may have rewritten the file without this cache seeing it
+        struct stat fileStat{};
+        if (::stat(path.c_str(), &fileStat) == 0 && isSameFile(*entry, fileStat))
+        {
+            size = entry->info.size;
+            return entry->fd;
+        }
+        Log::debug("Open file cache entry changed: " + path);
+        erase(path);
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd == -1 && (errno == EMFILE || errno == ENFILE) && evictAll())
+    {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    }
+    if (fd == -1)
+    {
+        Log::error("Failed to open file: " + path);
+        return nullptr;
+    }
+    auto descriptor = std::make_shared<const FileDescriptor>(fd);
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        Log::error("Failed to determine file size: " + path);
+        return nullptr;
+    }
+
+    // Describe what was actually opened, the path may have been replaced since it was last stat'ed
+    entry = &insert(path, fileStat);
+    entry->fd = descriptor;
+    size = entry->info.size;
+    return descriptor;
+}
+
+void OpenFileCache::invalidate(const std::string &path)
+{
+    erase(path);
+}
+
+/**
+ * Drops every entry, closing the descriptors no response is using, after the process ran out of them. Returns false
+ * when the cache was empty already, so there is nothing to retry for.
+ */
+bool OpenFileCache::evictAll()
+{
+    if (entries_.empty())
+    {
+        return false;
+    }
+    Log::warning("Out of file descriptors; dropping " + std::to_string(entries_.size()) + " open file cache entries");
+    entries_.clear();
+    lru_.clear();
+    return true;
+}
+
+bool OpenFileCache::isSameFile(const Entry &entry, const struct stat &fileStat) noexcept
+{
+    return fileStat.st_dev == entry.device && fileStat.st_ino == entry.inode && fileStat.st_mtime == entry.info.mtime
+           && fileStat.st_mtim.tv_nsec == entry.mtimeNsec && static_cast<size_t>(fileStat.st_size) == entry.info.size;
+}
+
+/**
+ * Returns the cached entry for path if it is still valid. Expired entries are revalidated with a single stat() and
+ * kept, descriptor included, when the file has not changed.
+ */
+OpenFileCache::Entry *OpenFileCache::find(const std::string &path)
+{
+    auto it = entries_.find(path);
+    if (it == entries_.end())
+    {
+        return nullptr;
+    }
+    Entry &entry = it->second;
+    auto now = std::chrono::steady_clock::now();
+    if (now >= entry.validUntil)
+    {
+        struct stat fileStat{};
+        if (::stat(path.c_str(), &fileStat) != 0 || !isSameFile(entry, fileStat))
+        {
+            Log::debug("Open file cache entry changed: " + path);
+            erase(path);
+            return nullptr;
+        }
+        entry.validUntil = now + validity_;
+    }
+    lru_.splice(lru_.begin(), lru_, entry.lruPosition);
+    return &entry;
+}
+
+OpenFileCache::Entry &OpenFileCache::insert(const std::string &path, const struct stat &fileStat)
+{
+    erase(path);
+    while (entries_.size() >= capacity_ && !lru_.empty())
+    {
+        std::string oldest = lru_.back();
+        erase(oldest);
+    }
+    lru_.push_front(path);
+    auto [it, inserted] = entries_.emplace(path, Entry{.info = toFileInfo(fileStat),
+                                                       .device = fileStat.st_dev,
+                                                       .inode = fileStat.st_ino,
+                                                       .mtimeNsec = fileStat.st_mtim.tv_nsec,
+                                                       .fd = nullptr,
+                                                       .validUntil = std::chrono::steady_clock::now() + validity_,
+                                                       .lruPosition = lru_.begin()});
+    return it->second;
+}
+
+void OpenFileCache::erase(const std::string &path)
+{
+    auto it = entries_.find(path);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    lru_.erase(it->second.lruPosition);
+    entries_.erase(it);
+}
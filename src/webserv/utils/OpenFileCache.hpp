@@ -0,0 +1,78 @@
+#pragma once
+
+#include <webserv/utils/FileDescriptor.hpp> // for FileDescriptor
+
+#include <chrono>        // for steady_clock, seconds
+#include <cstddef>       // for size_t
+#include <ctime>         // for time_t
+#include <list>          // for list
+#include <memory>        // for shared_ptr
+#include <string>        // for string
+#include <unordered_map> // for unordered_map
+
+#include <sys/types.h> // for dev_t, ino_t
+
+struct stat;
+
+/**
+ * Caches stat results and open descriptors of served files, in the spirit of nginx's open_file_cache.
+ *
+ * Each reactor thread (and each worker process) has its own instance, so lookups take no locks. Stat results are
+ * trusted for open_file_cache_valid seconds, after which one stat() decides whether they still hold. A cached
+ * descriptor is checked against a stat() of its path every time it is handed out, so a file replaced or rewritten by
+ * another thread or process is never served from the old descriptor. The number of entries is bounded by
+ * open_file_cache, and by a share of RLIMIT_NOFILE so the cached descriptors cannot crowd out client connections;
+ * entries are evicted least recently used first, or all at once when the process runs out of descriptors. Missing
+ * paths are never cached, so newly created files are visible immediately.
+ */
+class OpenFileCache
+{
+  public:
+    struct FileInfo
+    {
+        bool exists = false;
+        bool isFile = false;
+        bool isDirectory = false;
+        size_t size = 0;
+        time_t mtime = 0;
+    };
+
+    OpenFileCache(size_t capacity, std::chrono::seconds validity);
+
+    OpenFileCache(const OpenFileCache &other) = delete;
+    OpenFileCache &operator=(const OpenFileCache &other) = delete;
+    OpenFileCache(OpenFileCache &&other) noexcept = delete;
+    OpenFileCache &operator=(OpenFileCache &&other) noexcept = delete;
+
+    ~OpenFileCache() = default;
+
+    static OpenFileCache &get();
+
+    [[nodiscard]] FileInfo stat(const std::string &path);
+    [[nodiscard]] std::shared_ptr<const FileDescriptor> open(const std::string &path, size_t &size);
+    void invalidate(const std::string &path);
+    [[nodiscard]] bool evictAll();
+
+  private:
+    struct Entry
+    {
+        FileInfo info;
+        dev_t device;
+        ino_t inode;
+        long mtimeNsec;
+        std::shared_ptr<const FileDescriptor> fd;
+        std::chrono::steady_clock::time_point validUntil;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    size_t capacity_;
+    std::chrono::seconds validity_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_; // most recently used first
+
+    [[nodiscard]] static bool isSameFile(const Entry &entry, const struct stat &fileStat) noexcept;
+
+    Entry *find(const std::string &path);
+    Entry &insert(const std::string &path, const struct stat &fileStat);
+    void erase(const std::string &path);
+};
@@ -0,0 +1,246 @@
+#include <webserv/utils/Scan.hpp>
+
+#include <array>   // for array
+#include <cstdint> // for uint32_t, uint64_t
+#include <cstring> // for memcmp
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // for __m128i, __m256i, _mm_cmpeq_epi8, _mm256_cmpeq_epi8, _mm_movemask_epi8, ...
+#define WEBSERV_SCAN_X86 1
+#endif
+
+static size_t findScalar(const char *data, size_t size, const char *needle, size_t needleSize) noexcept
+{
+    return std::string_view(data, size).find(std::string_view(needle, needleSize));
+}
+
+static size_t findAnyScalar(const char *data, size_t size, char first, char second) noexcept
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (data[i] == first || data[i] == second) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+#ifdef WEBSERV_SCAN_X86
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+
+/*
+ * Both find kernels test a whole block of start positions at once: a position is a candidate when it holds the first
+ * byte of the needle and the position needleSize - 1 further holds the last one. Only candidates are compared in
+ * full, which for CRLFs and multipart boundaries is rarely a false one. The tail shorter than a block goes scalar.
+ */
+
+static __attribute__((target("sse2"))) size_t findSse2(const char *data, size_t size, const char *needle,
+                                                        size_t needleSize) noexcept
+{
+    constexpr size_t BLOCK = 16;
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleSize - 1]);
+    size_t i = 0;
+    for (; i + needleSize - 1 + BLOCK <= size; i += BLOCK)
+    {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + needleSize - 1));
+        auto mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+        while (mask != 0)
+        {
+            size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (std::memcmp(data + pos + 1, needle + 1, needleSize - 2) == 0)
+            {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    size_t rest = findScalar(data + i, size - i, needle, needleSize);
+    return rest == std::string_view::npos ? rest : i + rest;
+}
+
+static __attribute__((target("sse2"))) size_t findAnySse2(const char *data, size_t size, char first,
+                                                           char second) noexcept
+{
+    constexpr size_t BLOCK = 16;
+    const __m128i a = _mm_set1_epi8(first);
+    const __m128i b = _mm_set1_epi8(second);
+    size_t i = 0;
+    for (; i + BLOCK <= size; i += BLOCK)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        auto mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(a, block), _mm_cmpeq_epi8(b, block))));
+        if (mask != 0)
+        {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    size_t rest = findAnyScalar(data + i, size - i, first, second);
+    return rest == std::string_view::npos ? rest : i + rest;
+}
+
+static __attribute__((target("avx2"))) size_t findAvx2(const char *data, size_t size, const char *needle,
+                                                        size_t needleSize) noexcept
+{
+    constexpr size_t BLOCK = 32;
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needleSize - 1]);
+    size_t i = 0;
+    // Two blocks per step, looking at the last byte only where the first one matched: in binary upload bodies the
+    // first byte of a boundary is rare, and this step is then as cheap as memchr's
+    for (; i + needleSize - 1 + 2 * BLOCK <= size; i += 2 * BLOCK)
+    {
+        const __m256i first0
+            = _mm256_cmpeq_epi8(first, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+        const __m256i first1
+            = _mm256_cmpeq_epi8(first, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + BLOCK)));
+        const __m256i any = _mm256_or_si256(first0, first1);
+        if (_mm256_testz_si256(any, any) != 0)
+        {
+            continue;
+        }
+        const char *lastBytes = data + i + needleSize - 1;
+        const __m256i last0 = _mm256_cmpeq_epi8(last, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lastBytes)));
+        const __m256i last1
+            = _mm256_cmpeq_epi8(last, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lastBytes + BLOCK)));
+        auto mask0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(first0, last0)));
+        auto mask1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(first1, last1)));
+        uint64_t mask = mask0 | (static_cast<uint64_t>(mask1) << BLOCK);
+        while (mask != 0)
+        {
+            size_t pos = i + static_cast<size_t>(__builtin_ctzll(mask));
+            if (std::memcmp(data + pos + 1, needle + 1, needleSize - 2) == 0)
+            {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; i + needleSize - 1 + BLOCK <= size; i += BLOCK)
+    {
+        const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + needleSize - 1));
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+        while (mask != 0)
+        {
+            size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (std::memcmp(data + pos + 1, needle + 1, needleSize - 2) == 0)
+            {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    size_t rest = findSse2(data + i, size - i, needle, needleSize);
+    return rest == std::string_view::npos ? rest : i + rest;
+}
+
+static __attribute__((target("avx2"))) size_t findAnyAvx2(const char *data, size_t size, char first,
+                                                           char second) noexcept
+{
+    constexpr size_t BLOCK = 32;
+    const __m256i a = _mm256_set1_epi8(first);
+    const __m256i b = _mm256_set1_epi8(second);
+    size_t i = 0;
+    for (; i + BLOCK <= size; i += BLOCK)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        auto mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(a, block), _mm256_cmpeq_epi8(b, block))));
+        if (mask != 0)
+        {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    size_t rest = findAnySse2(data + i, size - i, first, second);
+    return rest == std::string_view::npos ? rest : i + rest;
+}
+
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+#endif
+
+struct KernelList
+{
+    std::array<scan::Kernel, 3> kernels;
+    size_t count = 0;
+};
+
+/**
+ * Every kernel this CPU can run, widest first; the scalar one is always last.
+ */
+static KernelList detectKernels() noexcept
+{
+    KernelList list{};
+#ifdef WEBSERV_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        list.kernels.at(list.count++) = {findAvx2, findAnyAvx2, "AVX2"};
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        list.kernels.at(list.count++) = {findSse2, findAnySse2, "SSE2"};
+    }
+#endif
+    list.kernels.at(list.count++) = {findScalar, findAnyScalar, "scalar"};
+    return list;
+}
+
+static const KernelList &kernels() noexcept
+{
+    static const KernelList list = detectKernels();
+    return list;
+}
+
+static const scan::Kernel &kernel() noexcept
+{
+    return kernels().kernels.front();
+}
+
+namespace scan
+{
+size_t find(std::string_view haystack, std::string_view needle, size_t from) noexcept
+{
+    if (from > haystack.size())
+    {
+        return std::string_view::npos;
+    }
+    if (needle.size() < 2)
+    {
+        return haystack.find(needle, from);
+    }
+    size_t pos = kernel().find(haystack.data() + from, haystack.size() - from, needle.data(), needle.size());
+    return pos == std::string_view::npos ? pos : from + pos;
+}
+
+/**
+ * Position of the first byte at or after from that is first or second.
+ */
+size_t findAny(std::string_view haystack, char first, char second, size_t from) noexcept
+{
+    if (from >= haystack.size())
+    {
+        return std::string_view::npos;
+    }
+    size_t pos = kernel().findAny(haystack.data() + from, haystack.size() - from, first, second);
+    return pos == std::string_view::npos ? pos : from + pos;
+}
+
+std::string_view getKernelName() noexcept
+{
+    return kernel().name;
+}
+
+/**
+ * The kernels this CPU supports, the one in use first, so tests and benchmarks can run them side by side.
+ */
+std::span<const Kernel> getKernels() noexcept
+{
+    return {kernels().kernels.data(), kernels().count};
+}
+} // namespace scan
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>     // for size_t
+#include <span>        // for span
+#include <string_view> // for string_view
+
+/**
+ * Delimiter searches for the parsers: CRLFs in request heads, chunk framing, CGI output and multipart boundaries.
+ *
+ * On x86 the kernels compare 32 (AVX2) or 16 (SSE2) positions per step; the widest one the CPU supports is picked on
+ * first use. Other targets use std::string_view::find. Positions and npos mean the same as in std::string_view.
+ */
+namespace scan
+{
+/**
+ * One implementation of both searches over a raw buffer, returning offsets into it. find() needs a needle of at least
+ * two bytes.
+ */
+struct Kernel
+{
+    size_t (*find)(const char *data, size_t size, const char *needle, size_t needleSize) noexcept;
+    size_t (*findAny)(const char *data, size_t size, char first, char second) noexcept;
+    std::string_view name;
+};
+
+[[nodiscard]] size_t find(std::string_view haystack, std::string_view needle, size_t from = 0) noexcept;
+[[nodiscard]] size_t findAny(std::string_view haystack, char first, char second, size_t from = 0) noexcept;
+[[nodiscard]] std::string_view getKernelName() noexcept;
+[[nodiscard]] std::span<const Kernel> getKernels() noexcept;
+} // namespace scan
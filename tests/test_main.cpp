@@ -1,3 +1,19 @@
+#include <webserv/handler/FastCgiRecord.hpp> // for FastCgiRecord
+#include <webserv/http/ChunkedDecoder.hpp>   // for ChunkedDecoder
+#include <webserv/http/HttpHeaders.hpp>      // for HttpHeaders
+#include <webserv/http/HttpConstants.hpp>    // for MAX_HEADER_SIZE
+#include <webserv/utils/Scan.hpp>            // for Kernel, find, findAny, getKernels
+
+#include <algorithm>   // for min
+#include <cctype>      // for tolower, toupper
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint8_t
+#include <random>      // for mt19937, uniform_int_distribution
+#include <string>      // for string
+#include <utility>     // for pair
+#include <string_view> // for string_view
+#include <vector>      // for vector
+
 #include <gtest/gtest.h>
 
 // Basic test to verify Google Test is working
@@ -7,6 +23,496 @@ TEST(BasicTest, TruthTest) {
     EXPECT_EQ(1 + 1, 2);
 }
 
+/*
+ * Scan kernels: every kernel the CPU supports must agree with std::string_view on every input. Lengths run past two
+ * AVX2 blocks so that matches land in the vector loop, on block boundaries and in the scalar tail.
+ */
+
+static constexpr size_t SCAN_MAX_LENGTH = 80;
+
+static size_t kernelFind(const scan::Kernel &kernel, std::string_view haystack, std::string_view needle)
+{
+    return kernel.find(haystack.data(), haystack.size(), needle.data(), needle.size());
+}
+
+TEST(ScanTest, KernelsAreAvailable)
+{
+    ASSERT_FALSE(scan::getKernels().empty());
+    EXPECT_EQ(scan::getKernels().front().name, scan::getKernelName());
+    EXPECT_EQ(scan::getKernels().back().name, "scalar");
+}
+
+TEST(ScanTest, FindMatchesAtEveryPosition)
+{
+    const std::vector<std::string> needles = {"\r\n", "\r\n\r\n", "\r\n--boundary"};
+    for (const scan::Kernel &kernel : scan::getKernels())
+    {
+        for (const std::string &needle : needles)
+        {
+            for (size_t length = 0; length <= SCAN_MAX_LENGTH; ++length)
+            {
+                std::string haystack(length, 'a');
+                EXPECT_EQ(kernelFind(kernel, haystack, needle), std::string_view::npos)
+                    << kernel.name << " length " << length;
+                for (size_t pos = 0; pos + needle.size() <= length; ++pos)
+                {
+                    std::string text = haystack;
+                    text.replace(pos, needle.size(), needle);
+                    EXPECT_EQ(kernelFind(kernel, text, needle), pos) << kernel.name << " length " << length;
+                }
+            }
+        }
+    }
+}
+
+TEST(ScanTest, FindIgnoresNeedleCutOffAtTheEnd)
+{
+    const std::string needle = "\r\n--boundary";
+    for (const scan::Kernel &kernel : scan::getKernels())
+    {
+        for (size_t length = 1; length <= SCAN_MAX_LENGTH; ++length)
+        {
+            for (size_t kept = 1; kept < needle.size() && kept <= length; ++kept)
+            {
+                std::string text(length - kept, 'a');
+                text += needle.substr(0, kept);
+                EXPECT_EQ(kernelFind(kernel, text, needle), std::string_view::npos)
+                    << kernel.name << " length " << length;
+            }
+        }
+    }
+}
+
+TEST(ScanTest, FindNeedsFirstAndLastByteAndMiddle)
+{
+    // Candidates with the right first and last byte but a different middle must be rejected
+    const std::string needle = "\r\nXY\r\n";
+    for (const scan::Kernel &kernel : scan::getKernels())
+    {
+        std::string text;
+        for (size_t i = 0; i < 20; ++i)
+        {
+            text += "\r\nXZ\r\n";
+        }
+        EXPECT_EQ(kernelFind(kernel, text, needle), std::string_view::npos) << kernel.name;
+        text += needle;
+        EXPECT_EQ(kernelFind(kernel, text, needle), text.size() - needle.size()) << kernel.name;
+    }
+}
+
+TEST(ScanTest, FindAnyMatchesAtEveryPosition)
+{
+    for (const scan::Kernel &kernel : scan::getKernels())
+    {
+        for (size_t length = 0; length <= SCAN_MAX_LENGTH; ++length)
+        {
+            std::string haystack(length, 'a');
+            EXPECT_EQ(kernel.findAny(haystack.data(), haystack.size(), '\r', '\n'), std::string_view::npos)
+                << kernel.name << " length " << length;
+            for (size_t pos = 0; pos < length; ++pos)
+            {
+                for (char c : {'\r', '\n'})
+                {
+                    std::string text = haystack;
+                    text[pos] = c;
+                    EXPECT_EQ(kernel.findAny(text.data(), text.size(), '\r', '\n'), pos)
+                        << kernel.name << " length " << length;
+                }
+            }
+        }
+    }
+}
+
+TEST(ScanTest, KernelsAgreeOnRandomInput)
+{
+    // Mostly delimiter bytes, so near misses and overlapping candidates are common
+    const std::string alphabet = "\r\n-ab";
+    const std::vector<std::string> needles = {"\r\n", "\r\n\r\n", "\r\n--ab", "--a"};
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> lengths(0, 300);
+    std::uniform_int_distribution<size_t> letters(0, alphabet.size() - 1);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        std::string text(lengths(random), 'a');
+        for (char &c : text)
+        {
+            c = alphabet[letters(random)];
+        }
+        for (const std::string &needle : needles)
+        {
+            size_t expected = std::string_view(text).find(needle);
+            for (const scan::Kernel &kernel : scan::getKernels())
+            {
+                EXPECT_EQ(kernelFind(kernel, text, needle), expected) << kernel.name << " round " << round;
+            }
+        }
+        size_t expectedAny = std::string_view(text).find_first_of("\r\n");
+        for (const scan::Kernel &kernel : scan::getKernels())
+        {
+            EXPECT_EQ(kernel.findAny(text.data(), text.size(), '\r', '\n'), expectedAny)
+                << kernel.name << " round " << round;
+        }
+    }
+}
+
+TEST(ScanTest, FindHonorsFrom)
+{
+    const std::string text = "GET / HTTP/1.1\r\nHost: a\r\n\r\nbody\r\n";
+    for (size_t from = 0; from <= text.size() + 1; ++from)
+    {
+        EXPECT_EQ(scan::find(text, "\r\n", from), std::string_view(text).find("\r\n", from)) << "from " << from;
+        EXPECT_EQ(scan::findAny(text, '\r', '\n', from), std::string_view(text).find_first_of("\r\n", from))
+            << "from " << from;
+    }
+    EXPECT_EQ(scan::find(text, "", 3), 3U);
+    EXPECT_EQ(scan::find(text, "\n", 0), text.find('\n'));
+}
+
+/*
+ * Chunked transfer coding: the decoder is fed the unconsumed input the way HttpRequest feeds it, a piece at a time.
+ */
+
+struct ChunkedOutcome
+{
+    std::string body;
+    ChunkedDecoder::Result result = ChunkedDecoder::Result::NeedMore;
+    // Input left over after the body
+    size_t unconsumed = 0;
+};
+
+// Feeds input in pieces of at most step bytes, or cut once at split when step is 0
+static ChunkedOutcome decodeChunked(std::string_view input, size_t split, size_t step = 0)
+{
+    ChunkedDecoder decoder;
+    ChunkedOutcome outcome;
+    std::string pending;
+    size_t fed = 0;
+    while (true)
+    {
+        size_t next = step == 0 ? (fed < split ? split : input.size()) : std::min(input.size(), fed + step);
+        pending.append(input.substr(fed, next - fed));
+        fed = next;
+        while (true)
+        {
+            size_t consumed = 0;
+            std::string_view data;
+            outcome.result = decoder.decode(pending, consumed, data);
+            if (outcome.result == ChunkedDecoder::Result::Data)
+            {
+                outcome.body.append(data);
+            }
+            pending.erase(0, consumed);
+            if (outcome.result != ChunkedDecoder::Result::Data)
+            {
+                break;
+            }
+        }
+        if (outcome.result != ChunkedDecoder::Result::NeedMore || fed == input.size())
+        {
+            outcome.unconsumed = pending.size() + input.size() - fed;
+            return outcome;
+        }
+    }
+}
+
+TEST(ChunkedDecoderTest, DecodesAtEverySplitPosition)
+{
+    const std::string input = "4\r\nWiki\r\n5;name=value\r\npedia\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\nExpires: never\r\n\r\n"
+                              "GET /next";
+    for (size_t split = 0; split <= input.size(); ++split)
+    {
+        ChunkedOutcome outcome = decodeChunked(input, split);
+        EXPECT_EQ(outcome.result, ChunkedDecoder::Result::Done) << "split " << split;
+        EXPECT_EQ(outcome.body, "Wikipedia in\r\n\r\nchunks.") << "split " << split;
+        EXPECT_EQ(outcome.unconsumed, std::string_view("GET /next").size()) << "split " << split;
+    }
+    ChunkedOutcome outcome = decodeChunked(input, 0, 1);
+    EXPECT_EQ(outcome.result, ChunkedDecoder::Result::Done);
+    EXPECT_EQ(outcome.body, "Wikipedia in\r\n\r\nchunks.");
+}
+
+TEST(ChunkedDecoderTest, IgnoresExtensionsAndWhitespaceAfterSize)
+{
+    ChunkedOutcome outcome = decodeChunked("3 ;a=1;b=\"x;y\"\r\nabc\r\nA\t\r\n0123456789\r\n0;last\r\n\r\n", 0);
+    EXPECT_EQ(outcome.result, ChunkedDecoder::Result::Done);
+    EXPECT_EQ(outcome.body, "abc0123456789");
+}
+
+TEST(ChunkedDecoderTest, RejectsInvalidSizes)
+{
+    for (const char *input : {"\r\n", ";ext\r\n", "x\r\n", "-1\r\n", "0x10\r\n", "1 2\r\n"})
+    {
+        EXPECT_EQ(decodeChunked(input, 0).result, ChunkedDecoder::Result::Error) << input;
+    }
+}
+
+TEST(ChunkedDecoderTest, RejectsSizeOverflow)
+{
+    std::string largest(sizeof(size_t) * 2, 'f');
+    ChunkedDecoder decoder;
+    size_t consumed = 0;
+    std::string_view data;
+    std::string input = largest + "\r\nab";
+    EXPECT_EQ(decoder.decode(input, consumed, data), ChunkedDecoder::Result::Data);
+    EXPECT_EQ(data, "ab");
+    EXPECT_EQ(decodeChunked("1" + largest + "\r\n", 0).result, ChunkedDecoder::Result::Error);
+    EXPECT_EQ(decodeChunked("0" + largest + "\r\n", 0).result, ChunkedDecoder::Result::NeedMore);
+}
+
+TEST(ChunkedDecoderTest, RejectsMissingCrlfAfterData)
+{
+    EXPECT_EQ(decodeChunked("3\r\nabcd\r\n0\r\n\r\n", 0).result, ChunkedDecoder::Result::Error);
+    EXPECT_EQ(decodeChunked("3\r\nabc\n0\r\n\r\n", 0).result, ChunkedDecoder::Result::Error);
+    EXPECT_EQ(decodeChunked("3\r\nabc\r", 0).result, ChunkedDecoder::Result::NeedMore);
+}
+
+TEST(ChunkedDecoderTest, LimitsSizeLine)
+{
+    std::string line = "1;" + std::string(Http::Protocol::MAX_HEADER_SIZE, 'x');
+    EXPECT_EQ(decodeChunked(line, 0).result, ChunkedDecoder::Result::Error);
+    EXPECT_EQ(decodeChunked(line, 0, 100).result, ChunkedDecoder::Result::Error);
+}
+
+TEST(ChunkedDecoderTest, LimitsTrailerSection)
+{
+    std::string field = "X-Trailer: " + std::string(100, 'v') + "\r\n";
+    std::string fits;
+    while (fits.size() + field.size() + 2 <= Http::Protocol::MAX_HEADER_SIZE)
+    {
+        fits += field;
+    }
+    EXPECT_EQ(decodeChunked("0\r\n" + fits + "\r\n", 0).result, ChunkedDecoder::Result::Done);
+    // No single line is long, but together they are over the limit
+    EXPECT_EQ(decodeChunked("0\r\n" + fits + field + "\r\n", 0, 64).result, ChunkedDecoder::Result::Error);
+    std::string longLine = "X-Trailer: " + std::string(Http::Protocol::MAX_HEADER_SIZE, 'v');
+    EXPECT_EQ(decodeChunked("0\r\n" + longLine, 0).result, ChunkedDecoder::Result::Error);
+}
+
+TEST(ChunkedDecoderTest, ResetStartsOver)
+{
+    ChunkedDecoder decoder;
+    size_t consumed = 0;
+    std::string_view data;
+    EXPECT_EQ(decoder.decode("zz\r\n", consumed, data), ChunkedDecoder::Result::Error);
+    EXPECT_FALSE(decoder.getError().empty());
+    decoder.reset();
+    EXPECT_EQ(decoder.decode("0\r\n\r\n", consumed, data), ChunkedDecoder::Result::Done);
+    EXPECT_EQ(consumed, 5U);
+    EXPECT_TRUE(decoder.getError().empty());
+}
+
+/*
+ * FastCGI records: what the handler sends is encoded with append(), and what a backend sends back may be cut anywhere.
+ */
+
+using FastCgiPiece = std::pair<FastCgiRecord::Type, std::string>;
+
+// Decodes input fed in pieces of step bytes into the records it holds, with the content of each joined up
+static std::vector<FastCgiPiece> decodeRecords(std::string_view input, size_t step)
+{
+    FastCgiRecord record;
+    std::vector<FastCgiPiece> records;
+    std::string content;
+    for (size_t fed = 0; fed < input.size(); fed += step)
+    {
+        std::string_view piece = input.substr(fed, step);
+        while (true)
+        {
+            size_t consumed = 0;
+            std::string_view data;
+            FastCgiRecord::Result result = record.decode(piece, consumed, data);
+            piece.remove_prefix(consumed);
+            if (result == FastCgiRecord::Result::Content)
+            {
+                EXPECT_FALSE(data.empty());
+                content.append(data);
+            }
+            else if (result == FastCgiRecord::Result::End)
+            {
+                records.emplace_back(record.getType(), content);
+                content.clear();
+            }
+            else
+            {
+                EXPECT_EQ(result, FastCgiRecord::Result::NeedMore);
+                EXPECT_TRUE(piece.empty());
+                break;
+            }
+        }
+    }
+    return records;
+}
+
+static std::string encodeRecords(const std::vector<FastCgiPiece> &records)
+{
+    std::vector<uint8_t> out;
+    for (const auto &[type, content] : records)
+    {
+        FastCgiRecord::append(out, type, content);
+    }
+    return {out.begin(), out.end()};
+}
+
+TEST(FastCgiRecordTest, PadsToMultipleOfEight)
+{
+    for (size_t length = 0; length <= 17; ++length)
+    {
+        std::string encoded = encodeRecords({{FastCgiRecord::Type::Stdin, std::string(length, 'x')}});
+        size_t padding = (8 - (length % 8)) % 8;
+        ASSERT_EQ(encoded.size(), FastCgiRecord::HEADER_SIZE + length + padding) << "length " << length;
+        EXPECT_EQ(encoded[0], 1);
+        EXPECT_EQ(encoded[1], static_cast<char>(FastCgiRecord::Type::Stdin));
+        EXPECT_EQ(encoded[2], 0);
+        EXPECT_EQ(encoded[3], 1);
+        EXPECT_EQ(static_cast<size_t>(static_cast<uint8_t>(encoded[4]) << 8U | static_cast<uint8_t>(encoded[5])),
+                  length);
+        EXPECT_EQ(static_cast<size_t>(encoded[6]), padding);
+        EXPECT_EQ(encoded.substr(FastCgiRecord::HEADER_SIZE + length), std::string(padding, '\0'));
+    }
+}
+
+TEST(FastCgiRecordTest, EncodesLongestContent)
+{
+    std::string encoded = encodeRecords({{FastCgiRecord::Type::Params, std::string(FastCgiRecord::MAX_CONTENT, 'p')}});
+    EXPECT_EQ(static_cast<uint8_t>(encoded[4]), 0xFF);
+    EXPECT_EQ(static_cast<uint8_t>(encoded[5]), 0xFF);
+    EXPECT_EQ(encoded[6], 1);
+    EXPECT_EQ(decodeRecords(encoded, encoded.size()).front().second.size(), FastCgiRecord::MAX_CONTENT);
+}
+
+TEST(FastCgiRecordTest, EncodesParamLengths)
+{
+    std::string params;
+    FastCgiRecord::appendParam(params, "A", std::string(127, 'v'));
+    EXPECT_EQ(params.substr(0, 3), std::string("\x01\x7f" "A"));
+    params.clear();
+    FastCgiRecord::appendParam(params, std::string(128, 'n'), "");
+    EXPECT_EQ(params.substr(0, 5), std::string("\x80\x00\x00\x80\x00", 5));
+    params.clear();
+    FastCgiRecord::appendParam(params, "N", std::string(70000, 'v'));
+    EXPECT_EQ(params.substr(0, 6), std::string("\x01\x80\x01\x11\x70N", 6));
+    EXPECT_EQ(params.size(), 6 + 70000U);
+}
+
+TEST(FastCgiRecordTest, DecodesAtEverySplitPosition)
+{
+    // Several STDOUT records make up one response, with a STDERR record and an empty STDOUT one in between
+    const std::vector<FastCgiPiece> records = {
+        {FastCgiRecord::Type::Stdout, "Content-Type: text/plain\r\n\r\n"},
+        {FastCgiRecord::Type::Stderr, "PHP Notice: something"},
+        {FastCgiRecord::Type::Stdout, "hello "},
+        {FastCgiRecord::Type::Stdout, "world"},
+        {FastCgiRecord::Type::Stdout, ""},
+        {FastCgiRecord::Type::EndRequest, std::string(8, '\0')}};
+    std::string encoded = encodeRecords(records);
+    for (size_t step = 1; step <= encoded.size(); ++step)
+    {
+        EXPECT_EQ(decodeRecords(encoded, step), records) << "step " << step;
+    }
+}
+
+TEST(FastCgiRecordTest, SkipsPaddingTheBackendChose)
+{
+    // Padding other than to a multiple of eight is valid and must not be taken for the next header
+    std::string encoded("\x01\x06\x00\x01\x00\x03\x05\x00" "abc" "\x00\x00\x00\x00\x00"
+                        "\x01\x03\x00\x01\x00\x08\x00\x00" "\x00\x00\x00\x00\x00\x00\x00\x00",
+                        32);
+    const std::vector<FastCgiPiece> expected = {{FastCgiRecord::Type::Stdout, "abc"},
+                                                {FastCgiRecord::Type::EndRequest, std::string(8, '\0')}};
+    for (size_t step = 1; step <= encoded.size(); ++step)
+    {
+        EXPECT_EQ(decodeRecords(encoded, step), expected) << "step " << step;
+    }
+}
+
+TEST(FastCgiRecordTest, RejectsUnknownVersion)
+{
+    FastCgiRecord record;
+    size_t consumed = 0;
+    std::string_view content;
+    EXPECT_EQ(record.decode(std::string_view("\x02\x06\x00\x01\x00\x01\x00", 7), consumed, content),
+              FastCgiRecord::Result::NeedMore);
+    EXPECT_EQ(record.decode(std::string_view("\x00x", 2), consumed, content), FastCgiRecord::Result::Error);
+    record.reset();
+    EXPECT_EQ(record.decode(std::string_view("\x01\x06\x00\x01\x00\x01\x00\x00x", 9), consumed, content),
+              FastCgiRecord::Result::Content);
+    EXPECT_EQ(content, "x");
+}
+
+/*
+ * Header fields: every Field must be found through the perfect hash by its name in any case, and nothing else may be.
+ */
+
+static std::string changeCase(std::string_view name, bool upper)
+{
+    std::string result(name);
+    for (char &c : result)
+    {
+        auto byte = static_cast<unsigned char>(c);
+        c = static_cast<char>(upper ? std::toupper(byte) : std::tolower(byte));
+    }
+    return result;
+}
+
+TEST(HttpHeadersTest, FindsEveryKnownField)
+{
+    ASSERT_EQ(static_cast<size_t>(HttpHeaders::Field::Count), 26U);
+    for (size_t i = 0; i < static_cast<size_t>(HttpHeaders::Field::Count); ++i)
+    {
+        auto field = static_cast<HttpHeaders::Field>(i);
+        std::string_view name = HttpHeaders::getName(field);
+        ASSERT_FALSE(name.empty()) << i;
+        EXPECT_EQ(HttpHeaders::toField(name), field) << name;
+        EXPECT_EQ(HttpHeaders::toField(changeCase(name, false)), field) << name;
+        EXPECT_EQ(HttpHeaders::toField(changeCase(name, true)), field) << name;
+    }
+}
+
+TEST(HttpHeadersTest, KnowsTheNamesOfTheFields)
+{
+    EXPECT_EQ(HttpHeaders::getName(HttpHeaders::Field::ContentLength), "Content-Length");
+    EXPECT_EQ(HttpHeaders::getName(HttpHeaders::Field::ETag), "ETag");
+    EXPECT_EQ(HttpHeaders::getName(HttpHeaders::Field::UserAgent), "User-Agent");
+    EXPECT_TRUE(HttpHeaders::getName(HttpHeaders::Field::Unknown).empty());
+}
+
+TEST(HttpHeadersTest, RejectsUnknownNames)
+{
+    for (size_t i = 0; i < static_cast<size_t>(HttpHeaders::Field::Count); ++i)
+    {
+        std::string name(HttpHeaders::getName(static_cast<HttpHeaders::Field>(i)));
+        // Same length, first and last letter, so the same hash slot as the field
+        std::string sameSlot = name;
+        sameSlot[1] = sameSlot[1] == 'x' ? 'y' : 'x';
+        EXPECT_EQ(HttpHeaders::toField(sameSlot), HttpHeaders::Field::Unknown) << sameSlot;
+        EXPECT_EQ(HttpHeaders::toField(name + "s"), HttpHeaders::Field::Unknown) << name;
+        EXPECT_EQ(HttpHeaders::toField(name.substr(0, name.size() - 1)), HttpHeaders::Field::Unknown) << name;
+    }
+    for (std::string_view name : {"", "X", "X-Forwarded-For", "Origin", "Content Length", "Host:"})
+    {
+        EXPECT_EQ(HttpHeaders::toField(name), HttpHeaders::Field::Unknown) << name;
+    }
+}
+
+TEST(HttpHeadersTest, LooksUpKnownAndUnknownNamesAlike)
+{
+    HttpHeaders headers;
+    ASSERT_TRUE(headers.parse("content-LENGTH: 42\r\nX-Custom: one\r\nx-custom: two\r\nHOST: example.com\r\n"));
+    EXPECT_EQ(headers.get(HttpHeaders::Field::ContentLength), "42");
+    EXPECT_EQ(headers.get("Content-Length"), "42");
+    EXPECT_EQ(headers.getContentLength(), 42U);
+    EXPECT_EQ(headers.get("host"), "example.com");
+    ASSERT_NE(headers.getValues("X-CUSTOM"), nullptr);
+    EXPECT_EQ(headers.getValues("X-CUSTOM")->size(), 2U);
+    EXPECT_FALSE(headers.has("X-Other"));
+    EXPECT_FALSE(headers.has(HttpHeaders::Field::Cookie));
+    headers.remove("CONTENT-length");
+    EXPECT_FALSE(headers.has(HttpHeaders::Field::ContentLength));
+    headers.remove("x-custom");
+    EXPECT_FALSE(headers.has("X-Custom"));
+    EXPECT_EQ(headers.get(HttpHeaders::Field::Host), "example.com");
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();